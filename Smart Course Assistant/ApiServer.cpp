@@ -0,0 +1,349 @@
+#include "ApiServer.h"
+#include <QCache>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <QUrl>
+
+namespace {
+
+const int MAX_HEADER_BYTES = 8 * 1024;
+const int MAX_CONNECTIONS = 256;
+const int IDLE_TIMEOUT_MS = 30 * 1000;
+const int BODY_CACHE_ENTRIES = 256;
+const char API_PREFIX[] = "/api";
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 431: return "Request Header Fields Too Large";
+    case 503: return "Service Unavailable";
+    default:  return "Error";
+    }
+}
+
+// If-None-Match 可以列出多个 ETag，也可以是 *
+bool etagMatches(const QByteArray &header, const QByteArray &etag)
+{
+    for (QByteArray candidate : header.split(',')) {
+        candidate = candidate.trimmed();
+        if (candidate.startsWith("W/")) {
+            candidate = candidate.mid(2);
+        }
+        if (candidate == "*" || candidate == etag) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 只接受以回环地址访问的请求，防止网页通过 DNS 重绑定读取数据
+bool isLoopbackHost(QByteArray host)
+{
+    if (host.startsWith('[')) {
+        int end = host.indexOf(']');
+        host = end > 0 ? host.mid(1, end - 1) : QByteArray();
+    } else {
+        int colon = host.indexOf(':');
+        if (colon >= 0) {
+            host.truncate(colon);
+        }
+    }
+    host = host.toLower();
+    return host == "localhost" || host == "127.0.0.1" || host == "::1";
+}
+
+} // namespace
+
+ApiResource ApiHandler::error(int status, const QString &message)
+{
+    ApiResource resource;
+    resource.status = status;
+    resource.render = [message]() {
+        return QJsonDocument(QJsonObject{{"error", message}});
+    };
+    return resource;
+}
+
+// 服务线程中的监听与连接处理，只通过 lambda 连接信号，不需要 moc
+class ApiWorker : public QObject
+{
+public:
+    explicit ApiWorker(ApiServer *owner)
+        : m_owner(owner),
+        m_server(nullptr),
+        m_idleTimer(nullptr),
+        m_epoch(QByteArray::number(QRandomGenerator::global()->generate(), 36)),
+        m_bodies(BODY_CACHE_ENTRIES)
+    {
+    }
+
+    bool listen(quint16 port, QString *error);
+    quint16 port() const { return m_server ? m_server->serverPort() : 0; }
+
+private:
+    struct Connection {
+        QByteArray buffer;
+        QElapsedTimer idle;
+    };
+
+    void onNewConnection();
+    void onReadyRead(QTcpSocket *socket);
+    bool handleRequest(QTcpSocket *socket, const QByteArray &head);
+    void respond(QTcpSocket *socket, int status, const QByteArray &etag, const QByteArray &body,
+                 bool headOnly, bool keepAlive, int retryAfter = 0);
+    void closeIdle();
+
+    ApiServer *m_owner;
+    QTcpServer *m_server;
+    QTimer *m_idleTimer;
+    QByteArray m_epoch;     // 每次启动不同，重启后旧的 ETag 一律失效
+    QHash<QTcpSocket*, Connection> m_connections;
+    QCache<QByteArray, QByteArray> m_bodies;
+};
+
+bool ApiWorker::listen(quint16 port, QString *error)
+{
+    m_server = new QTcpServer(this);
+    m_server->setMaxPendingConnections(64);
+    if (!m_server->listen(QHostAddress::LocalHost, port)) {
+        *error = m_server->errorString();
+        return false;
+    }
+    connect(m_server, &QTcpServer::newConnection, this, [this]() { onNewConnection(); });
+
+    m_idleTimer = new QTimer(this);
+    connect(m_idleTimer, &QTimer::timeout, this, [this]() { closeIdle(); });
+    m_idleTimer->start(IDLE_TIMEOUT_MS / 2);
+    return true;
+}
+
+void ApiWorker::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        if (m_connections.size() >= MAX_CONNECTIONS) {
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+        Connection &connection = m_connections[socket];
+        connection.idle.start();
+        connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+        connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+            m_connections.remove(socket);
+            socket->deleteLater();
+        });
+    }
+}
+
+// 一次可能收到多个请求（管线化），也可能只收到半个请求头
+void ApiWorker::onReadyRead(QTcpSocket *socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) {
+        return;
+    }
+    it->buffer += socket->readAll();
+    it->idle.restart();
+
+    for (;;) {
+        QByteArray &buffer = m_connections[socket].buffer;
+        int end = buffer.indexOf("\r\n\r\n");
+        if (end < 0) {
+            if (buffer.size() > MAX_HEADER_BYTES) {
+                respond(socket, 431, QByteArray(), QByteArray(), false, false);
+            }
+            return;
+        }
+        QByteArray head = buffer.left(end);
+        buffer.remove(0, end + 4);
+        if (!handleRequest(socket, head)) {
+            return;
+        }
+    }
+}
+
+// 返回 false 表示连接已关闭
+bool ApiWorker::handleRequest(QTcpSocket *socket, const QByteArray &head)
+{
+    m_owner->m_requests.fetch_add(1, std::memory_order_relaxed);
+
+    QList<QByteArray> lines = head.split('\n');
+    QList<QByteArray> requestLine = lines.takeFirst().trimmed().split(' ');
+    if (requestLine.size() != 3 || !requestLine.at(2).startsWith("HTTP/1.")) {
+        respond(socket, 400, QByteArray(), QByteArray(), false, false);
+        return false;
+    }
+    const QByteArray method = requestLine.at(0);
+    const bool http10 = requestLine.at(2) == "HTTP/1.0";
+
+    QHash<QByteArray, QByteArray> headers;
+    for (const QByteArray &line : lines) {
+        int colon = line.indexOf(':');
+        if (colon > 0) {
+            headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+        }
+    }
+    const QByteArray connection = headers.value("connection").toLower();
+    const bool keepAlive = http10 ? connection == "keep-alive" : connection != "close";
+
+    // 只提供查询，不读取请求体
+    if (headers.value("content-length", "0") != "0" || headers.contains("transfer-encoding")) {
+        respond(socket, 400, QByteArray(), QByteArray(), false, false);
+        return false;
+    }
+    if (!isLoopbackHost(headers.value("host", "localhost"))) {
+        respond(socket, 403, QByteArray(), QByteArray(), false, false);
+        return false;
+    }
+    const bool headOnly = method == "HEAD";
+    if (method != "GET" && !headOnly) {
+        respond(socket, 405, QByteArray(), QByteArray(), false, keepAlive);
+        return keepAlive;
+    }
+
+    QUrl url = QUrl::fromEncoded(requestLine.at(1));
+    QString path = url.path();
+    ApiResource resource;
+    if (!url.isValid() || !(path == API_PREFIX || path.startsWith(QString(API_PREFIX) + '/'))) {
+        resource = ApiHandler::error(404, "未知的路径: " + path);
+    } else {
+        resource = m_owner->m_handler->resolve(path.mid(int(qstrlen(API_PREFIX))), QUrlQuery(url));
+    }
+
+    QByteArray etag;
+    if (resource.status == 200 && !resource.etag.isEmpty()) {
+        etag = '"' + m_epoch + '-' + resource.etag + '"';
+        if (etagMatches(headers.value("if-none-match"), etag)) {
+            m_owner->m_notModified.fetch_add(1, std::memory_order_relaxed);
+            respond(socket, 304, etag, QByteArray(), true, keepAlive);
+            return keepAlive;
+        }
+    }
+
+    // 不同客户端轮询同一资源时只序列化一次
+    QByteArray body;
+    if (QByteArray *cached = etag.isEmpty() ? nullptr : m_bodies.object(etag)) {
+        body = *cached;
+    } else {
+        body = resource.render().toJson(QJsonDocument::Compact);
+        if (!etag.isEmpty()) {
+            m_bodies.insert(etag, new QByteArray(body));
+        }
+    }
+    respond(socket, resource.status, etag, body, headOnly, keepAlive, resource.retryAfter);
+    return keepAlive;
+}
+
+void ApiWorker::respond(QTcpSocket *socket, int status, const QByteArray &etag, const QByteArray &body,
+                        bool headOnly, bool keepAlive, int retryAfter)
+{
+    QByteArray response = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+    if (retryAfter > 0) {
+        response += "Retry-After: " + QByteArray::number(retryAfter) + "\r\n";
+    }
+    if (status != 304) {
+        response += "Content-Type: application/json; charset=utf-8\r\n";
+        response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    }
+    if (!etag.isEmpty()) {
+        response += "ETag: " + etag + "\r\n";
+        response += "Cache-Control: no-cache\r\n";
+    }
+    response += keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    if (!headOnly) {
+        response += body;
+    }
+    socket->write(response);
+    if (!keepAlive) {
+        m_connections.remove(socket);
+        socket->disconnectFromHost();
+    }
+}
+
+void ApiWorker::closeIdle()
+{
+    for (auto it = m_connections.begin(); it != m_connections.end();) {
+        if (it->idle.hasExpired(IDLE_TIMEOUT_MS)) {
+            QTcpSocket *socket = it.key();
+            it = m_connections.erase(it);
+            socket->disconnectFromHost();
+        } else {
+            ++it;
+        }
+    }
+}
+
+ApiServer::ApiServer(std::unique_ptr<ApiHandler> handler, QObject *parent)
+    : QObject(parent),
+    m_handler(std::move(handler)),
+    m_thread(nullptr),
+    m_worker(nullptr),
+    m_port(0),
+    m_requests(0),
+    m_notModified(0)
+{
+}
+
+ApiServer::~ApiServer()
+{
+    stop();
+}
+
+bool ApiServer::start(quint16 port, QString *error)
+{
+    if (m_worker) {
+        return true;
+    }
+
+    m_thread = new QThread(this);
+    m_thread->setObjectName("ApiServer");
+    m_worker = new ApiWorker(this);
+    m_worker->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    m_thread->start();
+
+    // 套接字必须在服务线程中创建，监听结果同步返回
+    bool ok = false;
+    QString message;
+    ApiWorker *worker = m_worker;
+    QMetaObject::invokeMethod(worker, [&]() {
+        ok = worker->listen(port, &message);
+        m_port = worker->port();
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        stop();
+        if (error) {
+            *error = message;
+        }
+        return false;
+    }
+    return true;
+}
+
+// 服务线程结束时删除监听器和全部连接；返回后不再访问 handler
+void ApiServer::stop()
+{
+    if (!m_worker) {
+        return;
+    }
+    m_thread->quit();
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_worker = nullptr;
+    m_port = 0;
+}
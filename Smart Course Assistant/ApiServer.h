@@ -0,0 +1,64 @@
+#ifndef APISERVER_H
+#define APISERVER_H
+
+#include <QByteArray>
+#include <QJsonDocument>
+#include <QObject>
+#include <QUrlQuery>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+class QThread;
+class ApiWorker;
+
+// 查询结果：ETag 在生成正文之前就能确定，命中缓存时不再序列化
+struct ApiResource {
+    int status = 200;
+    QByteArray etag;                        // 为空表示不可缓存
+    int retryAfter = 0;                     // 大于 0 时输出 Retry-After（秒），用于 503
+    std::function<QJsonDocument()> render;
+};
+
+// 查询接口的数据来源，只在服务线程中调用
+class ApiHandler
+{
+public:
+    virtual ~ApiHandler() = default;
+    // path 为去掉 /api 前缀后的路径，如 "/next"
+    virtual ApiResource resolve(const QString &path, const QUrlQuery &query) = 0;
+
+    static ApiResource error(int status, const QString &message);
+};
+
+// 本地查询接口：在独立线程中监听 127.0.0.1，提供 GET /api/... 的 JSON 查询
+// 支持 keep-alive 和 If-None-Match，相同 ETag 的正文在服务线程内缓存
+class ApiServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ApiServer(std::unique_ptr<ApiHandler> handler, QObject *parent = nullptr);
+    ~ApiServer();
+
+    // port 为 0 时由系统分配；失败时返回 false 并在 error 中给出原因
+    bool start(quint16 port, QString *error = nullptr);
+    void stop();
+    bool isRunning() const { return m_worker != nullptr; }
+    quint16 port() const { return m_port; }
+
+    quint64 requestCount() const { return m_requests.load(std::memory_order_relaxed); }
+    quint64 notModifiedCount() const { return m_notModified.load(std::memory_order_relaxed); }
+
+private:
+    friend class ApiWorker;
+
+    std::unique_ptr<ApiHandler> m_handler;
+    QThread *m_thread;
+    ApiWorker *m_worker;
+    quint16 m_port;
+    std::atomic<quint64> m_requests;
+    std::atomic<quint64> m_notModified;
+};
+
+#endif // APISERVER_H
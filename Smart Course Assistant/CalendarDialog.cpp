@@ -0,0 +1,97 @@
+#include "CalendarDialog.h"
+#include "ui_CalendarDialog.h"
+#include "TraceRecorder.h"
+#include "TaskManager.h"
+#include <QScrollBar>
+
+CalendarDialog::CalendarDialog(OccurrenceTimeline *timeline, DeadlineIndex *deadlines,
+                               TaskManager *taskManager, QWidget *parent)
+    : QDialog(parent),
+    ui(new Ui::CalendarDialog),
+    m_timeline(timeline)
+{
+    TRACE_SCOPE_CAT("CalendarDialog::CalendarDialog", "dialog");
+    ui->setupUi(this);
+    ui->calendarView->setSources(timeline, deadlines);
+
+    // 跨天后“今天”的高亮与任务状态颜色都要更新
+    connect(taskManager, &TaskManager::statusDateChanged,
+            ui->calendarView, &CalendarView::invalidateAll);
+
+    connect(ui->prevButton, &QPushButton::clicked, this, &CalendarDialog::showPrevious);
+    connect(ui->nextButton, &QPushButton::clicked, this, &CalendarDialog::showNext);
+    connect(ui->todayButton, &QPushButton::clicked, this, &CalendarDialog::showToday);
+    connect(ui->modeComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &CalendarDialog::onModeChanged);
+    connect(m_timeline, &OccurrenceTimeline::changed, this, &CalendarDialog::updateTitle);
+
+    updateTitle();
+}
+
+CalendarDialog::~CalendarDialog()
+{
+    delete ui;
+}
+
+void CalendarDialog::showPrevious()
+{
+    if (ui->calendarView->mode() == CalendarView::MonthMode) {
+        ui->calendarView->setMonth(ui->calendarView->month().addMonths(-1));
+        updateTitle();
+    } else {
+        QScrollBar *bar = ui->calendarView->verticalScrollBar();
+        bar->setValue(bar->value() - bar->pageStep());
+    }
+}
+
+void CalendarDialog::showNext()
+{
+    if (ui->calendarView->mode() == CalendarView::MonthMode) {
+        ui->calendarView->setMonth(ui->calendarView->month().addMonths(1));
+        updateTitle();
+    } else {
+        QScrollBar *bar = ui->calendarView->verticalScrollBar();
+        bar->setValue(bar->value() + bar->pageStep());
+    }
+}
+
+void CalendarDialog::showToday()
+{
+    QDate today = QDate::currentDate();
+    ui->calendarView->setMonth(today);
+    if (ui->calendarView->mode() == CalendarView::SemesterMode) {
+        int week = m_timeline->weekOf(today);
+        if (week >= 0) {
+            QScrollBar *bar = ui->calendarView->verticalScrollBar();
+            bar->setValue(week * bar->maximum() / qMax(1, m_timeline->semesterWeeks() - 1));
+        }
+    }
+    updateTitle();
+}
+
+void CalendarDialog::onModeChanged(int index)
+{
+    ui->calendarView->setMode(index == 1 ? CalendarView::SemesterMode : CalendarView::MonthMode);
+    ui->calendarView->verticalScrollBar()->setValue(0);
+    updateTitle();
+}
+
+void CalendarDialog::updateTitle()
+{
+    if (ui->calendarView->mode() == CalendarView::MonthMode) {
+        QDate month = ui->calendarView->month();
+        ui->titleLabel->setText(QString("%1年%2月").arg(month.year()).arg(month.month()));
+    } else if (!m_timeline->hasSemester()) {
+        ui->titleLabel->setText("尚未设置开学日期（窗口 → 设置学期）");
+    } else {
+        QDate start = m_timeline->semesterStart();
+        ui->titleLabel->setText(QString("学期：%1 起，共 %2 周")
+                                    .arg(start.toString("yyyy-MM-dd"))
+                                    .arg(m_timeline->semesterWeeks()));
+    }
+}
+
+void CalendarDialog::reportMemory(MemoryReport &report) const
+{
+    ui->calendarView->reportMemory(report);
+}
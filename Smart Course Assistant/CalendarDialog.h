@@ -0,0 +1,39 @@
+#ifndef CALENDARDIALOG_H
+#define CALENDARDIALOG_H
+
+#include <QDialog>
+#include "OccurrenceTimeline.h"
+#include "DeadlineIndex.h"
+
+namespace Ui {
+class CalendarDialog;
+}
+
+class TaskManager;
+class MemoryReport;
+
+class CalendarDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    CalendarDialog(OccurrenceTimeline *timeline, DeadlineIndex *deadlines,
+                   TaskManager *taskManager, QWidget *parent = nullptr);
+    ~CalendarDialog();
+
+    void reportMemory(MemoryReport &report) const;
+
+private slots:
+    void showPrevious();
+    void showNext();
+    void showToday();
+    void onModeChanged(int index);
+
+private:
+    void updateTitle();
+
+    Ui::CalendarDialog *ui;
+    OccurrenceTimeline *m_timeline;
+};
+
+#endif // CALENDARDIALOG_H
@@ -0,0 +1,244 @@
+#include "CalendarView.h"
+#include "MemoryStats.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QScrollBar>
+#include <QFontMetrics>
+
+namespace {
+const int TILE_HEIGHT = 120;
+const int HEADER_MARGIN = 4;
+}
+
+CalendarView::CalendarView(QWidget *parent)
+    : QAbstractScrollArea(parent),
+    m_timeline(nullptr),
+    m_deadlines(nullptr),
+    m_mode(MonthMode),
+    m_weekCount(0),
+    m_tileHeight(TILE_HEIGHT)
+{
+    QDate today = QDate::currentDate();
+    m_month = QDate(today.year(), today.month(), 1);
+    setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    verticalScrollBar()->setSingleStep(m_tileHeight / 4);
+    updateRange();
+}
+
+void CalendarView::setSources(OccurrenceTimeline *timeline, DeadlineIndex *deadlines)
+{
+    if (m_timeline) disconnect(m_timeline, nullptr, this, nullptr);
+    if (m_deadlines) disconnect(m_deadlines, nullptr, this, nullptr);
+
+    m_timeline = timeline;
+    m_deadlines = deadlines;
+
+    // 课程变化影响每一周；任务变化只影响所在的那一周
+    if (m_timeline) {
+        connect(m_timeline, &OccurrenceTimeline::changed, this, [this]() {
+            updateRange();
+            invalidateAll();
+        });
+    }
+    if (m_deadlines) {
+        connect(m_deadlines, &DeadlineIndex::dateChanged, this, &CalendarView::invalidateDate);
+        connect(m_deadlines, &DeadlineIndex::reset, this, &CalendarView::invalidateAll);
+    }
+
+    updateRange();
+    invalidateAll();
+}
+
+void CalendarView::setMode(Mode mode)
+{
+    if (m_mode == mode) return;
+    m_mode = mode;
+    updateRange();
+    invalidateAll();
+}
+
+void CalendarView::setMonth(const QDate &date)
+{
+    QDate month(date.year(), date.month(), 1);
+    if (month == m_month) return;
+    m_month = month;
+    if (m_mode == MonthMode) {
+        updateRange();
+        // 月视图中月份外的日期会变灰，需要重新渲染
+        invalidateAll();
+    }
+}
+
+void CalendarView::invalidateDate(const QDate &date)
+{
+    int row = weekRow(date);
+    if (row < 0) return;
+
+    QDate monday = m_firstMonday.addDays(row * 7);
+    m_tiles.remove(monday.toJulianDay());
+
+    int y = row * m_tileHeight - verticalScrollBar()->value();
+    viewport()->update(0, y, viewport()->width(), m_tileHeight);
+}
+
+void CalendarView::invalidateAll()
+{
+    m_tiles.clear();
+    viewport()->update();
+}
+
+void CalendarView::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(viewport());
+    painter.fillRect(event->rect(), palette().base());
+
+    int offset = verticalScrollBar()->value();
+    int firstRow = qMax(0, (event->rect().top() + offset) / m_tileHeight);
+    int lastRow = qMin(m_weekCount - 1, (event->rect().bottom() + offset) / m_tileHeight);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        QDate monday = m_firstMonday.addDays(row * 7);
+        qint64 key = monday.toJulianDay();
+
+        auto it = m_tiles.constFind(key);
+        if (it == m_tiles.constEnd()) {
+            it = m_tiles.insert(key, renderTile(monday));
+        }
+        painter.drawPixmap(0, row * m_tileHeight - offset, it.value());
+    }
+}
+
+void CalendarView::resizeEvent(QResizeEvent *event)
+{
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBar();
+    // 宽度变化后图块尺寸失效
+    m_tiles.clear();
+}
+
+void CalendarView::scrollContentsBy(int, int dy)
+{
+    // 已缓存的图块直接平移，只有新露出的区域会触发绘制
+    viewport()->scroll(0, dy);
+}
+
+// 根据模式确定显示的周范围
+void CalendarView::updateRange()
+{
+    if (m_mode == SemesterMode && m_timeline && m_timeline->hasSemester()) {
+        m_firstMonday = m_timeline->semesterStart();
+        m_weekCount = m_timeline->semesterWeeks();
+    } else {
+        m_firstMonday = m_month.addDays(1 - m_month.dayOfWeek());
+        QDate monthEnd = m_month.addMonths(1).addDays(-1);
+        m_weekCount = static_cast<int>(m_firstMonday.daysTo(monthEnd) / 7) + 1;
+    }
+    updateScrollBar();
+}
+
+void CalendarView::updateScrollBar()
+{
+    int contentHeight = m_weekCount * m_tileHeight;
+    verticalScrollBar()->setPageStep(viewport()->height());
+    verticalScrollBar()->setRange(0, qMax(0, contentHeight - viewport()->height()));
+}
+
+int CalendarView::weekRow(const QDate &date) const
+{
+    if (!date.isValid() || !m_firstMonday.isValid()) return -1;
+    qint64 days = m_firstMonday.daysTo(date);
+    if (days < 0) return -1;
+    int row = static_cast<int>(days / 7);
+    return row < m_weekCount ? row : -1;
+}
+
+// 渲染一周：7个日期格，每格列出当天课程和截止任务
+QPixmap CalendarView::renderTile(const QDate &monday) const
+{
+    int width = qMax(7, viewport()->width());
+    qreal dpr = devicePixelRatioF();
+    QPixmap tile(QSize(width, m_tileHeight) * dpr);
+    tile.setDevicePixelRatio(dpr);
+    tile.fill(palette().color(QPalette::Base));
+
+    QPainter painter(&tile);
+    QFont font = this->font();
+    QFontMetrics metrics(font);
+    int lineHeight = metrics.height();
+    QDate today = QDate::currentDate();
+    int semesterWeek = m_timeline ? m_timeline->weekOf(monday) : -1;
+
+    for (int day = 0; day < 7; ++day) {
+        QDate date = monday.addDays(day);
+        int x = day * width / 7;
+        int cellWidth = (day + 1) * width / 7 - x;
+        QRect cell(x, 0, cellWidth, m_tileHeight);
+
+        bool outside = m_mode == MonthMode && date.month() != m_month.month();
+        if (date == today) {
+            painter.fillRect(cell, palette().color(QPalette::AlternateBase));
+        }
+        painter.setPen(palette().color(QPalette::Mid));
+        painter.drawRect(cell.adjusted(0, 0, -1, -1));
+
+        // 日期标题，周一额外显示学期周次
+        QString header = QString::number(date.day());
+        if (date.day() == 1) {
+            header = QString("%1月%2日").arg(date.month()).arg(date.day());
+        }
+        if (day == 0 && semesterWeek >= 0) {
+            header += QString("  第%1周").arg(semesterWeek + 1);
+        }
+        painter.setPen(outside ? palette().color(QPalette::Disabled, QPalette::Text)
+                               : palette().color(QPalette::Text));
+        QRect textRect = cell.adjusted(HEADER_MARGIN, HEADER_MARGIN, -HEADER_MARGIN, 0);
+        painter.drawText(textRect, Qt::AlignLeft | Qt::AlignTop, header);
+
+        int y = HEADER_MARGIN + lineHeight;
+        int maxY = m_tileHeight - lineHeight;
+
+        if (m_timeline) {
+            for (const OccurrenceTimeline::Occurrence &occurrence : m_timeline->occurrencesOn(date)) {
+                if (y > maxY) break;
+                QRect line(x + HEADER_MARGIN, y, cellWidth - 2 * HEADER_MARGIN, lineHeight);
+                QColor color = occurrence.course->color();
+                if (outside) color.setAlpha(80);
+                painter.fillRect(line, color);
+                painter.setPen(Qt::black);
+                painter.drawText(line.adjusted(2, 0, -2, 0), Qt::AlignLeft | Qt::AlignVCenter,
+                                 metrics.elidedText(QString("%1-%2 %3")
+                                                        .arg(occurrence.startSection)
+                                                        .arg(occurrence.endSection)
+                                                        .arg(occurrence.course->name()),
+                                                    Qt::ElideRight, line.width() - 4));
+                y += lineHeight + 1;
+            }
+        }
+
+        if (m_deadlines) {
+            for (Task *task : m_deadlines->tasksOn(date)) {
+                if (y > maxY) break;
+                QRect line(x + HEADER_MARGIN, y, cellWidth - 2 * HEADER_MARGIN, lineHeight);
+                painter.setPen(task->isCompleted() ? palette().color(QPalette::Disabled, QPalette::Text)
+                                                   : QColor(220, 60, 60));
+                painter.drawText(line, Qt::AlignLeft | Qt::AlignVCenter,
+                                 metrics.elidedText(QString("%1 %2")
+                                                        .arg(task->isExam() ? "考" : "⚑")
+                                                        .arg(task->title()),
+                                                    Qt::ElideRight, line.width()));
+                y += lineHeight + 1;
+            }
+        }
+    }
+
+    return tile;
+}
+
+void CalendarView::reportMemory(MemoryReport &report) const
+{
+    qint64 bytes = MemoryStats::nodeBytes(m_tiles, sizeof(qint64) + sizeof(QPixmap));
+    for (const QPixmap &tile : m_tiles) {
+        bytes += qint64(tile.width()) * tile.height() * tile.depth() / 8;
+    }
+    report.add("日历图块", m_tiles.size(), bytes);
+}
@@ -0,0 +1,63 @@
+#ifndef CALENDARVIEW_H
+#define CALENDARVIEW_H
+
+#include <QAbstractScrollArea>
+#include <QDate>
+#include <QHash>
+#include <QPixmap>
+#include "OccurrenceTimeline.h"
+#include "DeadlineIndex.h"
+
+class MemoryReport;
+
+// 日历视图：每一周为一行，按周缓存渲染好的图块
+// 滚动时只绘制新露出的周，数据变化时只重绘受影响的周
+class CalendarView : public QAbstractScrollArea
+{
+    Q_OBJECT
+public:
+    enum Mode {
+        MonthMode = 0,
+        SemesterMode
+    };
+
+    explicit CalendarView(QWidget *parent = nullptr);
+
+    void setSources(OccurrenceTimeline *timeline, DeadlineIndex *deadlines);
+
+    void setMode(Mode mode);
+    Mode mode() const { return m_mode; }
+
+    // 月视图显示的月份（取该日期所在月）
+    void setMonth(const QDate &date);
+    QDate month() const { return m_month; }
+
+    int cachedTileCount() const { return m_tiles.size(); }
+    void reportMemory(MemoryReport &report) const;
+
+public slots:
+    void invalidateDate(const QDate &date);
+    void invalidateAll();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    void updateRange();
+    void updateScrollBar();
+    QPixmap renderTile(const QDate &monday) const;
+    int weekRow(const QDate &date) const;
+
+    OccurrenceTimeline *m_timeline;
+    DeadlineIndex *m_deadlines;
+    Mode m_mode;
+    QDate m_month;          // 当月1日
+    QDate m_firstMonday;    // 第一行的周一
+    int m_weekCount;
+    int m_tileHeight;
+    QHash<qint64, QPixmap> m_tiles;   // 周一的儒略日 -> 渲染好的周图块
+};
+
+#endif // CALENDARVIEW_H
@@ -0,0 +1,191 @@
+#ifndef CHUNKEDVECTOR_H
+#define CHUNKEDVECTOR_H
+
+#include <QVector>
+#include <algorithm>
+#include <iterator>
+
+// 分块数组：元素按块存放，每块是一个隐式共享的 QVector，块的起始下标另存一份用于二分查找
+// 复制整个数组只增加引用计数；之后修改一个元素时只复制块索引和所在的那一块，
+// 因此快照“复制后改一条再发布”的开销约为 O(n/CHUNK_SIZE + CHUNK_SIZE)，而不是复制全部 n 个元素
+// 与 QVector 一样只在一个线程中修改，复制出去的副本可在其他线程只读访问
+template <typename T>
+class ChunkedVector
+{
+public:
+    static constexpr int CHUNK_SIZE = 256;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() : m_chunks(nullptr), m_chunk(0), m_pos(0) {}
+        const_iterator(const QVector<QVector<T>> *chunks, int chunk, int pos)
+            : m_chunks(chunks), m_chunk(chunk), m_pos(pos) {}
+
+        reference operator*() const { return m_chunks->at(m_chunk).at(m_pos); }
+        pointer operator->() const { return &m_chunks->at(m_chunk).at(m_pos); }
+        const_iterator &operator++()
+        {
+            if (++m_pos >= m_chunks->at(m_chunk).size()) {
+                ++m_chunk;
+                m_pos = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator &other) const
+        {
+            return m_chunk == other.m_chunk && m_pos == other.m_pos;
+        }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+
+    private:
+        const QVector<QVector<T>> *m_chunks;
+        int m_chunk;
+        int m_pos;
+    };
+
+    ChunkedVector() : m_size(0) {}
+    ChunkedVector(const QVector<T> &items) : m_size(0) { append(items); }
+
+    int size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    const T &at(int i) const
+    {
+        int chunk = chunkOf(i);
+        return m_chunks.at(chunk).at(i - m_offsets.at(chunk));
+    }
+    const T &operator[](int i) const { return at(i); }
+    T value(int i) const { return i >= 0 && i < m_size ? at(i) : T(); }
+
+    const_iterator begin() const { return const_iterator(&m_chunks, 0, 0); }
+    const_iterator end() const { return const_iterator(&m_chunks, m_chunks.size(), 0); }
+
+    void append(const T &item)
+    {
+        if (m_chunks.isEmpty() || m_chunks.last().size() >= CHUNK_SIZE) {
+            m_offsets.append(m_size);
+            m_chunks.append(QVector<T>());
+            m_chunks.last().reserve(CHUNK_SIZE);
+        }
+        m_chunks.last().append(item);
+        ++m_size;
+    }
+
+    void append(const QVector<T> &items)
+    {
+        for (const T &item : items) {
+            append(item);
+        }
+    }
+    ChunkedVector &operator+=(const QVector<T> &items)
+    {
+        append(items);
+        return *this;
+    }
+
+    // 插入到所在块中，块过大时一分为二
+    void insert(int i, const T &item)
+    {
+        if (i >= m_size) {
+            append(item);
+            return;
+        }
+        int chunk = chunkOf(qMax(0, i));
+        QVector<T> &items = m_chunks[chunk];
+        items.insert(qMax(0, i) - m_offsets.at(chunk), item);
+        ++m_size;
+        if (items.size() > 2 * CHUNK_SIZE) {
+            QVector<T> tail = items.mid(CHUNK_SIZE);
+            items.resize(CHUNK_SIZE);
+            m_chunks.insert(chunk + 1, tail);
+            m_offsets.insert(chunk + 1, 0);
+        }
+        updateOffsets(chunk + 1);
+    }
+
+    void replace(int i, const T &item)
+    {
+        int chunk = chunkOf(i);
+        m_chunks[chunk][i - m_offsets.at(chunk)] = item;
+    }
+
+    // 删除后过小的块与相邻块合并，避免块数随删除增长
+    void remove(int i, int count = 1)
+    {
+        while (count > 0 && i < m_size) {
+            int chunk = chunkOf(i);
+            QVector<T> &items = m_chunks[chunk];
+            int pos = i - m_offsets.at(chunk);
+            int n = qMin(count, items.size() - pos);
+            items.remove(pos, n);
+            m_size -= n;
+            count -= n;
+            if (items.isEmpty()) {
+                m_chunks.remove(chunk);
+                m_offsets.remove(chunk);
+            } else if (items.size() < CHUNK_SIZE / 4 && chunk + 1 < m_chunks.size()
+                       && items.size() + m_chunks.at(chunk + 1).size() <= CHUNK_SIZE) {
+                items += m_chunks.at(chunk + 1);
+                m_chunks.remove(chunk + 1);
+                m_offsets.remove(chunk + 1);
+            }
+            updateOffsets(chunk);
+        }
+    }
+
+    void clear()
+    {
+        m_chunks.clear();
+        m_offsets.clear();
+        m_size = 0;
+    }
+
+    QVector<T> toVector() const
+    {
+        QVector<T> result;
+        result.reserve(m_size);
+        for (const QVector<T> &chunk : m_chunks) {
+            result += chunk;
+        }
+        return result;
+    }
+
+    // 供内存统计使用
+    const QVector<QVector<T>> &chunks() const { return m_chunks; }
+    const QVector<int> &offsets() const { return m_offsets; }
+
+private:
+    int chunkOf(int i) const
+    {
+        auto it = std::upper_bound(m_offsets.constBegin(), m_offsets.constEnd(), i);
+        return int(it - m_offsets.constBegin()) - 1;
+    }
+
+    void updateOffsets(int fromChunk)
+    {
+        int offset = fromChunk > 0 ? m_offsets.at(fromChunk - 1) + m_chunks.at(fromChunk - 1).size() : 0;
+        for (int chunk = qMax(0, fromChunk); chunk < m_chunks.size(); ++chunk) {
+            m_offsets[chunk] = offset;
+            offset += m_chunks.at(chunk).size();
+        }
+    }
+
+    QVector<QVector<T>> m_chunks;
+    QVector<int> m_offsets;     // 每块第一个元素的下标
+    int m_size;
+};
+
+#endif // CHUNKEDVECTOR_H
@@ -9,7 +9,8 @@ Course::Course(QObject *parent)
     m_dayOfWeek(1),
     m_startSection(1),
     m_endSection(1),
-    m_color(Qt::blue)
+    m_color(Qt::blue),
+    m_weekParity(EveryWeek)
 {
 }
 
@@ -22,7 +23,8 @@ Course::Course(const QString &name, int day, int startSection, int endSection,
     m_startSection(startSection),
     m_endSection(endSection),
     m_classroom(classroom),
-    m_color(QColor::fromHsv((day * 50 + startSection * 10) % 360, 150, 230))
+    m_color(QColor::fromHsv((day * 50 + startSection * 10) % 360, 150, 230)),
+    m_weekParity(EveryWeek)
 {
 }
 Course::Course(const Course &other, QObject *parent)
@@ -35,6 +37,7 @@ Course::Course(const Course &other, QObject *parent)
     , m_teacher(other.m_teacher)
     , m_note(other.m_note)
     , m_color(other.m_color)
+    , m_weekParity(other.m_weekParity)
 {
 }
 Course& Course::operator=(const Course& other)
@@ -48,10 +51,12 @@ Course& Course::operator=(const Course& other)
         m_teacher = other.m_teacher;
         m_note = other.m_note;
         m_color = other.m_color;
+        m_weekParity = other.m_weekParity;
     }
     return *this;
 }
 // 序列化操作(写入数据流)
+// 周次字段由 ScheduleManager 按文件版本单独读写，这里保持版本1的格式
 QDataStream &operator<<(QDataStream &out, const Course &course)
 {
     out << course.m_name
@@ -86,6 +91,10 @@ bool Course::hasTimeConflictWith(const Course &other) const
         return false;
     }
 
+    if (!sharesWeeks(m_weekParity, other.m_weekParity)) {
+        return false;
+    }
+
     return !(m_endSection < other.m_startSection ||
              other.m_endSection < m_startSection);
 }
@@ -96,6 +105,31 @@ int Course::duration() const
     return m_endSection - m_startSection + 1;
 }
 
+bool Course::occursInWeek(int week) const
+{
+    return occursInWeek(m_weekParity, week);
+}
+
+bool Course::occursInWeek(int parity, int week)
+{
+    if (week <= 0) {
+        return true;
+    }
+    switch (parity) {
+    case OddWeeks:
+        return week % 2 == 1;
+    case EvenWeeks:
+        return week % 2 == 0;
+    default:
+        return true;
+    }
+}
+
+bool Course::sharesWeeks(int parity, int otherParity)
+{
+    return parity == EveryWeek || otherParity == EveryWeek || parity == otherParity;
+}
+
 // 设置课程节次范围
 void Course::setSections(int start, int end)
 {
@@ -142,12 +176,16 @@ QString Course::displayText() const
     QTime startTime = ScheduleManager::getSectionStartTime(m_startSection);
     QTime endTime = ScheduleManager::getSectionEndTime(m_endSection);
 
-    return QString("%1\n%2\n%3-%4\n%5")
+    QString text = QString("%1\n%2\n%3-%4\n%5")
         .arg(m_name)
         .arg(m_classroom)
         .arg(startTime.toString("hh:mm"))
         .arg(endTime.toString("hh:mm"))
         .arg(m_teacher);
+    if (m_weekParity != EveryWeek) {
+        text += "\n" + weekParityText(m_weekParity);
+    }
+    return text;
 }
 
 QString Course::classroom() const { return m_classroom; }
@@ -161,3 +199,23 @@ void Course::setNote(const QString &note) { m_note = note; }
 
 QColor Course::color() const { return m_color; }
 void Course::setColor(const QColor &color) { m_color = color; }
+
+int Course::weekParity() const { return m_weekParity; }
+void Course::setWeekParity(int parity)
+{
+    if (parity >= EveryWeek && parity <= EvenWeeks) {
+        m_weekParity = parity;
+    }
+}
+
+QString Course::weekParityText(int parity)
+{
+    switch (parity) {
+    case OddWeeks:
+        return "单周";
+    case EvenWeeks:
+        return "双周";
+    default:
+        return "每周";
+    }
+}
@@ -19,10 +19,18 @@ class Course : public QObject
     Q_PROPERTY(QString teacher READ teacher WRITE setTeacher)
     Q_PROPERTY(QString note READ note WRITE setNote)
     Q_PROPERTY(QColor color READ color WRITE setColor)
+    Q_PROPERTY(int weekParity READ weekParity WRITE setWeekParity)
 
 public:
     static const int MAX_SECTION = 12; // 最大节次
 
+    // 上课周次
+    enum WeekParity {
+        EveryWeek = 0,
+        OddWeeks,      // 单周
+        EvenWeeks      // 双周
+    };
+
     explicit Course(QObject *parent = nullptr);
     Course(const QString &name, int day, int startSection, int endSection,
            const QString &classroom, QObject *parent = nullptr);
@@ -39,6 +47,12 @@ public:
     // 获取课程持续时间(节数)
     int duration() const;
 
+    // 学期第 week 周（从1开始）是否上课；week <= 0 表示周次未知，按上课处理
+    bool occursInWeek(int week) const;
+    static bool occursInWeek(int parity, int week);
+    // 两种周次是否有共同的上课周：一门单周、一门双周的课程永远不会同时上课，可以共用同一时段
+    static bool sharesWeeks(int parity, int otherParity);
+
     // 设置课程节次范围
     void setSections(int start, int end);
 
@@ -70,6 +84,10 @@ public:
     QColor color() const;
     void setColor(const QColor &color);
 
+    int weekParity() const;
+    void setWeekParity(int parity);
+    static QString weekParityText(int parity);
+
 private:
     QString m_name;          // 课程名称
     int m_dayOfWeek;         // 星期几(1-7)
@@ -79,6 +97,7 @@ private:
     QString m_teacher;       // 教师姓名
     QString m_note;          // 备注信息
     QColor m_color;          // 显示颜色
+    int m_weekParity;        // 上课周次(WeekParity)
 };
 
 #endif // COURSE_H
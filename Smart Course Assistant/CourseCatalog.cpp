@@ -0,0 +1,493 @@
+#include "CourseCatalog.h"
+#include "Course.h"
+#include "MemoryStats.h"
+#include "StringPool.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStringList>
+
+namespace {
+
+const char AUTO_ID_PREFIX[] = "auto-";
+
+bool sameSection(const CourseRecord &a, const CourseRecord &b)
+{
+    return a.name == b.name && a.dayOfWeek == b.dayOfWeek
+           && a.startSection == b.startSection && a.endSection == b.endSection
+           && a.classroom == b.classroom && a.teacher == b.teacher
+           && a.weekParity == b.weekParity && a.color == b.color;
+}
+
+// 由内容生成的 ID 在多次运行之间保持不变；与已有课程重名时加序号
+QString autoId(const QString &key, const QHash<QString, std::shared_ptr<const CourseRecord>> &sections)
+{
+    QString base = AUTO_ID_PREFIX
+                   + QString::fromLatin1(QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1)
+                                             .toHex().left(12));
+    QString id = base;
+    for (int i = 2; sections.contains(id); ++i) {
+        id = base + '-' + QString::number(i);
+    }
+    return id;
+}
+
+// catalog.json 的课程和 timetable.json 中自带的 auto- 课程使用同一格式
+CourseRecord recordFromJson(const QJsonObject &obj)
+{
+    CourseRecord record;
+    record.name = obj.value("name").toString();
+    record.dayOfWeek = obj.value("dayOfWeek").toInt();
+    record.startSection = obj.value("startSection").toInt();
+    record.endSection = obj.value("endSection").toInt();
+    record.classroom = obj.value("classroom").toString();
+    record.teacher = obj.value("teacher").toString();
+    record.weekParity = obj.value("weeks").toInt(Course::EveryWeek);
+    record.color = QColor(obj.value("color").toString());
+    return record;
+}
+
+QJsonObject recordToJson(const CourseRecord &record)
+{
+    QJsonObject obj;
+    obj["name"] = record.name;
+    obj["dayOfWeek"] = record.dayOfWeek;
+    obj["startSection"] = record.startSection;
+    obj["endSection"] = record.endSection;
+    obj["classroom"] = record.classroom;
+    obj["teacher"] = record.teacher;
+    obj["weeks"] = record.weekParity;
+    obj["color"] = record.color.name();
+    return obj;
+}
+
+bool isValidRecord(const CourseRecord &record)
+{
+    return !record.name.isEmpty()
+           && record.dayOfWeek >= 1 && record.dayOfWeek <= 7
+           && record.startSection >= 1 && record.endSection <= Course::MAX_SECTION
+           && record.startSection <= record.endSection
+           && record.weekParity >= Course::EveryWeek && record.weekParity <= Course::EvenWeeks;
+}
+
+bool readJsonObject(const QString &filePath, QJsonObject &root, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) {
+            *error = parseError.errorString();
+        }
+        return false;
+    }
+    root = doc.object();
+    return true;
+}
+
+bool writeJsonObject(const QString &filePath, const QJsonObject &root)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "无法写入" << filePath << ":" << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return file.commit();
+}
+
+} // namespace
+
+CourseCatalog::CourseCatalog()
+    : m_data(std::make_shared<const Data>()),
+    m_keyBytes(0),
+    m_strings(nullptr)
+{
+}
+
+void CourseCatalog::indexKey(const QString &key, const QString &id)
+{
+    if (!m_idByKey.contains(key)) {
+        m_keyBytes += MemoryStats::stringBytes(key);
+    }
+    m_idByKey.insert(key, id);
+}
+
+void CourseCatalog::unindexKey(const QString &key)
+{
+    if (m_idByKey.remove(key) > 0) {
+        m_keyBytes -= MemoryStats::stringBytes(key);
+    }
+}
+
+bool CourseCatalog::isAutoId(const QString &id)
+{
+    return id.startsWith(AUTO_ID_PREFIX);
+}
+
+// 只包含教务决定的字段，颜色和备注属于学生自己
+QString CourseCatalog::sectionKey(const CourseRecord &course)
+{
+    const QChar separator(0x1f);
+    return QStringList{course.name, QString::number(course.dayOfWeek),
+                       QString::number(course.startSection), QString::number(course.endSection),
+                       course.classroom, course.teacher, QString::number(course.weekParity)}
+        .join(separator);
+}
+
+std::shared_ptr<CourseCatalog::Data> CourseCatalog::begin() const
+{
+    auto next = std::make_shared<Data>(*current());
+    ++next->version;
+    return next;
+}
+
+void CourseCatalog::publish(const std::shared_ptr<Data> &next)
+{
+    std::atomic_store(&m_data, DataPtr(next));
+}
+
+CourseRecord CourseCatalog::canonical(const CourseRecord &section) const
+{
+    CourseRecord record = section;
+    record.note.clear();
+    if (m_strings) {
+        record.name = m_strings->intern(record.name);
+        record.classroom = m_strings->intern(record.classroom);
+        record.teacher = m_strings->intern(record.teacher);
+    }
+    return record;
+}
+
+void CourseCatalog::upsert(const QString &id, const CourseRecord &section)
+{
+    auto next = begin();
+    if (upsertInto(*next, id, section)) {
+        publish(next);
+    }
+}
+
+bool CourseCatalog::remove(const QString &id)
+{
+    auto next = begin();
+    if (!removeFrom(*next, id)) {
+        return false;
+    }
+    publish(next);
+    return true;
+}
+
+// 内容未变化时返回 false，调用者不必发布新版本
+bool CourseCatalog::upsertInto(Data &next, const QString &id, const CourseRecord &section)
+{
+    CourseRecord record = canonical(section);
+    std::shared_ptr<const CourseRecord> old = next.sections.value(id);
+    if (old && sameSection(*old, record)) {
+        return false;
+    }
+    if (old) {
+        QString oldKey = sectionKey(*old);
+        if (m_idByKey.value(oldKey) == id) {
+            unindexKey(oldKey);
+        }
+    }
+    // 内容相同的多个 ID 中，匹配时使用最先加入的一个
+    QString key = sectionKey(record);
+    if (!m_idByKey.contains(key)) {
+        indexKey(key, id);
+    }
+    next.sections.insert(id, std::make_shared<const CourseRecord>(record));
+    return true;
+}
+
+bool CourseCatalog::removeFrom(Data &next, const QString &id)
+{
+    std::shared_ptr<const CourseRecord> old = next.sections.take(id);
+    if (!old) {
+        return false;
+    }
+    QString key = sectionKey(*old);
+    if (m_idByKey.value(key) == id) {
+        unindexKey(key);
+    }
+    return true;
+}
+
+// 按教务字段匹配目录中的课程，没有时新建；新加入的课程先收集起来，只发布一次
+QVector<TimetableEntry> CourseCatalog::toTimetable(const QVector<CourseRecord> &courses)
+{
+    QVector<TimetableEntry> timetable;
+    timetable.reserve(courses.size());
+    std::shared_ptr<Data> next;
+    for (const CourseRecord &course : courses) {
+        QString key = sectionKey(course);
+        QString id = m_idByKey.value(key);
+        std::shared_ptr<const CourseRecord> section;
+        if (!id.isEmpty()) {
+            section = (next ? next->sections : current()->sections).value(id);
+        } else {
+            if (!next) {
+                next = begin();
+            }
+            id = autoId(key, next->sections);
+            section = std::make_shared<const CourseRecord>(canonical(course));
+            next->sections.insert(id, section);
+            indexKey(key, id);
+            m_unreferenced.insert(id);
+        }
+
+        TimetableEntry entry;
+        entry.sectionId = id;
+        if (isAutoId(id)) {
+            entry.section = section;
+        }
+        if (section && course.color != section->color) {
+            entry.color = course.color;
+        }
+        entry.note = m_strings ? m_strings->intern(course.note) : course.note;
+        timetable.append(entry);
+    }
+    if (next) {
+        publish(next);
+    }
+    return timetable;
+}
+
+// 目录中已被移除的 auto- 课程（淘汰后重新加载的学生）按课表自带的内容恢复，只发布一次
+// 从文件读出的内容换成目录中的记录，字符串随之驻留，不再单独占用内存
+void CourseCatalog::retain(QVector<TimetableEntry> &timetable)
+{
+    DataPtr data = current();
+    std::shared_ptr<Data> next;
+    for (TimetableEntry &entry : timetable) {
+        if (!isAutoId(entry.sectionId)) {
+            continue;
+        }
+        ++m_autoRefs[entry.sectionId];
+        m_unreferenced.remove(entry.sectionId);
+        std::shared_ptr<const CourseRecord> section =
+            (next ? next->sections : data->sections).value(entry.sectionId);
+        if (!section && entry.section) {
+            if (!next) {
+                next = begin();
+            }
+            section = std::make_shared<const CourseRecord>(canonical(*entry.section));
+            next->sections.insert(entry.sectionId, section);
+            QString key = sectionKey(*section);
+            if (!m_idByKey.contains(key)) {
+                indexKey(key, entry.sectionId);
+            }
+        }
+        if (section) {
+            entry.section = section;
+        }
+    }
+    if (next) {
+        publish(next);
+    }
+}
+
+void CourseCatalog::release(const QVector<TimetableEntry> &timetable)
+{
+    for (const TimetableEntry &entry : timetable) {
+        auto it = m_autoRefs.find(entry.sectionId);
+        if (it == m_autoRefs.end()) {
+            continue;
+        }
+        if (--it.value() <= 0) {
+            m_autoRefs.erase(it);
+            m_unreferenced.insert(entry.sectionId);
+        }
+    }
+}
+
+// 只检查计数降为 0 的课程，不必遍历整个目录
+int CourseCatalog::dropUnreferenced()
+{
+    if (m_unreferenced.isEmpty()) {
+        return 0;
+    }
+    std::shared_ptr<Data> next = begin();
+    int removed = 0;
+    for (const QString &id : std::as_const(m_unreferenced)) {
+        if (!m_autoRefs.contains(id) && removeFrom(*next, id)) {
+            ++removed;
+        }
+    }
+    m_unreferenced.clear();
+    if (removed > 0) {
+        publish(next);
+    }
+    return removed;
+}
+
+QVector<std::shared_ptr<const CourseRecord>> CourseCatalog::resolve(const Data &catalog,
+                                                                    const QVector<TimetableEntry> &timetable,
+                                                                    int *missing)
+{
+    QVector<std::shared_ptr<const CourseRecord>> courses;
+    courses.reserve(timetable.size());
+    int notFound = 0;
+    for (const TimetableEntry &entry : timetable) {
+        std::shared_ptr<const CourseRecord> section = catalog.sections.value(entry.sectionId);
+        if (!section) {
+            ++notFound;
+            continue;
+        }
+        if (!entry.color.isValid() && entry.note.isEmpty()) {
+            courses.append(section);
+            continue;
+        }
+        // 有覆盖项时复制一条记录，字符串仍与目录共用
+        CourseRecord record = *section;
+        if (entry.color.isValid()) {
+            record.color = entry.color;
+        }
+        record.note = entry.note;
+        courses.append(std::make_shared<const CourseRecord>(record));
+    }
+    if (missing) {
+        *missing = notFound;
+    }
+    return courses;
+}
+
+// 合并读取：文件中的课程新增或更新，文件中已删除的课程从目录移除
+// 迁移生成的 auto- 课程不由 catalog.json 管理，保持不变
+bool CourseCatalog::loadJson(const QString &filePath, QString *error)
+{
+    QJsonObject root;
+    if (!readJsonObject(filePath, root, error)) {
+        return false;
+    }
+
+    QHash<QString, CourseRecord> sections;
+    const QJsonArray array = root.value("sections").toArray();
+    for (const QJsonValue &value : array) {
+        QJsonObject obj = value.toObject();
+        QString id = obj.value("id").toString();
+        CourseRecord record = recordFromJson(obj);
+        if (id.isEmpty() || isAutoId(id) || !isValidRecord(record)) {
+            qWarning() << filePath << "中的课程无效，已跳过:" << id;
+            continue;
+        }
+        sections.insert(id, record);
+    }
+
+    // 整个文件只发布一个版本，内容没有变化时版本号不变
+    auto next = begin();
+    bool changed = false;
+    const QStringList ids = next->sections.keys();
+    for (const QString &id : ids) {
+        if (!isAutoId(id) && !sections.contains(id)) {
+            changed = removeFrom(*next, id) || changed;
+        }
+    }
+    for (auto it = sections.constBegin(); it != sections.constEnd(); ++it) {
+        changed = upsertInto(*next, it.key(), it.value()) || changed;
+    }
+    if (changed) {
+        publish(next);
+    }
+    return true;
+}
+
+bool CourseCatalog::saveJson(const QString &filePath) const
+{
+    QJsonArray array;
+    DataPtr data = current();
+    for (auto it = data->sections.constBegin(); it != data->sections.constEnd(); ++it) {
+        if (isAutoId(it.key())) {
+            continue;
+        }
+        QJsonObject obj = recordToJson(*it.value());
+        obj["id"] = it.key();
+        array.append(obj);
+    }
+    return writeJsonObject(filePath, QJsonObject{{"sections", array}});
+}
+
+bool CourseCatalog::loadTimetable(const QString &filePath, QVector<TimetableEntry> &timetable, QString *error)
+{
+    QJsonObject root;
+    if (!readJsonObject(filePath, root, error)) {
+        return false;
+    }
+    const QJsonArray array = root.value("sections").toArray();
+    timetable.clear();
+    timetable.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        QJsonObject obj = value.toObject();
+        TimetableEntry entry;
+        entry.sectionId = obj.value("id").toString();
+        if (entry.sectionId.isEmpty()) {
+            continue;
+        }
+        if (obj.contains("color")) {
+            entry.color = QColor(obj.value("color").toString());
+        }
+        entry.note = obj.value("note").toString();
+        if (isAutoId(entry.sectionId) && obj.contains("section")) {
+            CourseRecord record = recordFromJson(obj.value("section").toObject());
+            if (isValidRecord(record)) {
+                entry.section = std::make_shared<const CourseRecord>(record);
+            }
+        }
+        timetable.append(entry);
+    }
+    return true;
+}
+
+bool CourseCatalog::saveTimetable(const QString &filePath, const QVector<TimetableEntry> &timetable)
+{
+    QJsonArray array;
+    for (const TimetableEntry &entry : timetable) {
+        QJsonObject obj;
+        obj["id"] = entry.sectionId;
+        if (entry.color.isValid()) {
+            obj["color"] = entry.color.name();
+        }
+        if (!entry.note.isEmpty()) {
+            obj["note"] = entry.note;
+        }
+        if (entry.section) {
+            obj["section"] = recordToJson(*entry.section);
+        }
+        array.append(obj);
+    }
+    return writeJsonObject(filePath, QJsonObject{{"sections", array}});
+}
+
+qint64 CourseCatalog::bytes() const
+{
+    DataPtr data = current();
+    return MemoryStats::nodeBytes(data->sections, sizeof(QString) + sizeof(std::shared_ptr<const CourseRecord>))
+           + qint64(data->sections.size()) * MemoryStats::courseRecordBytes()
+           + MemoryStats::nodeBytes(m_idByKey, 2 * sizeof(QString))
+           + m_keyBytes
+           + MemoryStats::nodeBytes(m_autoRefs, sizeof(QString) + sizeof(int));
+}
+
+// 使用驻留池时字符串计入池中，这里只计记录本身
+void CourseCatalog::reportMemory(MemoryReport &report) const
+{
+    DataPtr data = current();
+    qint64 stringBytes = 0;
+    if (!m_strings) {
+        for (const auto &section : data->sections) {
+            stringBytes += MemoryStats::stringBytes(section->name) + MemoryStats::stringBytes(section->classroom)
+                           + MemoryStats::stringBytes(section->teacher);
+        }
+    }
+    report.add("课程目录", data->sections.size(), bytes() + stringBytes, stringBytes);
+}
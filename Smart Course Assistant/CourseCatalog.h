@@ -0,0 +1,92 @@
+#ifndef COURSECATALOG_H
+#define COURSECATALOG_H
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QVector>
+#include <memory>
+#include "Snapshot.h"
+
+class MemoryReport;
+class StringPool;
+
+// 课表中的一项：引用目录中的课程，颜色和备注可以按学生覆盖
+struct TimetableEntry {
+    QString sectionId;
+    QColor color;       // 无效时使用目录中的颜色
+    QString note;
+    // auto- 课程不由 catalog.json 管理，课表中带一份完整内容，目录中没有时据此恢复
+    std::shared_ptr<const CourseRecord> section;
+};
+
+// 课程目录：全院系共用的标准课程（教学班），以 ID 标识
+// 与 SnapshotPublisher 相同，修改时复制后整体发布，读取可在任意线程进行且无需加锁；只在一个线程中写入
+// 教务调整（换教室、换老师等）只需修改目录中的一条，引用它的课表在下次解析时即得到新内容
+class CourseCatalog
+{
+public:
+    struct Data {
+        quint64 version = 0;
+        QHash<QString, std::shared_ptr<const CourseRecord>> sections;
+    };
+    using DataPtr = std::shared_ptr<const Data>;
+
+    CourseCatalog();
+
+    DataPtr current() const { return std::atomic_load(&m_data); }
+    quint64 version() const { return current()->version; }
+    int size() const { return current()->sections.size(); }
+
+    // 新增或修改课程；目录中的记录不带备注
+    void upsert(const QString &id, const CourseRecord &section);
+    bool remove(const QString &id);
+
+    // 把学生的课程转换为对目录的引用：时间、地点、教师等完全相同即为同一课程，
+    // 目录中没有的按内容生成 auto- 开头的 ID 加入；与目录不同的颜色和备注记为覆盖项
+    // 新生成的 auto- 课程在 retain 之前没有引用，下次 dropUnreferenced 时即被移除
+    QVector<TimetableEntry> toTimetable(const QVector<CourseRecord> &courses);
+
+    // auto- 课程按引用它的课表计数：retain 时把课表自带的内容补回目录，并让课表改为引用目录中的记录；
+    // release 后不再被引用的由 dropUnreferenced 移除；catalog.json 中的课程不计数
+    void retain(QVector<TimetableEntry> &timetable);
+    void release(const QVector<TimetableEntry> &timetable);
+    int dropUnreferenced();
+    static bool isAutoId(const QString &id);
+    // 按目录解析课表：没有覆盖项的课程直接共用目录中的记录；missing 为目录中已不存在的项数
+    static QVector<std::shared_ptr<const CourseRecord>> resolve(const Data &catalog,
+                                                                const QVector<TimetableEntry> &timetable,
+                                                                int *missing = nullptr);
+
+    // catalog.json / timetable.json 读写；合并 catalog.json 不影响 auto- 课程
+    bool loadJson(const QString &filePath, QString *error = nullptr);
+    bool saveJson(const QString &filePath) const;
+    static bool loadTimetable(const QString &filePath, QVector<TimetableEntry> &timetable,
+                              QString *error = nullptr);
+    static bool saveTimetable(const QString &filePath, const QVector<TimetableEntry> &timetable);
+
+    // 设置后，写入目录的字符串先经过驻留池
+    void setStringPool(StringPool *pool) { m_strings = pool; }
+    // 目录记录与匹配表的估算占用；使用驻留池时字符串计入池中
+    qint64 bytes() const;
+    void reportMemory(MemoryReport &report) const;
+
+private:
+    static QString sectionKey(const CourseRecord &course);
+    std::shared_ptr<Data> begin() const;
+    bool upsertInto(Data &next, const QString &id, const CourseRecord &section);
+    bool removeFrom(Data &next, const QString &id);
+    void publish(const std::shared_ptr<Data> &next);
+    CourseRecord canonical(const CourseRecord &section) const;
+    void indexKey(const QString &key, const QString &id);
+    void unindexKey(const QString &key);
+
+    DataPtr m_data;
+    QHash<QString, QString> m_idByKey;  // 课程内容 -> ID，只在写入线程中使用
+    qint64 m_keyBytes;                  // m_idByKey 中键字符串的占用
+    QHash<QString, int> m_autoRefs;     // auto- 课程 -> 引用它的课表数
+    QSet<QString> m_unreferenced;       // 计数降为 0（或从未被引用）、等待移除的 auto- 课程
+    StringPool *m_strings;
+};
+
+#endif // COURSECATALOG_H
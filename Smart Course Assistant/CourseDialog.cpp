@@ -1,5 +1,6 @@
 #include "CourseDialog.h"
 #include "ui_CourseDialog.h"
+#include "TraceRecorder.h"
 #include "ScheduleManager.h"
 #include <QColorDialog>
 #include <QMessageBox>
@@ -8,6 +9,7 @@ CourseDialog::CourseDialog(QWidget *parent) :
     QDialog(parent),
     ui(new Ui::CourseDialog)
 {
+    TRACE_SCOPE_CAT("CourseDialog::CourseDialog", "dialog");
     ui->setupUi(this);
 
     // 初始化UI
@@ -42,6 +44,11 @@ void CourseDialog::setupUi()
         ui->comboEnd->addItem(QString::number(i), i);
     }
 
+    // 设置周次下拉框
+    ui->comboWeeks->addItem(Course::weekParityText(Course::EveryWeek), Course::EveryWeek);
+    ui->comboWeeks->addItem(Course::weekParityText(Course::OddWeeks), Course::OddWeeks);
+    ui->comboWeeks->addItem(Course::weekParityText(Course::EvenWeeks), Course::EvenWeeks);
+
     // 默认颜色
     m_color = QColor(100, 150, 255);
     updateColorButton();
@@ -61,6 +68,7 @@ void CourseDialog::setCourse(const Course &course)
     ui->editClassroom->setText(course.classroom());
     ui->editTeacher->setText(course.teacher());
     ui->editNote->setPlainText(course.note());
+    ui->comboWeeks->setCurrentIndex(ui->comboWeeks->findData(course.weekParity()));
     m_color = course.color();
     updateColorButton();
 }
@@ -77,6 +85,7 @@ Course CourseDialog::getCourse() const
     course.setTeacher(ui->editTeacher->text().trimmed());
     course.setNote(ui->editNote->toPlainText().trimmed());
     course.setColor(m_color);
+    course.setWeekParity(ui->comboWeeks->currentData().toInt());
     return course;
 }
 
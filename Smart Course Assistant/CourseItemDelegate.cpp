@@ -0,0 +1,78 @@
+#include "CourseItemDelegate.h"
+#include <QPainter>
+#include <QTextOption>
+
+namespace {
+const int TEXT_MARGIN = 4;
+}
+
+CourseItemDelegate::CourseItemDelegate(CourseTableModel *model, QObject *parent)
+    : QStyledItemDelegate(parent),
+    m_model(model)
+{
+}
+
+void CourseItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                               const QModelIndex &index) const
+{
+    const QVector<const CourseTableModel::Block*> blocks = m_model->blocksAt(index.row(), index.column());
+    if (blocks.isEmpty()) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    painter->save();
+    painter->setFont(option.font);
+    painter->setPen(option.palette.color(QPalette::Text));
+
+    // 共用单元格的课程（如交替上课的单双周课程）上下平分单元格，各自用自己的颜色
+    int top = option.rect.top();
+    for (int i = 0; i < blocks.size(); ++i) {
+        int bottom = option.rect.top() + option.rect.height() * (i + 1) / blocks.size();
+        QRect band(option.rect.left(), top, option.rect.width(), bottom - top);
+        paintBlock(painter, option, *blocks.at(i), band);
+        if (i > 0) {
+            painter->drawLine(band.topLeft(), band.topRight());
+        }
+        top = bottom;
+    }
+
+    if (option.state & QStyle::State_Selected) {
+        QColor highlight = option.palette.highlight().color();
+        highlight.setAlpha(90);
+        painter->fillRect(option.rect, highlight);
+    }
+    painter->restore();
+}
+
+void CourseItemDelegate::paintBlock(QPainter *painter, const QStyleOptionViewItem &option,
+                                    const CourseTableModel::Block &block, const QRect &rect) const
+{
+    painter->fillRect(rect, block.brush);
+
+    // 文本排版按块宽度和字体缓存，列宽变化或主题、DPI 改变字体时才重新排版
+    int textWidth = qMax(1, rect.width() - 2 * TEXT_MARGIN);
+    if (block.layoutWidth != textWidth || block.layoutFont != option.font) {
+        QTextOption textOption;
+        textOption.setAlignment(Qt::AlignHCenter);
+        textOption.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere);
+
+        block.staticText.setTextFormat(Qt::PlainText);
+        // 纯文本排版不识别 '\n'，换成行分隔符
+        block.staticText.setText(QString(block.text).replace('\n', QChar::LineSeparator));
+        block.staticText.setTextOption(textOption);
+        block.staticText.setTextWidth(textWidth);
+        block.staticText.prepare(painter->transform(), option.font);
+        block.layoutWidth = textWidth;
+        block.layoutFont = option.font;
+    }
+
+    QSizeF textSize = block.staticText.size();
+    QPointF topLeft(rect.left() + TEXT_MARGIN,
+                    rect.top() + qMax(0.0, (rect.height() - textSize.height()) / 2));
+
+    painter->save();
+    painter->setClipRect(rect);
+    painter->drawStaticText(topLeft, block.staticText);
+    painter->restore();
+}
@@ -0,0 +1,24 @@
+#ifndef COURSEITEMDELEGATE_H
+#define COURSEITEMDELEGATE_H
+
+#include <QStyledItemDelegate>
+#include "CourseTableModel.h"
+
+// 课程块绘制：直接使用模型中缓存的画刷和文本排版，不再逐次生成单元格项
+class CourseItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+public:
+    explicit CourseItemDelegate(CourseTableModel *model, QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+
+private:
+    void paintBlock(QPainter *painter, const QStyleOptionViewItem &option,
+                    const CourseTableModel::Block &block, const QRect &rect) const;
+
+    CourseTableModel *m_model;
+};
+
+#endif // COURSEITEMDELEGATE_H
@@ -0,0 +1,334 @@
+#include "CourseTableModel.h"
+#include "TraceRecorder.h"
+#include "MemoryStats.h"
+#include <QDebug>
+#include <algorithm>
+#include <utility>
+
+namespace {
+const int DAYS_PER_WEEK = 7;
+}
+
+CourseTableModel::CourseTableModel(ScheduleManager *scheduleManager, QObject *parent)
+    : QAbstractTableModel(parent),
+    m_scheduleManager(scheduleManager),
+    m_rows(ScheduleManager::getSectionTimes().size())
+{
+    m_groups.resize(DAYS_PER_WEEK);
+    m_cells.fill(-1, m_rows * DAYS_PER_WEEK);
+
+    // 表头文本只生成一次
+    m_dayHeaders << "周一" << "周二" << "周三" << "周四" << "周五" << "周六" << "周日";
+    for (int i = 0; i < m_rows; ++i) {
+        int section = i + 1;
+        m_sectionHeaders << QString("第%1节\n%2-%3")
+                                .arg(section)
+                                .arg(ScheduleManager::getSectionStartTime(section).toString("hh:mm"))
+                                .arg(ScheduleManager::getSectionEndTime(section).toString("hh:mm"));
+    }
+
+    if (!m_scheduleManager) return;
+
+    connect(m_scheduleManager, &ScheduleManager::coursesInserted, this, &CourseTableModel::onCoursesInserted);
+    connect(m_scheduleManager, &ScheduleManager::courseEdited, this, &CourseTableModel::onCourseEdited);
+    connect(m_scheduleManager, &ScheduleManager::coursesRemoved, this, &CourseTableModel::onCoursesRemoved);
+    connect(m_scheduleManager, &ScheduleManager::coursesReset, this, &CourseTableModel::reload);
+}
+
+int CourseTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows;
+}
+
+int CourseTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : DAYS_PER_WEEK;
+}
+
+QVariant CourseTableModel::data(const QModelIndex &index, int role) const
+{
+    const Group *group = groupAt(index.row(), index.column());
+    if (!group) {
+        return QVariant();
+    }
+    const Block &block = *m_blocks.constFind(group->courses.first());
+
+    switch (role) {
+    case Qt::DisplayRole: {
+        if (group->courses.size() == 1) {
+            return block.text;
+        }
+        QStringList texts;
+        for (Course *course : group->courses) {
+            texts << m_blocks.constFind(course)->text;
+        }
+        return texts.join("\n\n");
+    }
+    case Qt::BackgroundRole:
+        return block.brush;
+    case Qt::TextAlignmentRole:
+        return int(Qt::AlignCenter);
+    case CourseRole:
+        return QVariant::fromValue(block.course);
+    default:
+        return QVariant();
+    }
+}
+
+QVariant CourseTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    if (orientation == Qt::Horizontal) {
+        return section >= 0 && section < m_dayHeaders.size() ? m_dayHeaders.at(section) : QVariant();
+    }
+    return section >= 0 && section < m_sectionHeaders.size() ? m_sectionHeaders.at(section) : QVariant();
+}
+
+const CourseTableModel::Group *CourseTableModel::groupAt(int row, int column) const
+{
+    if (row < 0 || row >= m_rows || column < 0 || column >= DAYS_PER_WEEK) {
+        return nullptr;
+    }
+    int group = m_cells.at(row * DAYS_PER_WEEK + column);
+    return group < 0 ? nullptr : &m_groups.at(column).at(group);
+}
+
+QVector<const CourseTableModel::Block*> CourseTableModel::blocksAt(int row, int column) const
+{
+    QVector<const Block*> blocks;
+    if (const Group *group = groupAt(row, column)) {
+        blocks.reserve(group->courses.size());
+        for (Course *course : group->courses) {
+            blocks.append(&m_blocks.constFind(course).value());
+        }
+    }
+    return blocks;
+}
+
+QList<Course*> CourseTableModel::coursesAt(const QModelIndex &index) const
+{
+    const Group *group = groupAt(index.row(), index.column());
+    return group ? QList<Course*>(group->courses.begin(), group->courses.end()) : QList<Course*>();
+}
+
+void CourseTableModel::reload()
+{
+    TRACE_SCOPE_CAT("CourseTableModel::reload", "model");
+    MemoryStats::Scope memoryScope(MemoryStats::Models);
+    beginResetModel();
+    m_blocks.clear();
+    QVector<QVector<Course*>> columns(DAYS_PER_WEEK);
+    if (m_scheduleManager) {
+        for (Course *course : m_scheduleManager->getAllCourses()) {
+            Block block;
+            if (makeBlock(course, block)) {
+                m_blocks.insert(course, block);
+                columns[block.column].append(course);
+            }
+        }
+    }
+    for (int column = 0; column < DAYS_PER_WEEK; ++column) {
+        layoutColumn(column, columns.at(column));
+    }
+    endResetModel();
+
+    emit spansReset();
+    for (int column = 0; column < DAYS_PER_WEEK; ++column) {
+        for (const Group &group : m_groups.at(column)) {
+            if (group.rowSpan > 1) {
+                emit spanChanged(group.row, column, group.rowSpan);
+            }
+        }
+    }
+}
+
+// 新课程按列归并，每列只重新分组一次
+void CourseTableModel::onCoursesInserted(int first, int last)
+{
+    const QList<Course*> &courses = m_scheduleManager->getAllCourses();
+    QVector<QVector<Course*>> added(DAYS_PER_WEEK);
+    for (int i = first; i <= last; ++i) {
+        Block block;
+        if (!makeBlock(courses.value(i), block)) {
+            continue;
+        }
+        m_blocks.insert(block.course, block);
+        added[block.column].append(block.course);
+    }
+    for (int column = 0; column < DAYS_PER_WEEK; ++column) {
+        if (!added.at(column).isEmpty()) {
+            updateColumn(column, added.at(column));
+        }
+    }
+}
+
+// 编辑课程：位置未变时只重绘所在单元格，否则重新分组旧列和新列
+void CourseTableModel::onCourseEdited(int index)
+{
+    Course *course = m_scheduleManager->getAllCourses().value(index);
+    if (!course) return;
+
+    auto it = m_blocks.find(course);
+    int oldColumn = it == m_blocks.end() ? -1 : it->column;
+
+    Block block;
+    if (!makeBlock(course, block)) {
+        if (oldColumn >= 0) {
+            m_blocks.erase(it);
+            updateColumn(oldColumn);
+        }
+        return;
+    }
+
+    if (it != m_blocks.end() && it->row == block.row &&
+        it->column == block.column && it->rowSpan == block.rowSpan) {
+        *it = block;
+        const Group *group = groupAt(block.row, block.column);
+        QModelIndex topLeft = this->index(group ? group->row : block.row, block.column);
+        emit dataChanged(topLeft, topLeft);
+        return;
+    }
+
+    m_blocks.insert(course, block);
+    if (oldColumn >= 0 && oldColumn != block.column) {
+        updateColumn(oldColumn);
+    }
+    updateColumn(block.column, oldColumn == block.column ? QVector<Course*>() : QVector<Course*>{course});
+}
+
+void CourseTableModel::onCoursesRemoved(const QList<Course*> &courses)
+{
+    bool touched[DAYS_PER_WEEK] = {};
+    for (Course *course : courses) {
+        auto it = m_blocks.find(course);
+        if (it == m_blocks.end()) continue;
+        touched[it->column] = true;
+        m_blocks.erase(it);
+    }
+    for (int column = 0; column < DAYS_PER_WEEK; ++column) {
+        if (touched[column]) {
+            updateColumn(column);
+        }
+    }
+}
+
+// 生成课程块并缓存显示文本与画刷
+bool CourseTableModel::makeBlock(Course *course, Block &block) const
+{
+    if (!course) return false;
+
+    int startSection = course->startSection();
+    int endSection = course->endSection();
+    if (startSection < 1 || endSection < startSection || endSection > m_rows) {
+        qWarning() << "无效的节次范围:" << startSection << "-" << endSection;
+        return false;
+    }
+
+    int column = course->dayOfWeek() - 1;
+    if (column < 0 || column >= DAYS_PER_WEEK) {
+        qWarning() << "无效的表格位置:" << startSection - 1 << "," << column;
+        return false;
+    }
+
+    block.course = course;
+    block.row = startSection - 1;
+    block.column = column;
+    block.rowSpan = endSection - startSection + 1;
+    block.text = course->displayText();
+    block.brush = QBrush(course->color());
+    block.layoutWidth = -1;
+    return true;
+}
+
+// 列中仍然留在该列的课程（已删除或已移到别的列的课程被跳过）
+QVector<Course*> CourseTableModel::columnCourses(int column) const
+{
+    QVector<Course*> courses;
+    for (const Group &group : m_groups.at(column)) {
+        for (Course *course : group.courses) {
+            auto it = m_blocks.constFind(course);
+            if (it != m_blocks.constEnd() && it->column == column) {
+                courses.append(course);
+            }
+        }
+    }
+    return courses;
+}
+
+// 按起始节次排序后把时间重叠的块合并成组，并重建该列的单元格索引
+void CourseTableModel::layoutColumn(int column, QVector<Course*> courses)
+{
+    std::stable_sort(courses.begin(), courses.end(), [this](Course *a, Course *b) {
+        return m_blocks.constFind(a)->row < m_blocks.constFind(b)->row;
+    });
+
+    QVector<Group> &groups = m_groups[column];
+    groups.clear();
+    for (Course *course : std::as_const(courses)) {
+        const Block &block = *m_blocks.constFind(course);
+        if (groups.isEmpty() || block.row >= groups.last().row + groups.last().rowSpan) {
+            Group group;
+            group.row = block.row;
+            group.rowSpan = block.rowSpan;
+            groups.append(group);
+        }
+        Group &group = groups.last();
+        group.rowSpan = qMax(group.rowSpan, block.row + block.rowSpan - group.row);
+        group.courses.append(course);
+    }
+
+    for (int r = 0; r < m_rows; ++r) {
+        m_cells[r * DAYS_PER_WEEK + column] = -1;
+    }
+    for (int i = 0; i < groups.size(); ++i) {
+        for (int r = groups.at(i).row; r < groups.at(i).row + groups.at(i).rowSpan; ++r) {
+            m_cells[r * DAYS_PER_WEEK + column] = i;
+        }
+    }
+}
+
+// 重新分组一列，只对起止行变化的组通知跨行，再重绘该列
+void CourseTableModel::updateColumn(int column, const QVector<Course*> &added)
+{
+    const QVector<Group> old = m_groups.at(column);
+    layoutColumn(column, columnCourses(column) + added);
+    const QVector<Group> &groups = m_groups.at(column);
+
+    auto contains = [](const QVector<Group> &list, const Group &group) {
+        return std::any_of(list.begin(), list.end(), [&group](const Group &other) {
+            return other.row == group.row && other.rowSpan == group.rowSpan;
+        });
+    };
+    // 先取消旧的跨行，再设置新的跨行，避免新旧跨行区域重叠
+    for (const Group &group : old) {
+        if (group.rowSpan > 1 && !contains(groups, group)) {
+            emit spanChanged(group.row, column, 1);
+        }
+    }
+    for (const Group &group : groups) {
+        if (group.rowSpan > 1 && !contains(old, group)) {
+            emit spanChanged(group.row, column, group.rowSpan);
+        }
+    }
+    emit dataChanged(index(0, column), index(m_rows - 1, column));
+}
+
+void CourseTableModel::reportMemory(MemoryReport &report) const
+{
+    // 排版缓存 QStaticText 的内部数据不公开，不计入
+    qint64 stringBytes = 0;
+    for (const Block &block : m_blocks) {
+        stringBytes += MemoryStats::stringBytes(block.text);
+    }
+    qint64 bytes = MemoryStats::nodeBytes(m_blocks, sizeof(Course*) + sizeof(Block))
+                   + MemoryStats::vectorBytes(m_cells) + MemoryStats::vectorBytes(m_groups) + stringBytes;
+    for (const QVector<Group> &groups : m_groups) {
+        bytes += MemoryStats::vectorBytes(groups);
+        for (const Group &group : groups) {
+            bytes += MemoryStats::vectorBytes(group.courses);
+        }
+    }
+    report.add("课程表格项", m_blocks.size(), bytes, stringBytes);
+}
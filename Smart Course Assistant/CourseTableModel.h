@@ -0,0 +1,88 @@
+#ifndef COURSETABLEMODEL_H
+#define COURSETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QBrush>
+#include <QFont>
+#include <QHash>
+#include <QStaticText>
+#include <QStringList>
+#include <QVector>
+#include "ScheduleManager.h"
+
+class MemoryReport;
+
+// 课程表模型：行为节次、列为星期，每门课程占据一个跨行的块
+// 同一列时间重叠的块（如交替上课的单双周课程）合并成一个跨行单元格，由委托上下分开绘制
+// 块的显示文本和背景画刷只在课程变化时计算一次，由 CourseItemDelegate 绘制
+class CourseTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Roles {
+        CourseRole = Qt::UserRole    // 返回 Course* 指针
+    };
+
+    struct Block {
+        Course *course = nullptr;
+        int row = 0;              // 起始行（节次-1）
+        int column = 0;           // 列（星期-1）
+        int rowSpan = 1;
+        QString text;             // 缓存的显示文本
+        QBrush brush;             // 缓存的背景画刷
+        mutable QStaticText staticText;   // 按宽度和字体缓存的文本排版
+        mutable int layoutWidth = -1;
+        mutable QFont layoutFont;
+    };
+
+    explicit CourseTableModel(ScheduleManager *scheduleManager, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    // 单元格中的课程块，按起始节次排列（被跨行覆盖的单元格也返回所属块）
+    QVector<const Block*> blocksAt(int row, int column) const;
+    QList<Course*> coursesAt(const QModelIndex &index) const;
+
+    // 重新读取全部课程，并重新发出所有跨行信息
+    void reload();
+
+    // 课程块与单元格索引的内存估算
+    void reportMemory(MemoryReport &report) const;
+
+signals:
+    void spansReset();
+    void spanChanged(int row, int column, int rowSpan);
+
+private slots:
+    void onCoursesInserted(int first, int last);
+    void onCourseEdited(int index);
+    void onCoursesRemoved(const QList<Course*> &courses);
+
+private:
+    // 一列中时间相互重叠的课程块，整体作为一个跨行单元格
+    struct Group {
+        int row = 0;
+        int rowSpan = 1;
+        QVector<Course*> courses;     // 按起始节次排列
+    };
+
+    bool makeBlock(Course *course, Block &block) const;
+    const Group *groupAt(int row, int column) const;
+    QVector<Course*> columnCourses(int column) const;
+    void layoutColumn(int column, QVector<Course*> courses);
+    void updateColumn(int column, const QVector<Course*> &added = QVector<Course*>());
+
+    ScheduleManager *m_scheduleManager;
+    int m_rows;
+    QHash<Course*, Block> m_blocks;
+    QVector<QVector<Group>> m_groups; // 每列的单元格组，按起始行排列
+    QVector<int> m_cells;             // 每个单元格所属的组在该列中的下标，按 row * 7 + column 存放，-1 为空
+    QStringList m_dayHeaders;
+    QStringList m_sectionHeaders;
+};
+
+#endif // COURSETABLEMODEL_H
@@ -0,0 +1,86 @@
+#include "DataFileReader.h"
+#include <QDebug>
+#include <QFile>
+#include <QIODevice>
+#include <QtEndian>
+
+DataFileReader::DataFileReader(QIODevice *device)
+    : m_device(device),
+    m_in(device)
+{
+    m_in.setVersion(QDataStream::Qt_5_15);
+}
+
+qint64 DataFileReader::remaining() const
+{
+    return m_device->bytesAvailable();
+}
+
+quint32 DataFileReader::checkedCount(quint32 declared, qint64 minRecordBytes)
+{
+    qint64 capacity = remaining() / qMax<qint64>(1, minRecordBytes);
+    if (qint64(declared) <= capacity) {
+        return declared;
+    }
+    fail(QString("记录数 %1 超出文件长度（最多 %2 条）").arg(declared).arg(capacity));
+    return quint32(capacity);
+}
+
+// 与 QDataStream 的 QString 编码一致：quint32 字节数（0xFFFFFFFF 为空字符串）+ UTF-16
+bool DataFileReader::readString(QString &text)
+{
+    quint32 bytes = 0;
+    m_in >> bytes;
+    if (!checkStatus("字符串长度")) {
+        return false;
+    }
+    if (bytes == 0xFFFFFFFF) {
+        text = QString();
+        return true;
+    }
+    if ((bytes & 1) || qint64(bytes) > remaining()) {
+        fail(QString("字符串长度 %1 无效（剩余 %2 字节）").arg(bytes).arg(remaining()));
+        return false;
+    }
+
+    QByteArray raw(int(bytes), Qt::Uninitialized);
+    if (m_in.readRawData(raw.data(), raw.size()) != raw.size()) {
+        fail("字符串数据不完整");
+        return false;
+    }
+    text.resize(raw.size() / 2);
+    if (m_in.byteOrder() == QDataStream::BigEndian) {
+        qFromBigEndian<quint16>(raw.constData(), text.size(), text.data());
+    } else {
+        qFromLittleEndian<quint16>(raw.constData(), text.size(), text.data());
+    }
+    return true;
+}
+
+bool DataFileReader::checkStatus(const QString &what)
+{
+    if (m_in.status() == QDataStream::Ok) {
+        return true;
+    }
+    fail(QString("读取%1时出错（偏移 %2）").arg(what).arg(m_device->pos()));
+    return false;
+}
+
+// 只保留第一个错误，后续错误通常是它的连带结果
+void DataFileReader::fail(const QString &reason)
+{
+    if (m_error.isEmpty()) {
+        m_error = reason;
+    }
+}
+
+void DataFileReader::preserveDamagedFile(const QString &filePath)
+{
+    QString backup = filePath + ".corrupt";
+    QFile::remove(backup);
+    if (QFile::copy(filePath, backup)) {
+        qWarning() << "已将损坏的数据文件另存为:" << backup;
+    } else {
+        qWarning() << "无法备份损坏的数据文件:" << backup;
+    }
+}
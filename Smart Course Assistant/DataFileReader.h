@@ -0,0 +1,45 @@
+#ifndef DATAFILEREADER_H
+#define DATAFILEREADER_H
+
+#include <QDataStream>
+#include <QString>
+
+class QIODevice;
+
+// 数据文件的受限读取：记录数和字符串长度先与剩余字节数比较再分配
+// 损坏或截断的文件不会导致按虚假长度分配内存，总分配量以文件大小为上限
+// 出错后停止读取，调用方保留此前已通过校验的记录
+class DataFileReader
+{
+public:
+    explicit DataFileReader(QIODevice *device);
+
+    QDataStream &stream() { return m_in; }
+    qint64 remaining() const;
+
+    // 按最小记录长度校验声明的记录数，放不下时截短到文件能容纳的数量
+    quint32 checkedCount(quint32 declared, qint64 minRecordBytes);
+    bool readString(QString &text);
+    // 流出错（如读到文件末尾）时记下出错位置并返回 false
+    bool checkStatus(const QString &what);
+    void fail(const QString &reason);
+
+    bool hasError() const { return !m_error.isEmpty(); }
+    QString error() const { return m_error; }
+
+    // 把损坏的数据文件另存为 .corrupt，避免下次保存时覆盖掉没能读出的部分
+    static void preserveDamagedFile(const QString &filePath);
+
+    // QDataStream 中各类型的编码长度，用于计算最小记录长度
+    static const qint64 STRING_HEADER_BYTES = 4;
+    static const qint64 COLOR_BYTES = 11;    // qint8 spec + 5 × quint16
+    static const qint64 DATE_BYTES = 8;      // qint64 儒略日
+    static const qint64 TIME_BYTES = 4;
+
+private:
+    QIODevice *m_device;
+    QDataStream m_in;
+    QString m_error;
+};
+
+#endif // DATAFILEREADER_H
@@ -0,0 +1,91 @@
+#include "DeadlineIndex.h"
+#include "MemoryStats.h"
+
+DeadlineIndex::DeadlineIndex(TaskManager *taskManager, QObject *parent)
+    : QObject(parent),
+    m_taskManager(taskManager)
+{
+    if (m_taskManager) {
+        connect(m_taskManager, &TaskManager::tasksInserted, this, [this](int first, int last) {
+            const QList<Task*> &tasks = m_taskManager->getAllTasks();
+            for (int i = first; i <= last; ++i) insertTask(tasks.at(i));
+        });
+        connect(m_taskManager, &TaskManager::tasksAboutToBeRemoved, this, [this](int first, int last) {
+            const QList<Task*> &tasks = m_taskManager->getAllTasks();
+            for (int i = first; i <= last; ++i) removeTask(tasks.at(i));
+        });
+        connect(m_taskManager, &TaskManager::taskUpdated, this, [this](int, Task *task) {
+            removeTask(task);
+            insertTask(task);
+        });
+        connect(m_taskManager, &TaskManager::tasksReset, this, &DeadlineIndex::rebuild);
+    }
+    rebuild();
+}
+
+QVector<Task*> DeadlineIndex::tasksOn(const QDate &date) const
+{
+    return m_byDate.value(date);
+}
+
+QVector<Task*> DeadlineIndex::tasksBetween(const QDate &from, const QDate &to) const
+{
+    QVector<Task*> result;
+    for (auto it = m_byDate.lowerBound(from); it != m_byDate.end() && it.key() <= to; ++it) {
+        result += it.value();
+    }
+    return result;
+}
+
+void DeadlineIndex::insertTask(Task *task)
+{
+    if (!task || !task->dueDate().isValid()) return;
+
+    QDate date = task->dueDate();
+    m_byDate[date].append(task);
+    m_taskDates.insert(task, date);
+    emit dateChanged(date);
+}
+
+void DeadlineIndex::removeTask(Task *task)
+{
+    auto it = m_taskDates.find(task);
+    if (it == m_taskDates.end()) return;
+
+    QDate date = it.value();
+    m_taskDates.erase(it);
+
+    auto dateIt = m_byDate.find(date);
+    if (dateIt != m_byDate.end()) {
+        dateIt.value().removeOne(task);
+        if (dateIt.value().isEmpty()) {
+            m_byDate.erase(dateIt);
+        }
+    }
+    emit dateChanged(date);
+}
+
+void DeadlineIndex::rebuild()
+{
+    m_byDate.clear();
+    m_taskDates.clear();
+    if (m_taskManager) {
+        for (Task *task : m_taskManager->getAllTasks()) {
+            if (task && task->dueDate().isValid()) {
+                m_byDate[task->dueDate()].append(task);
+                m_taskDates.insert(task, task->dueDate());
+            }
+        }
+    }
+    emit reset();
+}
+
+void DeadlineIndex::reportMemory(MemoryReport &report) const
+{
+    qint64 bytes = MemoryStats::nodeBytes(m_byDate, sizeof(QDate) + sizeof(QVector<Task*>))
+                   + MemoryStats::nodeBytes(m_taskDates, sizeof(Task*) + sizeof(QDate));
+    for (const QVector<Task*> &tasks : m_byDate) {
+        bytes += MemoryStats::vectorBytes(tasks);
+    }
+    report.add("截止日期索引", m_taskDates.size(), bytes);
+}
@@ -0,0 +1,41 @@
+#ifndef DEADLINEINDEX_H
+#define DEADLINEINDEX_H
+
+#include <QObject>
+#include <QDate>
+#include <QHash>
+#include <QMap>
+#include <QVector>
+#include "TaskManager.h"
+
+class MemoryReport;
+
+// 截止日期索引：按日期分组的任务，随 TaskManager 的细粒度信号增量维护
+class DeadlineIndex : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DeadlineIndex(TaskManager *taskManager, QObject *parent = nullptr);
+
+    QVector<Task*> tasksOn(const QDate &date) const;
+    QVector<Task*> tasksBetween(const QDate &from, const QDate &to) const;
+    int size() const { return m_taskDates.size(); }
+
+    void reportMemory(MemoryReport &report) const;
+
+signals:
+    // 某个日期上的任务发生变化
+    void dateChanged(const QDate &date);
+    void reset();
+
+private:
+    void insertTask(Task *task);
+    void removeTask(Task *task);
+    void rebuild();
+
+    TaskManager *m_taskManager;
+    QMap<QDate, QVector<Task*>> m_byDate;
+    QHash<Task*, QDate> m_taskDates;    // 任务当前所在的日期，用于更新时移除旧位置
+};
+
+#endif // DEADLINEINDEX_H
@@ -0,0 +1,118 @@
+#include "IconCache.h"
+#include "MemoryStats.h"
+#include <QGuiApplication>
+#include <QHash>
+#include <QImageReader>
+#include <QPixmapCache>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+// 表格和菜单中常用的逻辑尺寸，预先解码
+const int COMMON_SIZES[] = { 16, 24, 32 };
+
+QHash<QString, QIcon> &iconTable()
+{
+    static QHash<QString, QIcon> table;
+    return table;
+}
+
+IconCache::Stats &statsRef()
+{
+    static IconCache::Stats stats;
+    return stats;
+}
+}
+
+// 返回共享的 QIcon，同一名称只构造一次
+QIcon IconCache::icon(const QString &name)
+{
+    ++statsRef().iconLookups;
+
+    QHash<QString, QIcon> &table = iconTable();
+    auto it = table.constFind(name);
+    if (it != table.constEnd()) {
+        return it.value();
+    }
+
+    QIcon icon;
+    qreal dpr = currentDevicePixelRatio();
+    for (int size : COMMON_SIZES) {
+        QPixmap pm = pixmap(name, QSize(size, size), dpr);
+        if (!pm.isNull()) {
+            icon.addPixmap(pm);
+        }
+    }
+    // 其他尺寸由 QIcon 按需从原始文件缩放
+    icon.addFile(":/icons/" + name);
+
+    table.insert(name, icon);
+    return icon;
+}
+
+QPixmap IconCache::pixmap(const QString &name, const QSize &size, qreal devicePixelRatio)
+{
+    QString key = QString("icon:%1@%2x%3@%4")
+                      .arg(name)
+                      .arg(size.width())
+                      .arg(size.height())
+                      .arg(devicePixelRatio);
+
+    QPixmap pm;
+    if (QPixmapCache::find(key, &pm)) {
+        ++statsRef().pixmapHits;
+        return pm;
+    }
+
+    MemoryStats::Scope memoryScope(MemoryStats::Icons);
+    QElapsedTimer timer;
+    timer.start();
+
+    // 直接按目标像素尺寸解码，避免先解码大图再缩放
+    QImageReader reader(":/icons/" + name);
+    QSize pixelSize = size * devicePixelRatio;
+    if (reader.size().isValid()) {
+        reader.setScaledSize(reader.size().scaled(pixelSize, Qt::KeepAspectRatio));
+    }
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "无法加载图标:" << name << reader.errorString();
+        return QPixmap();
+    }
+
+    pm = QPixmap::fromImage(image);
+    pm.setDevicePixelRatio(devicePixelRatio);
+    QPixmapCache::insert(key, pm);
+
+    ++statsRef().pixmapDecodes;
+    statsRef().decodeNsecs += timer.nsecsElapsed();
+    statsRef().decodedBytes += image.sizeInBytes();
+    return pm;
+}
+
+IconCache::Stats IconCache::stats()
+{
+    return statsRef();
+}
+
+void IconCache::resetStats()
+{
+    statsRef() = Stats();
+}
+
+void IconCache::reportMemory(MemoryReport &report)
+{
+    const Stats &stats = statsRef();
+    qint64 stringBytes = 0;
+    for (auto it = iconTable().cbegin(); it != iconTable().cend(); ++it) {
+        stringBytes += MemoryStats::stringBytes(it.key());
+    }
+    qint64 bytes = MemoryStats::nodeBytes(iconTable(), sizeof(QString) + sizeof(QIcon))
+                   + stats.decodedBytes + stringBytes;
+    report.add("图标缓存", stats.pixmapDecodes, bytes, stringBytes);
+}
+
+qreal IconCache::currentDevicePixelRatio()
+{
+    return qApp ? qApp->devicePixelRatio() : 1.0;
+}
@@ -0,0 +1,37 @@
+#ifndef ICONCACHE_H
+#define ICONCACHE_H
+
+#include <QIcon>
+#include <QPixmap>
+#include <QSize>
+#include <QString>
+
+class MemoryReport;
+
+// 共享图标缓存：每个图标在每种尺寸和设备像素比下只解码一次
+// name 为资源别名，例如 "checked" 对应 ":/icons/checked"
+class IconCache
+{
+public:
+    struct Stats {
+        int iconLookups = 0;     // icon() 调用次数
+        int pixmapHits = 0;      // 命中已解码的位图
+        int pixmapDecodes = 0;   // 实际解码次数
+        qint64 decodeNsecs = 0;  // 解码累计耗时
+        qint64 decodedBytes = 0; // 解码得到的位图字节数（可能已被 QPixmapCache 淘汰一部分）
+    };
+
+    static QIcon icon(const QString &name);
+    static QPixmap pixmap(const QString &name, const QSize &size, qreal devicePixelRatio);
+
+    static Stats stats();
+    static void resetStats();
+
+    // 共享图标表与已解码位图的内存估算
+    static void reportMemory(MemoryReport &report);
+
+private:
+    static qreal currentDevicePixelRatio();
+};
+
+#endif // ICONCACHE_H
@@ -3,50 +3,82 @@
 #include "CourseDialog.h"
 #include "TaskDialog.h"
 #include "ReminderDialog.h"
+#include "SemesterDialog.h"
 #include "ScheduleManager.h"
+#include "CourseItemDelegate.h"
+#include "IconCache.h"
+#include "CalendarDialog.h"
+#include "UndoCommands.h"
+#include "ProfileImporter.h"
+#include "TraceRecorder.h"
+#include "MemoryDialog.h"
+#include "ApiServer.h"
+#include "ScheduleApiHandler.h"
 #include <QSettings>
 #include <QMessageBox>
 #include <QCloseEvent>
 #include <QTimer>
 #include <QHeaderView>
-#include <QTableWidgetItem>
 #include <QBrush>
 #include <QInputDialog>
+#include <QFileDialog>
+#include <QShortcut>
+#include <QCommandLineParser>
 
 // 节次时间表
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
     , m_settings(nullptr)
+    , m_themeManager(nullptr)
     , m_scheduleManager(nullptr)
     , m_taskManager(nullptr)
+    , m_taskModel(nullptr)
+    , m_taskProxy(nullptr)
+    , m_courseModel(nullptr)
+    , m_timeline(nullptr)
+    , m_deadlineIndex(nullptr)
+    , m_calendarDialog(nullptr)
+    , m_memoryDialog(nullptr)
+    , m_apiServer(nullptr)
+    , m_apiHandler(nullptr)
+    , m_undoStack(nullptr)
     , m_notification(nullptr)
     , m_trayIcon(nullptr)
 {
+    TRACE_SCOPE("MainWindow::MainWindow");
     ui->setupUi(this);
-    setWindowIcon(QIcon(":/icons/app_icon"));
+    setWindowIcon(IconCache::icon("app_icon"));
 
     try {
         // 按正确顺序初始化
         m_settings = new Settings(this);
-        m_scheduleManager = new ScheduleManager(this);
+        m_themeManager = new ThemeManager(this);
+        m_themeManager->apply(m_settings->theme());
+        m_scheduleManager = new ScheduleManager(ScheduleManager::DeferLoad, this);   // 下面统一加载
         m_taskManager = new TaskManager(this);
+        m_undoStack = new QUndoStack(this);
 
         // 确保在创建 Notification 前 ScheduleManager 已初始化
         if (m_scheduleManager) {
             m_notification = new Notification(m_scheduleManager, this);
+            m_notification->setTaskManager(m_taskManager);
         } else {
             qCritical() << "Failed to create ScheduleManager";
             return;
         }
 
+        // 日历使用的索引需要在加载数据前建立，以便接收重置信号
+        m_timeline = new OccurrenceTimeline(m_scheduleManager, this);
+        applySemester();
+        m_deadlineIndex = new DeadlineIndex(m_taskManager, this);
+
         // 加载数据
         m_scheduleManager->loadCourses();
         m_taskManager->loadTasks();
 
         // 初始化通知系统
         if (m_notification) {
-            m_notification->resetNotifications();
             int savedMinutes = m_settings->reminderMinutes();
             m_notification->setReminderMinutes(savedMinutes);
         }
@@ -68,10 +100,13 @@ MainWindow::MainWindow(QWidget *parent)
         updateTimer->start(60 * 1000);
 
         // 首次更新
-        updateCourseTable();
-        updateTaskList();
         updateCurrentCourse();
 
+        // 本地查询接口在后台线程读取快照，不影响界面
+        if (m_settings->isApiEnabled()) {
+            setApiEnabled(true, false);
+        }
+
     } catch (const std::exception& e) {
         qCritical() << "初始化失败:" << e.what();
         QMessageBox::critical(this, "致命错误", "程序初始化失败，请重启应用。");
@@ -80,6 +115,11 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+    // 先停止查询接口，服务线程仍在读取管理器的快照
+    if (m_apiServer) {
+        m_apiServer->stop();
+    }
+
     // 保存设置
     if (m_settings) {
         m_settings->setWindowGeometry(saveGeometry());
@@ -95,29 +135,17 @@ MainWindow::~MainWindow()
 // 初始化课程表
 void MainWindow::setupCourseTable()
 {
-    // 使用 ScheduleManager 获取节次数
-    int sectionCount = ScheduleManager::getSectionTimes().size();
-    ui->courseTable->setRowCount(sectionCount);
-    ui->courseTable->setColumnCount(7); // 周一至周日
-
-    // 设置表头
-    QStringList headers;
-    headers << "周一" << "周二" << "周三" << "周四" << "周五" << "周六" << "周日";
-    ui->courseTable->setHorizontalHeaderLabels(headers);
-
-    // 设置行头（节次和时间）
-    for (int i = 0; i < sectionCount; ++i) {
-        int section = i + 1;
-        QTime startTime = ScheduleManager::getSectionStartTime(section);
-        QTime endTime = ScheduleManager::getSectionEndTime(section);
-
-        QString timeText = QString("第%1节\n%2-%3")
-                               .arg(section)
-                               .arg(startTime.toString("hh:mm"))
-                               .arg(endTime.toString("hh:mm"));
-
-        ui->courseTable->setVerticalHeaderItem(i, new QTableWidgetItem(timeText));
-    }
+    // 课程表由模型提供数据，委托直接绘制缓存的文本和画刷
+    m_courseModel = new CourseTableModel(m_scheduleManager, this);
+    ui->courseTable->setModel(m_courseModel);
+    ui->courseTable->setItemDelegate(new CourseItemDelegate(m_courseModel, ui->courseTable));
+
+    // 模型只通知发生变化的跨行，视图据此调整合并区域
+    connect(m_courseModel, &CourseTableModel::spansReset,
+            ui->courseTable, &QTableView::clearSpans);
+    connect(m_courseModel, &CourseTableModel::spanChanged, this, [this](int row, int col, int rowSpan) {
+        ui->courseTable->setSpan(row, col, rowSpan, 1);
+    });
 
     // 表格样式设置
     ui->courseTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
@@ -126,20 +154,41 @@ void MainWindow::setupCourseTable()
     ui->courseTable->setSelectionMode(QAbstractItemView::SingleSelection);
     ui->courseTable->setSelectionBehavior(QAbstractItemView::SelectItems);
 
-    // 连接单元格点击事件
-    connect(ui->courseTable, &QTableWidget::cellClicked,
-            this, &MainWindow::selectEntireCourseSpan);
+    m_courseModel->reload();
 }
 
 // 初始化任务列表
 void MainWindow::setupTaskList()
 {
-    ui->taskTable->setColumnCount(5);
-    ui->taskTable->setHorizontalHeaderLabels(
-        QStringList() << "状态" << "课程" << "任务" << "截止日期" << "剩余时间");
+    // 任务表格直接绑定模型，增删改只刷新受影响的行
+    m_taskModel = new TaskTableModel(m_taskManager, this);
+
+    // 排序和过滤在后台线程计算，界面线程只负责替换结果
+    m_taskProxy = new TaskSortFilterModel(this);
+    m_taskProxy->setSourceModel(m_taskModel);
+    ui->taskTable->setModel(m_taskProxy);
+    ui->taskTable->setSortingEnabled(true);
+    ui->taskTable->sortByColumn(TaskTableModel::DueDateColumn, Qt::AscendingOrder);
+
+    connect(ui->taskFilterEdit, &QLineEdit::textChanged,
+            m_taskProxy, &TaskSortFilterModel::setFilterText);
+    connect(ui->taskStatusFilter, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this](int index) {
+        m_taskProxy->setStatusFilter(static_cast<TaskSortFilterModel::StatusFilter>(index));
+    });
+    connect(ui->taskTypeFilter, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, [this](int index) {
+        m_taskProxy->setTypeFilter(static_cast<TaskSortFilterModel::TypeFilter>(index));
+    });
     ui->taskTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
     ui->taskTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    ui->taskTable->setSelectionMode(QAbstractItemView::SingleSelection);
     ui->taskTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // 固定行高，避免大量任务时逐行计算尺寸，视图只绘制可见行
+    ui->taskTable->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    ui->taskTable->verticalHeader()->setDefaultSectionSize(fontMetrics().height() + 8);
+    ui->taskTable->setWordWrap(false);
 }
 
 // 初始化系统托盘图标
@@ -156,7 +205,7 @@ void MainWindow::setupTrayIcon()
     m_trayIcon = new QSystemTrayIcon(this);
 
     // 强化图标加载判断
-    QIcon icon(":/icons/app_icon");
+    QIcon icon = IconCache::icon("app_icon");
     if (icon.isNull()) {
         qDebug() << "图标资源未加载成功，尝试使用默认图标";
         icon = QApplication::windowIcon();  // fallback
@@ -196,12 +245,26 @@ void MainWindow::setupConnections()
     connect(ui->actionAddCourse, &QAction::triggered, this, &MainWindow::addCourse);
     connect(ui->actionEditCourse, &QAction::triggered, this, &MainWindow::editCourse);
     connect(ui->actionDeleteCourse, &QAction::triggered, this, &MainWindow::deleteCourse);
+    connect(ui->actionImportProfile, &QAction::triggered, this, &MainWindow::importProfile);
 
     // 任务操作
     connect(ui->actionAddTask, &QAction::triggered, this, &MainWindow::addTask);
     connect(ui->actionCompleteTask, &QAction::triggered, this, &MainWindow::completeTask);
     connect(ui->actionDeleteTask, &QAction::triggered, this, &MainWindow::deleteTask);
 
+    // 撤销/重做
+    QMenu *editMenu = new QMenu("编辑", this);
+    QAction *undoAction = m_undoStack->createUndoAction(this, "撤销");
+    undoAction->setShortcut(QKeySequence::Undo);
+    QAction *redoAction = m_undoStack->createRedoAction(this, "重做");
+    redoAction->setShortcut(QKeySequence::Redo);
+    editMenu->addAction(undoAction);
+    editMenu->addAction(redoAction);
+    ui->menuBar->insertMenu(ui->menuCourse->menuAction(), editMenu);
+    // 从文件重新加载后，历史中的位置已失效
+    connect(m_scheduleManager, &ScheduleManager::coursesReset, m_undoStack, &QUndoStack::clear);
+    connect(m_taskManager, &TaskManager::tasksReset, m_undoStack, &QUndoStack::clear);
+
     // 窗口操作
     connect(ui->actionShowHide, &QAction::triggered, this, &MainWindow::toggleWindowVisibility);
     connect(ui->actionExit, &QAction::triggered, this, [this] {
@@ -216,146 +279,81 @@ void MainWindow::setupConnections()
         qApp->quit();
     });
 
-    // 课程表变化时更新UI
-    if (m_scheduleManager) {
-        connect(m_scheduleManager, &ScheduleManager::coursesChanged,
-                this, &MainWindow::updateCourseTable);
-    }
+    // 主题切换
+    connect(ui->actionToggleTheme, &QAction::triggered, this, &MainWindow::toggleTheme);
+    connect(m_settings, &Settings::themeChanged, m_themeManager, &ThemeManager::apply);
+
+    // 日历视图
+    connect(ui->actionShowCalendar, &QAction::triggered, this, &MainWindow::showCalendar);
+
+    // 性能跟踪（启动时通过环境变量开启的情况下菜单同步为勾选）
+    ui->actionToggleTrace->setChecked(TraceRecorder::isEnabled());
+    connect(ui->actionToggleTrace, &QAction::toggled, this, &MainWindow::toggleTrace);
+
+    // 本地查询接口
+    connect(ui->actionToggleApi, &QAction::toggled, this, [this](bool enabled) {
+        setApiEnabled(enabled, true);
+    });
+
+    // 内存诊断不放在菜单中，只能通过快捷键打开
+    QShortcut *memoryShortcut = new QShortcut(QKeySequence("Ctrl+Shift+M"), this);
+    connect(memoryShortcut, &QShortcut::activated, this, &MainWindow::showMemoryDiagnostics);
+    connect(m_settings, &Settings::semesterChanged, this, [this]() {
+        applySemester();
+        updateCurrentCourse();
+    });
 
     // 安全连接设置提醒动作
     if (ui->actionSetReminder) {
         connect(ui->actionSetReminder, &QAction::triggered,
                 this, &MainWindow::slotSetReminder);
     }
-    if (m_taskManager) {
-        connect(m_taskManager, &TaskManager::tasksChanged,
-                this, &MainWindow::updateTaskList);
-    }
+    connect(ui->actionSetSemester, &QAction::triggered, this, &MainWindow::slotSetSemester);
 }
 
-// 更新课程表显示
-void MainWindow::updateCourseTable()
+// 获取课程表中当前选中的课程；单元格里有多门课程（如单双周交替）时让用户选择
+// 没有选中课程或用户取消时返回 nullptr
+Course *MainWindow::selectedCourse(const QString &action)
 {
-    if (!ui || !ui->courseTable || !m_scheduleManager) {
-        qWarning() << "UI组件或计划管理器未初始化";
-        return;
-    }
-
-    // 清空表格
-    ui->courseTable->clearSpans();
-    ui->courseTable->clearContents();
-
-    // 填充课程数据
-    for (int day = 1; day <= 7; ++day) {
-        auto courses = m_scheduleManager->getCoursesByDay(day);
-        for (auto course : courses) {
-            if (!course) continue; // 跳过空指针
-
-            int startSection = course->startSection();
-            int endSection = course->endSection();
-
-            // 验证节次范围
-            if (startSection < 1 || endSection < startSection) {
-                qWarning() << "无效的节次范围:" << startSection << "-" << endSection;
-                continue;
-            }
-
-            int row = startSection - 1;
-            int col = day - 1;
-
-            // 验证表格索引
-            if (row < 0 || row >= ui->courseTable->rowCount() ||
-                col < 0 || col >= ui->courseTable->columnCount()) {
-                qWarning() << "无效的表格位置:" << row << "," << col;
-                continue;
-            }
-
-            int duration = endSection - startSection + 1;
-
-            // 设置单元格
-            QTableWidgetItem *item = new QTableWidgetItem(course->displayText());
-            item->setBackground(course->color());
-            item->setTextAlignment(Qt::AlignCenter);
-            item->setData(Qt::UserRole, QVariant::fromValue(course));
-            ui->courseTable->setItem(row, col, item);
-
-            // 设置跨度
-            if (duration > 1) {
-                ui->courseTable->setSpan(row, col, duration, 1);
-            }
-        }
-    }
+    QList<Course*> courses;
+    if (m_courseModel) {
+        courses = m_courseModel->coursesAt(ui->courseTable->currentIndex());
+    }
+    if (courses.isEmpty()) {
+        QMessageBox::information(this, "提示", QString("请先选择要%1的课程").arg(action));
+        return nullptr;
+    }
+    if (courses.size() == 1) {
+        return courses.first();
+    }
+
+    QStringList items;
+    for (int i = 0; i < courses.size(); ++i) {
+        const Course *course = courses.at(i);
+        items << QString("%1. %2（第%3-%4节，%5）")
+                     .arg(i + 1)
+                     .arg(course->name())
+                     .arg(course->startSection())
+                     .arg(course->endSection())
+                     .arg(Course::weekParityText(course->weekParity()));
+    }
+    bool ok = false;
+    QString item = QInputDialog::getItem(this, QString("%1课程").arg(action),
+                                         "该时段有多门课程，请选择：", items, 0, false, &ok);
+    return ok ? courses.value(items.indexOf(item)) : nullptr;
 }
 
-// 更新任务列表
-void MainWindow::updateTaskList()
+// 获取任务表格中当前选中的任务
+Task *MainWindow::selectedTask() const
 {
-    if (!ui || !ui->taskTable) {
-        qWarning() << "UI组件未初始化";
-        return;
-    }
-
-    // 清空表格
-    ui->taskTable->setRowCount(0);
-
-    if (!m_taskManager) {
-        qWarning() << "任务管理器未初始化";
-        return;
-    }
-
-    // 获取所有任务
-    QList<Task*> tasks = m_taskManager->getAllTasks();
-
-    for (int i = 0; i < tasks.size(); ++i) {
-        Task *task = tasks[i];
-        if (!task) {
-            qWarning() << "跳过空任务";
-            continue;
-        }
-
-        ui->taskTable->insertRow(i);
-
-        // 状态图标
-        QTableWidgetItem *statusItem = new QTableWidgetItem();
-        statusItem->setBackground(task->priorityColor());
+    if (!m_taskModel) return nullptr;
 
-        // 设置图标
-        if (task->isCompleted()) {
-            statusItem->setIcon(QIcon(":/icons/checked"));
-        } else if (task->isExam()) {
-            statusItem->setIcon(QIcon(":/icons/exam"));
-        } else {
-            statusItem->setIcon(QIcon(":/icons/homework"));
-        }
-
-        // 课程名称
-        QTableWidgetItem *courseItem = new QTableWidgetItem(task->courseName());
-
-        // 任务标题
-        QTableWidgetItem *titleItem = new QTableWidgetItem(task->title());
-
-        // 截止日期
-        QTableWidgetItem *dateItem = new QTableWidgetItem(task->dueDate().toString("yyyy-MM-dd"));
+    QModelIndex index = m_taskProxy->mapToSource(ui->taskTable->currentIndex());
+    if (!index.isValid()) return nullptr;
 
-        // 剩余时间
-        QTableWidgetItem *daysItem = new QTableWidgetItem(task->statusText());
-
-        // 设置数据关联
-        QVariant taskVariant = QVariant::fromValue(task);
-        statusItem->setData(Qt::UserRole, taskVariant);
-        courseItem->setData(Qt::UserRole, taskVariant);
-        titleItem->setData(Qt::UserRole, taskVariant);
-        dateItem->setData(Qt::UserRole, taskVariant);
-        daysItem->setData(Qt::UserRole, taskVariant);
-
-        // 添加到表格
-        ui->taskTable->setItem(i, 0, statusItem);
-        ui->taskTable->setItem(i, 1, courseItem);
-        ui->taskTable->setItem(i, 2, titleItem);
-        ui->taskTable->setItem(i, 3, dateItem);
-        ui->taskTable->setItem(i, 4, daysItem);
-    }
+    return m_taskModel->taskAt(index.row());
 }
+
 // 更新当前课程和下一节课显示
 void MainWindow::updateCurrentCourse()
 {
@@ -405,9 +403,11 @@ void MainWindow::addCourse()
     CourseDialog dialog(this);
     if (dialog.exec() == QDialog::Accepted) {
         Course course = dialog.getCourse();
-        if (!m_scheduleManager->addCourse(course)) {
+        if (m_scheduleManager->hasConflict(course)) {
             QMessageBox::warning(this, "冲突", "该时间段已有其他课程");
+            return;
         }
+        m_undoStack->push(new AddCourseCommand(m_scheduleManager, course));
     }
 }
 
@@ -415,63 +415,66 @@ void MainWindow::addCourse()
 void MainWindow::editCourse()
 {
     // 获取选中的课程
-    QList<QTableWidgetItem*> items = ui->courseTable->selectedItems();
-    if (items.isEmpty()) {
-        QMessageBox::information(this, "提示", "请先选择要编辑的课程");
+    Course *selected = selectedCourse("编辑");
+    if (!selected) {
         return;
     }
 
-    Course *selectedCourse = items.first()->data(Qt::UserRole).value<Course*>();
-    if (!selectedCourse) return;
-
     CourseDialog dialog(this);
-    dialog.setCourse(*selectedCourse);
+    dialog.setCourse(*selected);
 
     if (dialog.exec() == QDialog::Accepted) {
         Course newCourse = dialog.getCourse();
-        if (!m_scheduleManager->editCourse(m_scheduleManager->getAllCourses().indexOf(selectedCourse), newCourse)) {
+        int index = m_scheduleManager->getAllCourses().indexOf(selected);
+        if (index < 0 || m_scheduleManager->hasConflict(newCourse, index)) {
             QMessageBox::warning(this, "冲突", "该时间段已有其他课程");
+            return;
         }
+        m_undoStack->push(new EditCourseCommand(m_scheduleManager, index, newCourse));
     }
 }
 
 // 删除课程
 void MainWindow::deleteCourse()
 {
-    //获取所有选中单元格
-    QList<QTableWidgetItem*> items = ui->courseTable->selectedItems();
-    if (items.isEmpty()) {
-        QMessageBox::information(this, "提示", "请先选择要删除的课程");
+    // 跨行单元格的任意一格都对应同一组课程
+    Course *selected = selectedCourse("删除");
+    if (!selected) {
         return;
     }
 
-    // 关键：取第一个选中项（跨行课程的左上角单元格）
-    QTableWidgetItem *item = items.first();
-    Course *selectedCourse = item->data(Qt::UserRole).value<Course*>();
-    if (!selectedCourse) return;
-
     if (QMessageBox::question(this, "确认", "确定要删除这门课程吗？") == QMessageBox::Yes) {
-        m_scheduleManager->removeCourse(m_scheduleManager->getAllCourses().indexOf(selectedCourse));
+        int index = m_scheduleManager->getAllCourses().indexOf(selected);
+        if (index >= 0) {
+            m_undoStack->push(new RemoveCourseCommand(m_scheduleManager, index));
+        }
     }
 }
 
-//槽函数，在点击时自动选中整个合并区域
-void MainWindow::selectEntireCourseSpan(int row, int col)
+// 从教务导出的 CSV 导入课程和任务，整批可一次撤销
+void MainWindow::importProfile()
 {
-    // 获取点击位置的跨度信息（如果跨行）
-    int rowSpan = ui->courseTable->rowSpan(row, col);
-    int colSpan = ui->courseTable->columnSpan(row, col);
+    QString fileName = QFileDialog::getOpenFileName(this, "导入课程与任务", QString(), "CSV 文件 (*.csv)");
+    if (fileName.isEmpty()) {
+        return;
+    }
 
-    if (rowSpan > 1 || colSpan > 1) {
-        ui->courseTable->clearSelection();
-        for (int r = row; r < row + rowSpan; ++r) {
-            for (int c = col; c < col + colSpan; ++c) {
-                if (ui->courseTable->item(r, c)) {
-                    ui->courseTable->item(r, c)->setSelected(true);
-                }
-            }
-        }
+    ScheduleSnapshot courses;
+    TaskSnapshot tasks;
+    ProfileImporter::Result result = ProfileImporter::parseProfile(fileName, courses, tasks);
+    if (!result.ok()) {
+        QMessageBox::warning(this, "导入失败", result.errors.mid(0, 10).join("\n"));
+        return;
     }
+    if (!m_scheduleManager->canAddCourses(courses.items.toVector())) {
+        QMessageBox::warning(this, "冲突", "导入的课程与现有课程时间冲突");
+        return;
+    }
+
+    m_undoStack->push(new ImportCommand(m_scheduleManager, m_taskManager, courses, tasks));
+    QMessageBox::information(this, "导入完成",
+                             QString("已导入 %1 门课程、%2 项任务，可通过“撤销”整体撤回。")
+                                 .arg(result.courseCount).arg(result.taskCount));
 }
 
 // 添加任务
@@ -482,57 +485,39 @@ void MainWindow::addTask()
 
     if (dialog.exec() == QDialog::Accepted) {
         Task *task = dialog.getTask();
-        m_taskManager->addTask(task); // 将任务添加到任务管理器
+        m_undoStack->push(new AddTaskCommand(m_taskManager, task)); // 将任务添加到任务管理器
     }
 }
 
 // --- MainWindow.cpp ---
 void MainWindow::completeTask()
 {
-    int row = ui->taskTable->currentRow();
-    if (row < 0) {
+    Task *task = selectedTask();
+    if (!task) {
         QMessageBox::information(this, "提示", "请先选择要标记的任务");
         return;
     }
 
-    QTableWidgetItem *item = ui->taskTable->item(row, 0);
-    Task *task = item->data(Qt::UserRole).value<Task*>();
-    if (task) {
-        m_taskManager->setTaskCompleted(task, !task->isCompleted());
-    }
+    int index = m_taskManager->getAllTasks().indexOf(task);
+    m_undoStack->push(new CompleteTaskCommand(m_taskManager, index, !task->isCompleted()));
 }
 
 void MainWindow::deleteTask()
 {
-    // 获取当前选中行
-    int currentRow = ui->taskTable->currentRow();
-    if (currentRow < 0) {
-        QMessageBox::information(this, "提示", "请先选择要删除的任务");
-        return;
-    }
-
-    // 获取任务指针
-    QTableWidgetItem *item = ui->taskTable->item(currentRow, 0);
-    if (!item) {
-        qWarning() << "无法获取任务项";
-        return;
-    }
-
-    Task *task = item->data(Qt::UserRole).value<Task*>();
+    // 获取当前选中的任务
+    Task *task = selectedTask();
     if (!task) {
-        qWarning() << "无效的任务指针";
+        QMessageBox::information(this, "提示", "请先选择要删除的任务");
         return;
     }
 
     // 确认删除
     if (QMessageBox::question(this, "确认", "确定要删除这个任务吗？") == QMessageBox::Yes)
     {
-        // 先移除表格行
-        ui->taskTable->removeRow(currentRow);
-
-        // 然后从任务管理器中删除任务
-        if (m_taskManager) {
-            m_taskManager->removeTask(task);
+        // 从任务管理器中删除任务，模型会自动移除对应行；可通过撤销恢复
+        int index = m_taskManager->getAllTasks().indexOf(task);
+        if (index >= 0) {
+            m_undoStack->push(new RemoveTaskCommand(m_taskManager, index));
         }
 
         // 清除当前选中项
@@ -551,6 +536,47 @@ void MainWindow::toggleWindowVisibility()
     }
 }
 
+// 支持的选项：
+//   --show                 显示并激活主窗口（没有其他选项时的默认操作）
+//   --add-task             打开添加任务对话框
+//   --new-task <标题>      直接添加任务，可配合 --due <yyyy-MM-dd>（默认今天）
+void MainWindow::handleCommandLine(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    QCommandLineOption showOption("show", "显示主窗口");
+    QCommandLineOption addTaskOption("add-task", "打开添加任务对话框");
+    QCommandLineOption newTaskOption("new-task", "直接添加任务", "标题");
+    QCommandLineOption dueOption("due", "新任务的截止日期", "yyyy-MM-dd");
+    parser.addOptions({showOption, addTaskOption, newTaskOption, dueOption});
+    // parse 要求第一个参数是程序名；无法识别的选项只提示，其余选项照常处理
+    if (!parser.parse(QStringList(QCoreApplication::applicationFilePath()) + arguments)) {
+        qWarning() << "命令行有误:" << parser.errorText();
+    }
+
+    showNormal();
+    activateWindow();
+    raise();
+
+    if (parser.isSet(newTaskOption)) {
+        QString title = parser.value(newTaskOption).trimmed();
+        QDate due = QDate::currentDate();
+        if (parser.isSet(dueOption)) {
+            due = QDate::fromString(parser.value(dueOption), Qt::ISODate);
+        }
+        if (title.isEmpty() || !due.isValid()) {
+            qWarning() << "忽略无效的 --new-task/--due 参数";
+        } else {
+            m_undoStack->push(new AddTaskCommand(m_taskManager, new Task(title, due)));
+            showTrayMessage("已添加任务", QString("%1（截止 %2）").arg(title, due.toString("yyyy-MM-dd")));
+        }
+    }
+
+    // 对话框推迟到事件循环中打开，避免在套接字的信号处理中嵌套模态循环
+    if (parser.isSet(addTaskOption)) {
+        QTimer::singleShot(0, this, &MainWindow::addTask);
+    }
+}
+
 // 关闭事件处理
 void MainWindow::closeEvent(QCloseEvent *event)
 {
@@ -642,3 +668,136 @@ void MainWindow::slotSetReminder()
             );
     }
 }
+
+// 设置开学日期与学期周数，日历周次与单双周课程以此为准
+void MainWindow::applySemester()
+{
+    const QDate start = m_settings->semesterStartDate();
+    m_timeline->setSemester(start, m_settings->semesterWeeks());
+    m_scheduleManager->setSemesterStart(start);
+    if (m_apiHandler) {
+        m_apiHandler->setSemesterStart(start);
+    }
+}
+
+void MainWindow::slotSetSemester()
+{
+    SemesterDialog dlg(m_settings->semesterStartDate(), m_settings->semesterWeeks(), this);
+    if (dlg.exec() == QDialog::Accepted) {
+        m_settings->setSemesterWeeks(dlg.weeks());
+        m_settings->setSemesterStartDate(dlg.startDate());
+    }
+}
+
+// 在深色和浅色主题之间切换
+void MainWindow::toggleTheme()
+{
+    QString theme = m_settings->theme() == "dark" ? "light" : "dark";
+    m_settings->setTheme(theme);
+}
+
+// 打开日历窗口（非模态，重复打开时复用同一窗口）
+void MainWindow::showCalendar()
+{
+    TRACE_SCOPE_CAT("MainWindow::showCalendar", "dialog");
+    if (!m_calendarDialog) {
+        m_calendarDialog = new CalendarDialog(m_timeline, m_deadlineIndex, m_taskManager, this);
+    }
+    m_calendarDialog->show();
+    m_calendarDialog->raise();
+    m_calendarDialog->activateWindow();
+}
+
+// 开始/停止记录性能跟踪，停止时导出为 Chrome 跟踪格式（chrome://tracing 或 Perfetto 打开）
+void MainWindow::toggleTrace(bool enabled)
+{
+    if (enabled) {
+        TraceRecorder::clear();
+        TraceRecorder::setEnabled(true);
+        return;
+    }
+
+    TraceRecorder::setEnabled(false);
+    QString fileName = QFileDialog::getSaveFileName(this, "保存性能跟踪", "trace.json", "JSON 文件 (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    int count = TraceRecorder::dump(fileName);
+    if (count < 0) {
+        QMessageBox::warning(this, "保存失败", "无法写入文件：" + fileName);
+        return;
+    }
+    QMessageBox::information(this, "已保存", QString("已导出 %1 个跟踪事件。").arg(count));
+}
+
+// 开启/关闭本地查询接口，结果保存到设置中；interactive 为 false 时只记录警告
+bool MainWindow::setApiEnabled(bool enabled, bool interactive)
+{
+    if (!enabled) {
+        if (m_apiServer) {
+            m_apiServer->stop();
+        }
+        m_settings->setApiEnabled(false);
+        return true;
+    }
+
+    if (!m_apiServer) {
+        auto handler = std::make_unique<ScheduleApiHandler>(&m_scheduleManager->snapshots(),
+                                                            &m_taskManager->snapshots());
+        handler->setSemesterStart(m_settings->semesterStartDate());
+        m_apiHandler = handler.get();
+        m_apiServer = new ApiServer(std::move(handler), this);
+    }
+    QString error;
+    bool ok = m_apiServer->start(quint16(m_settings->apiPort()), &error);
+    if (ok) {
+        m_settings->setApiEnabled(true);
+        if (interactive) {
+            QMessageBox::information(this, "本地查询接口",
+                                     QString("已开启：http://127.0.0.1:%1/api/next").arg(m_apiServer->port()));
+        }
+    } else {
+        qWarning() << "本地查询接口启动失败:" << error;
+        if (interactive) {
+            QMessageBox::warning(this, "本地查询接口", "无法监听端口：" + error);
+        }
+    }
+    // 启动失败时取消勾选，但不触发再次关闭
+    QSignalBlocker blocker(ui->actionToggleApi);
+    ui->actionToggleApi->setChecked(ok);
+    return ok;
+}
+
+// 打开内存诊断窗口（非模态，刷新时重新统计）
+void MainWindow::showMemoryDiagnostics()
+{
+    if (!m_memoryDialog) {
+        m_memoryDialog = new MemoryDialog(this);
+        connect(m_memoryDialog, &MemoryDialog::refreshRequested, this, [this]() {
+            MemoryReport report;
+            collectMemoryReport(report);
+            m_memoryDialog->setReport(report);
+        });
+    }
+    emit m_memoryDialog->refreshRequested();
+    m_memoryDialog->show();
+    m_memoryDialog->raise();
+    m_memoryDialog->activateWindow();
+}
+
+void MainWindow::collectMemoryReport(MemoryReport &report) const
+{
+    m_scheduleManager->reportMemory(report);
+    m_taskManager->reportMemory(report);
+    m_courseModel->reportMemory(report);
+    m_taskProxy->reportMemory(report);
+    m_deadlineIndex->reportMemory(report);
+    if (m_notification) {
+        m_notification->reportMemory(report);
+    }
+    IconCache::reportMemory(report);
+    if (m_calendarDialog) {
+        m_calendarDialog->reportMemory(report);
+    }
+}
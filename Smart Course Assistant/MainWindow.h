@@ -5,10 +5,23 @@
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QAction>
+#include <QUndoStack>
 #include "ScheduleManager.h"
 #include "Notification.h"
 #include "TaskManager.h"
 #include "Settings.h"
+#include "TaskTableModel.h"
+#include "TaskSortFilterModel.h"
+#include "CourseTableModel.h"
+#include "ThemeManager.h"
+#include "OccurrenceTimeline.h"
+#include "DeadlineIndex.h"
+
+class CalendarDialog;
+class MemoryDialog;
+class MemoryReport;
+class ApiServer;
+class ScheduleApiHandler;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -20,6 +33,7 @@ class MainWindow : public QMainWindow
 
 private slots:
     void slotSetReminder();
+    void slotSetSemester();
 public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
@@ -33,6 +47,8 @@ public slots:
     void toggleWindowVisibility();
     void showTrayMessage(const QString &title, const QString &message);
     void restoreFromTray();
+    // 处理命令行（不含程序名），包括其他实例转交过来的命令行
+    void handleCommandLine(const QStringList &arguments);
 
 private:
     void setupTrayIcon();
@@ -41,25 +57,44 @@ private:
     QAction *m_actionToggleVisibility;
     QAction *m_actionExit;
     Settings *m_settings;
+    ThemeManager *m_themeManager;
     Notification *m_notification;
     ScheduleManager *m_scheduleManager;
     TaskManager *m_taskManager;
+    TaskTableModel *m_taskModel;
+    TaskSortFilterModel *m_taskProxy;
+    CourseTableModel *m_courseModel;
+    OccurrenceTimeline *m_timeline;
+    DeadlineIndex *m_deadlineIndex;
+    CalendarDialog *m_calendarDialog;
+    MemoryDialog *m_memoryDialog;
+    ApiServer *m_apiServer;
+    ScheduleApiHandler *m_apiHandler;   // 归 m_apiServer 所有
+    QUndoStack *m_undoStack;
     QSystemTrayIcon *m_trayIcon;
 
     int  loadReminderTime() const;
+    // 学期设置同步到日历、当前/下一节课与查询接口
+    void applySemester();
     void saveReminderTime(int minutes) const;
     void setupCourseTable();
     void setupTaskList();
     void setupConnections();
+    void toggleTheme();
+    void showCalendar();
+    void toggleTrace(bool enabled);
+    bool setApiEnabled(bool enabled, bool interactive);
+    void showMemoryDiagnostics();
+    void collectMemoryReport(MemoryReport &report) const;
 
-    void updateCourseTable();
-    void updateTaskList();
+    Course *selectedCourse(const QString &action);
+    Task *selectedTask() const;
     void updateCurrentCourse();
 
     void addCourse();
     void editCourse();
     void deleteCourse();
-    void selectEntireCourseSpan(int row, int col);
+    void importProfile();
 
     void addTask();
     void completeTask();
@@ -0,0 +1,82 @@
+#include "MemoryDialog.h"
+#include "ui_MemoryDialog.h"
+#include <QFile>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QJsonDocument>
+#include <QLocale>
+#include <QMessageBox>
+
+MemoryDialog::MemoryDialog(QWidget *parent)
+    : QDialog(parent),
+    ui(new Ui::MemoryDialog)
+{
+    ui->setupUi(this);
+    ui->tableWidget->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    ui->tableWidget->verticalHeader()->hide();
+
+    if (MemoryStats::allocationTrackingAvailable()) {
+        ui->trackingLabel->setText("分配跟踪已开启，导出的报告中包含按类别统计的存活分配。");
+    } else {
+        ui->trackingLabel->setText("分配跟踪未编译（qmake CONFIG+=alloc_tracking 可开启），以下均为按数据结构的估算值。");
+    }
+
+    connect(ui->refreshButton, &QPushButton::clicked, this, &MemoryDialog::refreshRequested);
+    connect(ui->exportButton, &QPushButton::clicked, this, &MemoryDialog::exportReport);
+    connect(ui->closeButton, &QPushButton::clicked, this, &QDialog::close);
+}
+
+MemoryDialog::~MemoryDialog()
+{
+    delete ui;
+}
+
+void MemoryDialog::setReport(const MemoryReport &report)
+{
+    m_report = report;
+
+    const QLocale locale = QLocale::c();
+    const QVector<MemoryReport::Entry> &entries = report.entries();
+    ui->tableWidget->setRowCount(entries.size());
+    for (int row = 0; row < entries.size(); ++row) {
+        const MemoryReport::Entry &entry = entries.at(row);
+        QStringList cells = {
+            entry.subsystem,
+            QString::number(entry.records),
+            locale.formattedDataSize(entry.bytes, 1, QLocale::DataSizeTraditionalFormat),
+            entry.records > 0 ? QString("%1 B").arg(entry.bytesPerRecord()) : QString("-"),
+            locale.formattedDataSize(entry.stringBytes, 1, QLocale::DataSizeTraditionalFormat)
+        };
+        for (int column = 0; column < cells.size(); ++column) {
+            QTableWidgetItem *item = new QTableWidgetItem(cells.at(column));
+            if (column > 0) {
+                item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+            }
+            ui->tableWidget->setItem(row, column, item);
+        }
+    }
+
+    ui->totalLabel->setText(QString("合计：%1")
+                                .arg(locale.formattedDataSize(report.totalBytes(), 1,
+                                                              QLocale::DataSizeTraditionalFormat)));
+}
+
+void MemoryDialog::exportReport()
+{
+    QString fileName = QFileDialog::getSaveFileName(this, "导出内存报告", "memory.txt",
+                                                    "文本文件 (*.txt);;JSON 文件 (*.json)");
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        QMessageBox::warning(this, "导出失败", "无法写入文件：" + fileName);
+        return;
+    }
+    if (fileName.endsWith(".json", Qt::CaseInsensitive)) {
+        file.write(QJsonDocument(m_report.toJson()).toJson());
+    } else {
+        file.write(m_report.toText().toUtf8());
+    }
+}
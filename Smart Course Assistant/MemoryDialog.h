@@ -0,0 +1,33 @@
+#ifndef MEMORYDIALOG_H
+#define MEMORYDIALOG_H
+
+#include <QDialog>
+#include "MemoryStats.h"
+
+namespace Ui {
+class MemoryDialog;
+}
+
+// 隐藏的内存诊断窗口（Ctrl+Shift+M 打开），显示各子系统的记录数与占用
+class MemoryDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit MemoryDialog(QWidget *parent = nullptr);
+    ~MemoryDialog();
+
+    void setReport(const MemoryReport &report);
+
+signals:
+    void refreshRequested();
+
+private slots:
+    void exportReport();
+
+private:
+    Ui::MemoryDialog *ui;
+    MemoryReport m_report;
+};
+
+#endif // MEMORYDIALOG_H
@@ -0,0 +1,301 @@
+#include "MemoryStats.h"
+#include "Course.h"
+#include "Task.h"
+#include "Snapshot.h"
+#include <QJsonArray>
+#include <QLocale>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+thread_local MemoryStats::Category currentCategory = MemoryStats::Other;
+
+#ifdef SMARTSCHEDULE_ALLOC_TRACKING
+
+// 每块内存前放一个头部记录大小和类别，释放时据此扣减
+// 头部按 max_align_t 对齐，保证返回给调用者的地址满足默认对齐要求
+struct alignas(alignof(std::max_align_t)) BlockHeader {
+    std::size_t size;
+    int category;
+};
+
+struct CategoryCounters {
+    std::atomic<qint64> bytes{0};
+    std::atomic<qint64> blocks{0};
+    std::atomic<qint64> total{0};
+};
+
+// 静态初始化之前就可能有分配，计数器必须是常量初始化的普通数组
+CategoryCounters counters[MemoryStats::CategoryCount];
+
+void *trackedAlloc(std::size_t size) noexcept
+{
+    void *raw = std::malloc(sizeof(BlockHeader) + size);
+    if (!raw) {
+        return nullptr;
+    }
+    BlockHeader *header = static_cast<BlockHeader *>(raw);
+    header->size = size;
+    header->category = currentCategory;
+    CategoryCounters &c = counters[header->category];
+    c.bytes.fetch_add(qint64(size), std::memory_order_relaxed);
+    c.blocks.fetch_add(1, std::memory_order_relaxed);
+    c.total.fetch_add(1, std::memory_order_relaxed);
+    return header + 1;
+}
+
+void trackedFree(void *ptr) noexcept
+{
+    if (!ptr) {
+        return;
+    }
+    BlockHeader *header = static_cast<BlockHeader *>(ptr) - 1;
+    CategoryCounters &c = counters[header->category];
+    c.bytes.fetch_sub(qint64(header->size), std::memory_order_relaxed);
+    c.blocks.fetch_sub(1, std::memory_order_relaxed);
+    std::free(header);
+}
+
+void *trackedNew(std::size_t size)
+{
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        if (void *ptr = trackedAlloc(size)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+#endif // SMARTSCHEDULE_ALLOC_TRACKING
+
+QString formatBytes(qint64 bytes)
+{
+    return QLocale::c().formattedDataSize(bytes, 1, QLocale::DataSizeTraditionalFormat);
+}
+
+} // namespace
+
+#ifdef SMARTSCHEDULE_ALLOC_TRACKING
+
+// 对齐版本（align_val_t）不替换，由标准库自行配对
+void *operator new(std::size_t size) { return trackedNew(size); }
+void *operator new[](std::size_t size) { return trackedNew(size); }
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept { return trackedAlloc(size ? size : 1); }
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept { return trackedAlloc(size ? size : 1); }
+void operator delete(void *ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { trackedFree(ptr); }
+void operator delete(void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept { trackedFree(ptr); }
+
+#endif // SMARTSCHEDULE_ALLOC_TRACKING
+
+MemoryStats::Category MemoryStats::exchangeCategory(Category category)
+{
+    Category previous = currentCategory;
+    currentCategory = category;
+    return previous;
+}
+
+QString MemoryStats::categoryName(Category category)
+{
+    switch (category) {
+    case Courses:   return "课程";
+    case Tasks:     return "任务";
+    case Snapshots: return "快照";
+    case Models:    return "表格模型";
+    case Icons:     return "图标";
+    default:        return "其他";
+    }
+}
+
+bool MemoryStats::allocationTrackingAvailable()
+{
+#ifdef SMARTSCHEDULE_ALLOC_TRACKING
+    return true;
+#else
+    return false;
+#endif
+}
+
+MemoryStats::Allocation MemoryStats::allocation(Category category)
+{
+    Allocation result;
+#ifdef SMARTSCHEDULE_ALLOC_TRACKING
+    if (category >= 0 && category < CategoryCount) {
+        const CategoryCounters &c = counters[category];
+        result.bytes = c.bytes.load(std::memory_order_relaxed);
+        result.blocks = c.blocks.load(std::memory_order_relaxed);
+        result.total = c.total.load(std::memory_order_relaxed);
+    }
+#else
+    Q_UNUSED(category);
+#endif
+    return result;
+}
+
+qint64 MemoryStats::peakRssKb()
+{
+#ifdef Q_OS_WIN
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return qint64(counters.PeakWorkingSetSize / 1024);
+    }
+    return -1;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#ifdef Q_OS_MACOS
+    return qint64(usage.ru_maxrss / 1024);   // macOS 以字节为单位
+#else
+    return qint64(usage.ru_maxrss);
+#endif
+#endif
+}
+
+// UTF-16 数据按容量计算，空字符串共用静态数据不占堆
+qint64 MemoryStats::stringBytes(const QString &text)
+{
+    if (text.capacity() == 0) {
+        return 0;
+    }
+    return ARRAY_HEADER_BYTES + qint64(text.capacity() + 1) * qint64(sizeof(QChar));
+}
+
+qint64 MemoryStats::courseStringBytes(const Course &course)
+{
+    return stringBytes(course.name()) + stringBytes(course.classroom())
+           + stringBytes(course.teacher()) + stringBytes(course.note());
+}
+
+qint64 MemoryStats::courseBytes(const Course &course)
+{
+    return qint64(sizeof(Course)) + QOBJECT_PRIVATE_BYTES + courseStringBytes(course);
+}
+
+// 状态文本缓存也算在内，但只计已经生成的那份，统计本身不能替未显示的任务生成缓存
+qint64 MemoryStats::taskStringBytes(const Task &task)
+{
+    return stringBytes(task.title()) + stringBytes(task.courseName())
+           + stringBytes(task.description()) + stringBytes(task.cachedStatusText());
+}
+
+qint64 MemoryStats::taskBytes(const Task &task)
+{
+    return qint64(sizeof(Task)) + QOBJECT_PRIVATE_BYTES + taskStringBytes(task);
+}
+
+// 快照记录与对象共用字符串数据，这里只计记录本身和控制块
+qint64 MemoryStats::courseRecordBytes()
+{
+    return qint64(sizeof(CourseRecord)) + SHARED_PTR_BLOCK_BYTES;
+}
+
+qint64 MemoryStats::taskRecordBytes()
+{
+    return qint64(sizeof(TaskRecord)) + SHARED_PTR_BLOCK_BYTES;
+}
+
+void MemoryReport::add(const QString &subsystem, qint64 records, qint64 bytes, qint64 stringBytes)
+{
+    Entry entry;
+    entry.subsystem = subsystem;
+    entry.records = records;
+    entry.bytes = bytes;
+    entry.stringBytes = stringBytes;
+    m_entries.append(entry);
+}
+
+qint64 MemoryReport::totalBytes() const
+{
+    qint64 total = 0;
+    for (const Entry &entry : m_entries) {
+        total += entry.bytes;
+    }
+    return total;
+}
+
+QString MemoryReport::toText() const
+{
+    QString text;
+    text += QString("%1 %2 %3 %4 %5\n")
+                .arg("子系统", -16).arg("记录数", 10).arg("总计", 12)
+                .arg("每条", 10).arg("其中字符串", 12);
+    for (const Entry &entry : m_entries) {
+        text += QString("%1 %2 %3 %4 %5\n")
+                    .arg(entry.subsystem, -16)
+                    .arg(entry.records, 10)
+                    .arg(formatBytes(entry.bytes), 12)
+                    .arg(entry.records > 0 ? QString::number(entry.bytesPerRecord()) + " B" : QString("-"), 10)
+                    .arg(formatBytes(entry.stringBytes), 12);
+    }
+    text += QString("%1 %2\n").arg("合计", -16).arg(formatBytes(totalBytes()), 23);
+
+    if (MemoryStats::allocationTrackingAvailable()) {
+        text += "\n分配跟踪（当前存活）\n";
+        for (int i = 0; i < MemoryStats::CategoryCount; ++i) {
+            MemoryStats::Category category = static_cast<MemoryStats::Category>(i);
+            MemoryStats::Allocation a = MemoryStats::allocation(category);
+            text += QString("%1 %2 块 %3（累计 %4 次）\n")
+                        .arg(MemoryStats::categoryName(category), -16)
+                        .arg(a.blocks, 10)
+                        .arg(formatBytes(a.bytes), 12)
+                        .arg(a.total);
+        }
+    }
+    return text;
+}
+
+QJsonObject MemoryReport::toJson() const
+{
+    QJsonArray subsystems;
+    for (const Entry &entry : m_entries) {
+        QJsonObject obj;
+        obj["subsystem"] = entry.subsystem;
+        obj["records"] = entry.records;
+        obj["bytes"] = entry.bytes;
+        obj["bytesPerRecord"] = entry.bytesPerRecord();
+        obj["stringBytes"] = entry.stringBytes;
+        subsystems.append(obj);
+    }
+
+    QJsonObject root;
+    root["subsystems"] = subsystems;
+    root["totalBytes"] = totalBytes();
+
+    if (MemoryStats::allocationTrackingAvailable()) {
+        QJsonArray tracked;
+        for (int i = 0; i < MemoryStats::CategoryCount; ++i) {
+            MemoryStats::Category category = static_cast<MemoryStats::Category>(i);
+            MemoryStats::Allocation a = MemoryStats::allocation(category);
+            QJsonObject obj;
+            obj["category"] = MemoryStats::categoryName(category);
+            obj["bytes"] = a.bytes;
+            obj["blocks"] = a.blocks;
+            obj["allocations"] = a.total;
+            tracked.append(obj);
+        }
+        root["allocations"] = tracked;
+    }
+    return root;
+}
@@ -0,0 +1,127 @@
+#ifndef MEMORYSTATS_H
+#define MEMORYSTATS_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+#include <QtGlobal>
+#include "ChunkedVector.h"
+
+class Course;
+class Task;
+struct CourseRecord;
+struct TaskRecord;
+
+// 内存统计：各子系统按实际数据结构估算占用，结果汇总到 MemoryReport
+// 估算只计堆上的主要数据，不含分配器自身的开销
+// 以 CONFIG+=alloc_tracking 编译时另外替换全局 operator new/delete，按类别累计真实分配量；
+// QString/QVector 等的数据由 Qt 直接 malloc，不经过 operator new，这部分以估算值为准
+class MemoryStats
+{
+public:
+    // 分配跟踪的类别，由 MemoryStats::Scope 标记当前线程正在分配的内容
+    enum Category {
+        Other = 0,
+        Courses,
+        Tasks,
+        Snapshots,
+        Models,
+        Icons,
+        CategoryCount
+    };
+
+    struct Allocation {
+        qint64 bytes = 0;    // 当前仍存活的字节数
+        qint64 blocks = 0;   // 当前仍存活的分配块数
+        qint64 total = 0;    // 累计分配次数
+    };
+
+    // 作用域内当前线程的分配计入 category，可嵌套
+    class Scope
+    {
+    public:
+        explicit Scope(Category category) : m_previous(exchangeCategory(category)) {}
+        ~Scope() { exchangeCategory(m_previous); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        Category m_previous;
+    };
+
+    static QString categoryName(Category category);
+
+    static bool allocationTrackingAvailable();
+    // 本进程的峰值常驻内存（KB），不支持的平台返回 -1
+    static qint64 peakRssKb();
+    static Allocation allocation(Category category);
+
+    // 单个对象的估算
+    static qint64 stringBytes(const QString &text);
+    static qint64 courseBytes(const Course &course);
+    static qint64 courseStringBytes(const Course &course);
+    static qint64 taskBytes(const Task &task);
+    static qint64 taskStringBytes(const Task &task);
+    static qint64 courseRecordBytes();
+    static qint64 taskRecordBytes();
+
+    // 容器的估算：QVector/QList 按容量，QHash/QMap 按节点数
+    template <typename T>
+    static qint64 vectorBytes(const QVector<T> &vector)
+    {
+        return vector.capacity() > 0 ? ARRAY_HEADER_BYTES + qint64(vector.capacity()) * qint64(sizeof(T)) : 0;
+    }
+
+    template <typename T>
+    static qint64 vectorBytes(const ChunkedVector<T> &vector)
+    {
+        qint64 bytes = vectorBytes(vector.chunks()) + vectorBytes(vector.offsets());
+        for (const QVector<T> &chunk : vector.chunks()) {
+            bytes += vectorBytes(chunk);
+        }
+        return bytes;
+    }
+
+    template <typename Container>
+    static qint64 nodeBytes(const Container &container, qint64 payloadBytes)
+    {
+        return container.isEmpty() ? 0 : qint64(container.size()) * (NODE_OVERHEAD_BYTES + payloadBytes);
+    }
+
+    static const qint64 ARRAY_HEADER_BYTES = 24;     // QArrayData 头部
+    static const qint64 NODE_OVERHEAD_BYTES = 24;    // 哈希/红黑树节点的指针与哈希值
+    static const qint64 QOBJECT_PRIVATE_BYTES = 120; // QObjectPrivate 近似大小（64 位）
+    static const qint64 SHARED_PTR_BLOCK_BYTES = 16; // make_shared 控制块
+
+private:
+    static Category exchangeCategory(Category category);
+};
+
+// 一次统计的结果：每个子系统一行
+class MemoryReport
+{
+public:
+    struct Entry {
+        QString subsystem;
+        qint64 records = 0;
+        qint64 bytes = 0;
+        qint64 stringBytes = 0;   // bytes 中属于字符串数据的部分
+
+        qint64 bytesPerRecord() const { return records > 0 ? bytes / records : 0; }
+    };
+
+    void add(const QString &subsystem, qint64 records, qint64 bytes, qint64 stringBytes = 0);
+
+    const QVector<Entry> &entries() const { return m_entries; }
+    qint64 totalBytes() const;
+
+    // 文本表格，附带分配跟踪结果（若已编译开启）
+    QString toText() const;
+    QJsonObject toJson() const;
+
+private:
+    QVector<Entry> m_entries;
+};
+
+#endif // MEMORYSTATS_H
@@ -1,22 +1,40 @@
 #include "Notification.h"
+#include "TraceRecorder.h"
+#include "MemoryStats.h"
 #include "ScheduleManager.h"
+#include "IconCache.h"
 #include <QSettings>
+#include <QWidget>
+#include <QSet>
 #include <QDateTime>
 #include <QDebug>
-#include <QApplication>
-#include <QMessageBox>
-#include <QWidget>
+#include <algorithm>
+#include <functional>
+
+namespace {
+// 默认在截止前 3 天、1 天、2 小时提醒
+const QString DEFAULT_TASK_LEAD_MINUTES = "4320,1440,120";
+}
 
 Notification::Notification(ScheduleManager* scheduleMgr, QObject *parent)
-    : QObject(parent),m_scheduleMgr(scheduleMgr)
+    : QObject(parent),m_scheduleMgr(scheduleMgr),
+    m_taskMgr(nullptr),
+    m_taskWheel(currentMinute())
 {
     loadSettings();
     QSettings settings;
     m_reminderMinutes = settings.value("Notification/ReminderMinutes", 15).toInt();
     // 托盘图标
-    m_trayIcon = new QSystemTrayIcon(QIcon(":/icons/app_icon"), this);
+    m_trayIcon = new QSystemTrayIcon(IconCache::icon("app_icon"), this);
     m_trayIcon->show();
 
+    // 提醒队列：合并窗口与令牌桶限流
+    m_queue = new NotificationQueue(m_trayIcon, this);
+    m_queue->setFallbackWindow(qobject_cast<QWidget *>(parent));
+    m_queue->setCoalesceWindow(settings.value("Notification/CoalesceSeconds", 30).toInt());
+    m_queue->setRateLimit(settings.value("Notification/RateBurst", 3).toInt(),
+                          settings.value("Notification/RateRefillSeconds", 120).toInt());
+
     // 定时器：每分钟检查一次
     m_reminderTimer = new QTimer(this);
     connect(m_reminderTimer, &QTimer::timeout, this, &Notification::checkReminders);
@@ -43,6 +61,35 @@ void Notification::loadSettings()
     QSettings settings;  // now uses YourCompany/SmartScheduleAssistant
     m_isMuted         = settings.value("Notification/Muted", false).toBool();
     m_reminderMinutes = settings.value("Notification/ReminderMinutes", 30).toInt();
+
+    QVector<int> leads;
+    const QStringList parts = settings.value("Notification/TaskLeadMinutes",
+                                             DEFAULT_TASK_LEAD_MINUTES).toString().split(',');
+    for (const QString &part : parts) {
+        bool ok = false;
+        int minutes = part.trimmed().toInt(&ok);
+        if (ok && minutes > 0) {
+            leads.append(minutes);
+        }
+    }
+    std::sort(leads.begin(), leads.end(), std::greater<int>());
+    m_taskLeadMinutes = leads;
+
+    // 恢复已提醒记录，避免重启后重复弹出
+    m_notifiedKeys.fromByteArray(settings.value("Notification/NotifiedKeys").toByteArray(),
+                                 currentMinute());
+}
+
+void Notification::saveNotifiedKeys()
+{
+    QSettings settings;
+    settings.setValue("Notification/NotifiedKeys", m_notifiedKeys.toByteArray());
+}
+
+void Notification::resetNotifications()
+{
+    m_notifiedKeys.clear();
+    saveNotifiedKeys();
 }
 
 void Notification::saveSettings()
@@ -50,12 +97,21 @@ void Notification::saveSettings()
     QSettings settings;  // same file
     settings.setValue("Notification/Muted", m_isMuted);
     settings.setValue("Notification/ReminderMinutes", m_reminderMinutes);
+
+    QStringList parts;
+    for (int minutes : m_taskLeadMinutes) {
+        parts << QString::number(minutes);
+    }
+    settings.setValue("Notification/TaskLeadMinutes", parts.join(','));
     settings.sync();
 }
 void Notification::setMuted(bool muted)
 {
     if (m_isMuted == muted) return;
     m_isMuted = muted;
+    if (muted) {
+        m_queue->clear(); // 丢弃尚未弹出的提醒
+    }
     emit muteStateChanged(muted);
 }
 
@@ -76,6 +132,10 @@ void Notification::setReminderMinutes(int minutes)
 
 void Notification::checkReminders()
 {
+    TRACE_SCOPE_CAT("Notification::checkReminders", "timer");
+    // 任务提醒由时间轮驱动，静音时也要推进以丢弃过期项
+    checkTaskReminders();
+
     if (m_isMuted || !m_scheduleMgr) {  // 添加空指针检查
         return;
     }
@@ -91,26 +151,13 @@ void Notification::checkReminders()
         return;
     }
 
-    // 计算课程开始的具体日期时间
-    QDate today = QDate::currentDate();
-    int currentDayOfWeek = today.dayOfWeek(); // Qt: 1=周一, 7=周日
-
-    // 计算距离课程日期的天数
-    int daysDiff = next->dayOfWeek() - currentDayOfWeek;
-    if (daysDiff < 0) {
-        daysDiff += 7; // 处理跨周情况
-    }
-
-    QDate courseDate = today.addDays(daysDiff);
-    QTime startTime = ScheduleManager::getSectionStartTime(next->startSection());
-
-    if (!startTime.isValid()) {
-        qWarning() << "无效的课程开始时间: 节次" << next->startSection();
+    // 课程下一次上课的具体时刻，单双周课程按学期周次计算
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime courseStart = ScheduleManager::nextStartOf(*next, now, m_scheduleMgr->semesterStart());
+    if (!courseStart.isValid()) {
         return;
     }
-
-    QDateTime courseStart(courseDate, startTime);
-    QDateTime now = QDateTime::currentDateTime();
+    QDate courseDate = courseStart.date();
 
     // 计算剩余分钟数
     int secondsLeft = now.secsTo(courseStart);
@@ -125,11 +172,12 @@ void Notification::checkReminders()
         return; // 不在提醒时间范围内
     }
 
-    // 构造唯一键避免重复提醒（格式：日期_节次）
-    QString key = courseDate.toString("yyyyMMdd") + "_" +
-                  QString::number(next->startSection());
+    // 构造唯一键避免重复提醒（上课时刻+节次），课程开始后记录自动失效
+    qint64 startMinute = courseStart.toSecsSinceEpoch() / 60;
+    qint64 nowMinute = now.toSecsSinceEpoch() / 60;
+    quint64 key = ReminderDedup::courseKey(startMinute, next->startSection());
 
-    if (m_notifiedKeys.contains(key)) {
+    if (m_notifiedKeys.contains(key, nowMinute)) {
         return; // 已经提醒过此课程
     }
 
@@ -137,12 +185,13 @@ void Notification::checkReminders()
     qDebug() << "触发课程提醒:"
              << "课程:" << next->name()
              << "日期:" << courseDate.toString("yyyy-MM-dd")
-             << "时间:" << startTime.toString("hh:mm")
+             << "时间:" << courseStart.time().toString("hh:mm")
              << "剩余分钟:" << minutesLeft
              << "设置提醒时间:" << m_reminderMinutes;
 
     // 标记为已提醒
-    m_notifiedKeys.insert(key);
+    m_notifiedKeys.insert(key, startMinute, nowMinute);
+    saveNotifiedKeys();
 
     // 显示提醒
     showCourseReminder(next, minutesLeft);
@@ -163,16 +212,8 @@ void Notification::showCourseReminder(Course *course, int minutesLeft)
                       .arg(course->startSection())
                       .arg(course->endSection());
 
-    // 显示系统托盘通知
-    if (m_trayIcon->supportsMessages()) {
-        m_trayIcon->showMessage(title, msg, QSystemTrayIcon::Information, 5000);
-    }
-
-    // 如果主窗口可见，也显示消息框
-    QWidget *mainWindow = qApp->activeWindow();
-    if (mainWindow && mainWindow->isVisible()) {
-        QMessageBox::information(mainWindow, title, msg);
-    }
+    // 交给提醒队列，与同一时段的其他提醒合并，不再弹出阻塞的消息框
+    m_queue->enqueue(title, msg, QSystemTrayIcon::Information);
 }
 
 void Notification::showNotification(const QString &title, const QString &message, NotificationType type)
@@ -182,5 +223,159 @@ void Notification::showNotification(const QString &title, const QString &message
         (type==Warning? QSystemTrayIcon::Warning :
              type==Critical? QSystemTrayIcon::Critical :
              QSystemTrayIcon::Information);
-    m_trayIcon->showMessage(title, message, icon, 5000);
+    m_queue->enqueue(title, message, icon);
+}
+
+// 关联任务管理器，按任务的增删改维护时间轮
+void Notification::setTaskManager(TaskManager *taskMgr)
+{
+    if (m_taskMgr == taskMgr) return;
+
+    if (m_taskMgr) {
+        disconnect(m_taskMgr, nullptr, this, nullptr);
+    }
+    m_taskMgr = taskMgr;
+
+    if (m_taskMgr) {
+        connect(m_taskMgr, &TaskManager::tasksInserted, this, [this](int first, int last) {
+            const QList<Task*> &tasks = m_taskMgr->getAllTasks();
+            for (int i = first; i <= last; ++i) scheduleTaskReminders(tasks.at(i));
+        });
+        connect(m_taskMgr, &TaskManager::tasksAboutToBeRemoved, this, [this](int first, int last) {
+            const QList<Task*> &tasks = m_taskMgr->getAllTasks();
+            for (int i = first; i <= last; ++i) cancelTaskReminders(tasks.at(i));
+        });
+        connect(m_taskMgr, &TaskManager::taskUpdated, this, [this](int, Task *task) {
+            scheduleTaskReminders(task);
+        });
+        connect(m_taskMgr, &TaskManager::tasksReset, this, &Notification::rebuildTaskReminders);
+    }
+
+    rebuildTaskReminders();
+}
+
+void Notification::setTaskLeadMinutes(const QVector<int> &leads)
+{
+    QVector<int> sorted;
+    for (int minutes : leads) {
+        if (minutes > 0 && !sorted.contains(minutes)) {
+            sorted.append(minutes);
+        }
+    }
+    std::sort(sorted.begin(), sorted.end(), std::greater<int>());
+    if (sorted == m_taskLeadMinutes) return;
+
+    m_taskLeadMinutes = sorted;
+    saveSettings();
+    rebuildTaskReminders();
+}
+
+// 为任务登记各个提前量的提醒（已完成或已过的提醒时刻不登记）
+void Notification::scheduleTaskReminders(Task *task)
+{
+    if (!task) return;
+
+    cancelTaskReminders(task);
+    if (task->isCompleted()) {
+        return;
+    }
+
+    QDateTime due = taskDueDateTime(task);
+    if (!due.isValid()) {
+        return;
+    }
+
+    qint64 dueMinute = due.toSecsSinceEpoch() / 60;
+    qint64 now = m_taskWheel.currentMinute();
+    for (int lead : m_taskLeadMinutes) {
+        qint64 fireMinute = dueMinute - lead;
+        if (fireMinute > now) {
+            m_taskWheel.schedule(fireMinute, reinterpret_cast<quintptr>(task), lead);
+        }
+    }
+}
+
+void Notification::cancelTaskReminders(Task *task)
+{
+    m_taskWheel.cancelOwner(reinterpret_cast<quintptr>(task));
+}
+
+void Notification::rebuildTaskReminders()
+{
+    m_taskWheel.clear();
+    if (!m_taskMgr) return;
+
+    for (Task *task : m_taskMgr->getAllTasks()) {
+        scheduleTaskReminders(task);
+    }
+}
+
+// 推进时间轮并弹出到期的任务提醒
+void Notification::checkTaskReminders()
+{
+    const QVector<TimingWheel::Expired> fired = m_taskWheel.advanceTo(currentMinute());
+    if (fired.isEmpty() || m_isMuted) {
+        return;
+    }
+
+    // 同一任务同时到期多个提前量时，只提醒最近的一次
+    QSet<quintptr> shown;
+    for (int i = fired.size() - 1; i >= 0; --i) {
+        const TimingWheel::Expired &item = fired.at(i);
+        if (shown.contains(item.owner)) continue;
+        shown.insert(item.owner);
+
+        Task *task = reinterpret_cast<Task*>(item.owner);
+        QDateTime due = taskDueDateTime(task);
+        int minutesLeft = static_cast<int>(QDateTime::currentDateTime().secsTo(due) / 60);
+        if (minutesLeft < 0) continue;
+
+        showTaskReminder(task, minutesLeft);
+    }
+}
+
+void Notification::showTaskReminder(Task *task, int minutesLeft)
+{
+    QString remaining;
+    if (minutesLeft >= 24 * 60) {
+        remaining = QString("%1 天").arg(minutesLeft / (24 * 60));
+    } else if (minutesLeft >= 60) {
+        remaining = QString("%1 小时").arg(minutesLeft / 60);
+    } else {
+        remaining = QString("%1 分钟").arg(minutesLeft);
+    }
+
+    QString title = QString("%1即将截止：还剩 %2")
+                        .arg(task->isExam() ? "考试" : "任务")
+                        .arg(remaining);
+
+    QString msg = QString("任务：%1\n"
+                          "课程：%2\n"
+                          "截止：%3")
+                      .arg(task->title())
+                      .arg(task->courseName())
+                      .arg(taskDueDateTime(task).toString("yyyy-MM-dd hh:mm"));
+
+    qDebug() << "触发任务提醒:" << task->title() << "剩余分钟:" << minutesLeft;
+
+    showNotification(title, msg, task->isExam() ? Warning : Information);
+}
+
+// 任务截止时刻；未设置时间时按当天 23:59 计算
+QDateTime Notification::taskDueDateTime(const Task *task)
+{
+    QTime time = task->dueTime().isValid() ? task->dueTime() : QTime(23, 59);
+    return QDateTime(task->dueDate(), time);
+}
+
+qint64 Notification::currentMinute()
+{
+    return QDateTime::currentSecsSinceEpoch() / 60;
+}
+
+void Notification::reportMemory(MemoryReport &report) const
+{
+    // 去重表为固定容量的内嵌数组，与记录数无关
+    report.add("提醒去重表", m_notifiedKeys.size(), qint64(sizeof(ReminderDedup)));
+    report.add("任务提醒时间轮", m_taskWheel.size(), m_taskWheel.memoryBytes());
 }
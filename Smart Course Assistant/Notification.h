@@ -5,9 +5,16 @@
 #include <QSystemTrayIcon>
 #include <QTimer>
 #include <QTime>
-#include <QSet>
+#include <QDateTime>
+#include <QVector>
 #include "Course.h"
 #include "ScheduleManager.h"
+#include "TaskManager.h"
+#include "TimingWheel.h"
+#include "ReminderDedup.h"
+#include "NotificationQueue.h"
+
+class MemoryReport;
 
 enum NotificationType {
     Information,
@@ -26,9 +33,18 @@ public:
     // 设置提前提醒分钟数
     void setReminderMinutes(int minutes);
     int reminderMinutes() const { return m_reminderMinutes; }
-    void resetNotifications() { m_notifiedKeys.clear(); }
+    void resetNotifications();
     void checkReminders();
 
+    // 任务截止提醒
+    void setTaskManager(TaskManager *taskMgr);
+    void setTaskLeadMinutes(const QVector<int> &leads);
+    QVector<int> taskLeadMinutes() const { return m_taskLeadMinutes; }
+    int pendingTaskReminders() const { return m_taskWheel.size(); }
+
+    // 去重表与任务提醒时间轮的内存估算
+    void reportMemory(MemoryReport &report) const;
+
 
 signals:
     void muteStateChanged(bool muted);
@@ -37,14 +53,27 @@ signals:
 private:
     void loadSettings();
     void saveSettings();
+    void saveNotifiedKeys();
     void showCourseReminder(Course *course, int minutesLeft);
 
+    void scheduleTaskReminders(Task *task);
+    void cancelTaskReminders(Task *task);
+    void rebuildTaskReminders();
+    void checkTaskReminders();
+    void showTaskReminder(Task *task, int minutesLeft);
+    static QDateTime taskDueDateTime(const Task *task);
+    static qint64 currentMinute();
+
     QSystemTrayIcon *m_trayIcon;
+    NotificationQueue *m_queue;     // 合并与限流后再弹出
     QTimer *m_reminderTimer;
     bool m_isMuted;
     int m_reminderMinutes;
     ScheduleManager* m_scheduleMgr;
-    QSet<QString> m_notifiedKeys;   // 存储已提醒过的“日期+节次”
+    ReminderDedup m_notifiedKeys;   // 已提醒过的课程（上课时刻+节次），课程开始后自动失效
+    TaskManager* m_taskMgr;
+    QVector<int> m_taskLeadMinutes; // 任务截止前的提醒提前量（分钟）
+    TimingWheel m_taskWheel;        // 任务提醒时间轮，owner 为 Task 指针
 
     void showNotification(const QString &title, const QString &message, NotificationType type);
 };
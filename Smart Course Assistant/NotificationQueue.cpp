@@ -0,0 +1,160 @@
+#include "NotificationQueue.h"
+#include <QEvent>
+#include <QMessageBox>
+#include <QWidget>
+#include <cmath>
+
+namespace {
+const int DEFAULT_WINDOW_SECONDS = 30;
+const int DEFAULT_BURST = 3;
+const int DEFAULT_REFILL_SECONDS = 120;
+const int MAX_SUMMARY_LINES = 6;
+}
+
+NotificationQueue::NotificationQueue(QSystemTrayIcon *trayIcon, QObject *parent)
+    : QObject(parent),
+    m_trayIcon(trayIcon),
+    m_windowMs(DEFAULT_WINDOW_SECONDS * 1000),
+    m_burst(DEFAULT_BURST),
+    m_refillMs(DEFAULT_REFILL_SECONDS * 1000),
+    m_tokens(DEFAULT_BURST)
+{
+    m_flushTimer.setSingleShot(true);
+    connect(&m_flushTimer, &QTimer::timeout, this, &NotificationQueue::flush);
+    m_refillClock.start();
+}
+
+void NotificationQueue::setCoalesceWindow(int seconds)
+{
+    m_windowMs = qMax(0, seconds) * 1000;
+}
+
+void NotificationQueue::setRateLimit(int burst, int refillSeconds)
+{
+    refillTokens();
+    m_burst = qMax(1, burst);
+    m_refillMs = qMax(1, refillSeconds) * 1000;
+    m_tokens = qMin(m_tokens, static_cast<double>(m_burst));
+}
+
+void NotificationQueue::setFallbackWindow(QWidget *window)
+{
+    if (m_window) {
+        m_window->removeEventFilter(this);
+    }
+    m_window = window;
+    if (m_window) {
+        m_window->installEventFilter(this);
+    }
+}
+
+// 窗口重新显示时弹出隐藏期间积压的提醒
+bool NotificationQueue::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_window && event->type() == QEvent::Show
+        && !m_pending.isEmpty() && !m_flushTimer.isActive()) {
+        m_flushTimer.start(0);
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+// 加入队列，窗口结束时统一弹出
+void NotificationQueue::enqueue(const QString &title, const QString &message,
+                                QSystemTrayIcon::MessageIcon icon)
+{
+    m_pending.append({title, message, icon});
+    if (!m_flushTimer.isActive()) {
+        m_flushTimer.start(m_windowMs);
+    }
+}
+
+void NotificationQueue::clear()
+{
+    m_pending.clear();
+    m_flushTimer.stop();
+}
+
+void NotificationQueue::flush()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    // 暂时无处显示时保留在队列中，由窗口的显示事件重新触发
+    if (!canDeliver()) {
+        return;
+    }
+
+    // 没有令牌时推迟到下一个令牌恢复
+    refillTokens();
+    if (m_tokens < 1.0) {
+        int waitMs = static_cast<int>(std::ceil((1.0 - m_tokens) * m_refillMs));
+        m_flushTimer.start(qMax(1000, waitMs));
+        return;
+    }
+    m_tokens -= 1.0;
+
+    const QList<Item> items = m_pending;
+    m_pending.clear();
+
+    if (items.size() == 1) {
+        deliver(items.first().title, items.first().message, items.first().icon);
+        return;
+    }
+
+    // 多条提醒合并为一条汇总，取最高的严重级别
+    QSystemTrayIcon::MessageIcon icon = QSystemTrayIcon::Information;
+    QStringList lines;
+    for (const Item &item : items) {
+        if (item.icon == QSystemTrayIcon::Critical ||
+            (item.icon == QSystemTrayIcon::Warning && icon != QSystemTrayIcon::Critical)) {
+            icon = item.icon;
+        }
+        if (lines.size() < MAX_SUMMARY_LINES) {
+            lines << QString("• %1").arg(item.title);
+        }
+    }
+    if (items.size() > MAX_SUMMARY_LINES) {
+        lines << QString("……另有 %1 条").arg(items.size() - MAX_SUMMARY_LINES);
+    }
+
+    deliver(QString("您有 %1 条提醒").arg(items.size()), lines.join('\n'), icon);
+}
+
+void NotificationQueue::refillTokens()
+{
+    qint64 elapsed = m_refillClock.restart();
+    m_tokens = qMin(static_cast<double>(m_burst),
+                    m_tokens + static_cast<double>(elapsed) / m_refillMs);
+}
+
+bool NotificationQueue::canDeliver() const
+{
+    if (m_trayIcon && m_trayIcon->supportsMessages()) {
+        return true;
+    }
+    return m_window && m_window->isVisible();
+}
+
+void NotificationQueue::deliver(const QString &title, const QString &message,
+                                QSystemTrayIcon::MessageIcon icon)
+{
+    emit delivered(title, message);
+
+    if (m_trayIcon && m_trayIcon->supportsMessages()) {
+        m_trayIcon->showMessage(title, message, icon, 5000);
+        return;
+    }
+
+    // 托盘不支持气泡时，在主窗口上弹出非模态提示（不要求主窗口处于激活状态）
+    QMessageBox::Icon boxIcon = QMessageBox::Information;
+    if (icon == QSystemTrayIcon::Critical) {
+        boxIcon = QMessageBox::Critical;
+    } else if (icon == QSystemTrayIcon::Warning) {
+        boxIcon = QMessageBox::Warning;
+    }
+    QMessageBox *box = new QMessageBox(boxIcon, title, message, QMessageBox::Ok, m_window);
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->setModal(false);
+    box->show();
+}
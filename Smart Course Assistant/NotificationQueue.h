@@ -0,0 +1,70 @@
+#ifndef NOTIFICATIONQUEUE_H
+#define NOTIFICATIONQUEUE_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QSystemTrayIcon>
+
+class QWidget;
+
+// 通知队列：合并时间窗口内的提醒为一条汇总，并用令牌桶限制弹出频率
+// 所有提示均为非阻塞方式，不会打开模态对话框
+class NotificationQueue : public QObject
+{
+    Q_OBJECT
+public:
+    explicit NotificationQueue(QSystemTrayIcon *trayIcon, QObject *parent = nullptr);
+
+    // 合并窗口（秒），0 表示不等待
+    void setCoalesceWindow(int seconds);
+    int coalesceWindow() const { return m_windowMs / 1000; }
+
+    // 令牌桶：最多连续弹出 burst 条，之后每 refillSeconds 秒恢复一条
+    void setRateLimit(int burst, int refillSeconds);
+
+    // 托盘不支持气泡时在该窗口上显示提示；窗口隐藏期间提醒保留在队列中，窗口显示后再弹出
+    void setFallbackWindow(QWidget *window);
+
+    void enqueue(const QString &title, const QString &message,
+                 QSystemTrayIcon::MessageIcon icon = QSystemTrayIcon::Information);
+    void clear();
+    int pendingCount() const { return m_pending.size(); }
+
+signals:
+    void delivered(const QString &title, const QString &message);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private slots:
+    void flush();
+
+private:
+    struct Item {
+        QString title;
+        QString message;
+        QSystemTrayIcon::MessageIcon icon;
+    };
+
+    void refillTokens();
+    bool canDeliver() const;
+    void deliver(const QString &title, const QString &message,
+                 QSystemTrayIcon::MessageIcon icon);
+
+    QSystemTrayIcon *m_trayIcon;
+    QPointer<QWidget> m_window;
+    QTimer m_flushTimer;
+    QList<Item> m_pending;
+    int m_windowMs;
+    int m_burst;
+    int m_refillMs;
+    double m_tokens;
+    QElapsedTimer m_refillClock;
+};
+
+#endif // NOTIFICATIONQUEUE_H
@@ -0,0 +1,91 @@
+#include "OccurrenceTimeline.h"
+#include <algorithm>
+
+OccurrenceTimeline::OccurrenceTimeline(ScheduleManager *scheduleManager, QObject *parent)
+    : QObject(parent),
+    m_scheduleManager(scheduleManager),
+    m_weeks(0)
+{
+    if (m_scheduleManager) {
+        connect(m_scheduleManager, &ScheduleManager::coursesChanged, this, &OccurrenceTimeline::rebuild);
+        connect(m_scheduleManager, &ScheduleManager::coursesReset, this, &OccurrenceTimeline::rebuild);
+    }
+    rebuild();
+}
+
+void OccurrenceTimeline::setSemester(const QDate &firstMonday, int weeks)
+{
+    QDate monday = firstMonday.isValid() ? firstMonday.addDays(1 - firstMonday.dayOfWeek()) : QDate();
+    if (monday == m_firstMonday && weeks == m_weeks) return;
+
+    m_firstMonday = monday;
+    m_weeks = qMax(0, weeks);
+    emit changed();
+}
+
+int OccurrenceTimeline::weekOf(const QDate &date) const
+{
+    if (!m_firstMonday.isValid() || !date.isValid()) return -1;
+
+    qint64 days = m_firstMonday.daysTo(date);
+    if (days < 0) return -1;
+
+    int week = static_cast<int>(days / 7);
+    return week < m_weeks ? week : -1;
+}
+
+QVector<OccurrenceTimeline::Occurrence> OccurrenceTimeline::occurrencesOn(const QDate &date) const
+{
+    QVector<Occurrence> result;
+    if (!date.isValid()) return result;
+    int week = weekOf(date);
+    if (week < 0 && hasSemester()) return result;
+
+    const QVector<Course*> &courses = m_byDay[date.dayOfWeek() - 1];
+    result.reserve(courses.size());
+    for (Course *course : courses) {
+        // 未设置学期时不知道周次，单双周课程也照常列出
+        if (week >= 0 && !course->occursInWeek(week + 1)) continue;
+        Occurrence occurrence;
+        occurrence.date = date;
+        occurrence.course = course;
+        occurrence.startSection = course->startSection();
+        occurrence.endSection = course->endSection();
+        result.append(occurrence);
+    }
+    return result;
+}
+
+QVector<OccurrenceTimeline::Occurrence> OccurrenceTimeline::occurrencesBetween(const QDate &from,
+                                                                               const QDate &to) const
+{
+    QVector<Occurrence> result;
+    for (QDate date = from; date <= to; date = date.addDays(1)) {
+        result += occurrencesOn(date);
+    }
+    return result;
+}
+
+// 课程变化时重新按星期分组
+void OccurrenceTimeline::rebuild()
+{
+    for (QVector<Course*> &day : m_byDay) {
+        day.clear();
+    }
+
+    if (m_scheduleManager) {
+        for (Course *course : m_scheduleManager->getAllCourses()) {
+            int day = course->dayOfWeek();
+            if (day >= 1 && day <= 7) {
+                m_byDay[day - 1].append(course);
+            }
+        }
+    }
+
+    for (QVector<Course*> &day : m_byDay) {
+        std::sort(day.begin(), day.end(), [](Course *a, Course *b) {
+            return a->startSection() < b->startSection();
+        });
+    }
+    emit changed();
+}
@@ -0,0 +1,47 @@
+#ifndef OCCURRENCETIMELINE_H
+#define OCCURRENCETIMELINE_H
+
+#include <QObject>
+#include <QDate>
+#include <QVector>
+#include "ScheduleManager.h"
+
+// 课程时间线：把每周重复的课程展开为具体日期上的上课记录
+// 按星期预先排好序，查询某天时不再扫描 ScheduleManager
+class OccurrenceTimeline : public QObject
+{
+    Q_OBJECT
+public:
+    struct Occurrence {
+        QDate date;
+        Course *course = nullptr;
+        int startSection = 0;
+        int endSection = 0;
+    };
+
+    explicit OccurrenceTimeline(ScheduleManager *scheduleManager, QObject *parent = nullptr);
+
+    // 学期范围：从 firstMonday 所在周开始共 weeks 周，范围外的日期没有课程
+    // firstMonday 无效表示尚未设置学期：每周都显示全部课程，不区分单双周
+    void setSemester(const QDate &firstMonday, int weeks);
+    bool hasSemester() const { return m_firstMonday.isValid() && m_weeks > 0; }
+    QDate semesterStart() const { return m_firstMonday; }
+    int semesterWeeks() const { return m_weeks; }
+    int weekOf(const QDate &date) const;   // 学期第几周（从0开始），范围外或未设置学期时返回 -1
+
+    QVector<Occurrence> occurrencesOn(const QDate &date) const;
+    QVector<Occurrence> occurrencesBetween(const QDate &from, const QDate &to) const;
+
+signals:
+    void changed();
+
+private:
+    void rebuild();
+
+    ScheduleManager *m_scheduleManager;
+    QVector<Course*> m_byDay[7];     // 周一到周日，按开始节次排序
+    QDate m_firstMonday;
+    int m_weeks;
+};
+
+#endif // OCCURRENCETIMELINE_H
@@ -0,0 +1,190 @@
+#include "ProfileImporter.h"
+#include "Course.h"
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+
+namespace {
+const int COURSE_FIELDS = 8;
+const int TASK_FIELDS = 7;
+}
+
+ProfileImporter::Result ProfileImporter::importProfile(const QString &csvPath, const QString &outDir)
+{
+    ScheduleSnapshot courses;
+    TaskSnapshot tasks;
+    Result result = parseProfile(csvPath, courses, tasks);
+    if (!result.ok()) {
+        return result;
+    }
+
+    // 每个档案写入各自的目录，互不影响
+    QDir dir(QDir(outDir).filePath(result.profile));
+    if (!dir.exists() && !dir.mkpath(".")) {
+        result.errors << QString("无法创建目录: %1").arg(dir.path());
+        return result;
+    }
+    if (!ScheduleManager::writeCourses(dir.filePath("schedule.dat"), courses)) {
+        result.errors << "写入 schedule.dat 失败";
+    }
+    if (!TaskManager::writeTasks(dir.filePath("tasks.dat"), tasks)) {
+        result.errors << "写入 tasks.dat 失败";
+    }
+    return result;
+}
+
+ProfileImporter::Result ProfileImporter::parseProfile(const QString &csvPath,
+                                                      ScheduleSnapshot &courses, TaskSnapshot &tasks)
+{
+    Result result;
+    result.profile = QFileInfo(csvPath).completeBaseName();
+
+    QFile file(csvPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        result.errors << QString("无法打开文件: %1").arg(csvPath);
+        return result;
+    }
+
+    QTextStream in(&file);
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    in.setCodec("UTF-8");
+#endif
+
+    // 冲突检测与 ScheduleManager::addCourse 使用同一规则
+    QList<Course*> accepted;
+    int lineNumber = 0;
+    while (!in.atEnd()) {
+        QString line = in.readLine();
+        ++lineNumber;
+        if (line.trimmed().isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        QStringList fields = splitCsvLine(line);
+        QString type = fields.value(0).trimmed().toLower();
+        QString where = QString("第%1行").arg(lineNumber);
+
+        if (type == "course") {
+            if (fields.size() < COURSE_FIELDS) {
+                result.errors << where + ": 课程字段不足";
+                continue;
+            }
+            bool dayOk = false, startOk = false, endOk = false;
+            int day = fields.at(2).toInt(&dayOk);
+            int start = fields.at(3).toInt(&startOk);
+            int end = fields.at(4).toInt(&endOk);
+            QString name = fields.at(1).trimmed();
+            if (name.isEmpty()) {
+                result.errors << where + ": 课程名为空";
+                continue;
+            }
+            if (!dayOk || day < 1 || day > 7) {
+                result.errors << where + ": 无效的星期 " + fields.at(2);
+                continue;
+            }
+            if (!startOk || !endOk || start < 1 || end < start || end > Course::MAX_SECTION) {
+                result.errors << where + QString(": 无效的节次范围 %1-%2").arg(fields.at(3), fields.at(4));
+                continue;
+            }
+
+            Course *course = new Course(name, day, start, end, fields.at(5).trimmed());
+            course->setTeacher(fields.at(6).trimmed());
+            course->setNote(fields.at(7).trimmed());
+            if (fields.size() > COURSE_FIELDS) {
+                bool parityOk = false;
+                int parity = fields.at(8).trimmed().toInt(&parityOk);
+                if (!parityOk || parity < Course::EveryWeek || parity > Course::EvenWeeks) {
+                    result.errors << where + ": 无效的周次 " + fields.at(8);
+                    delete course;
+                    continue;
+                }
+                course->setWeekParity(parity);
+            }
+
+            bool conflict = false;
+            for (const Course *existing : std::as_const(accepted)) {
+                if (existing->hasTimeConflictWith(*course)) {
+                    result.errors << where + QString(": 与课程“%1”时间冲突").arg(existing->name());
+                    conflict = true;
+                    break;
+                }
+            }
+            if (conflict) {
+                delete course;
+                continue;
+            }
+            accepted.append(course);
+            courses.items.append(std::make_shared<const CourseRecord>(CourseRecord::fromCourse(*course)));
+        } else if (type == "task") {
+            if (fields.size() < TASK_FIELDS) {
+                result.errors << where + ": 任务字段不足";
+                continue;
+            }
+            TaskRecord task;
+            task.title = fields.at(1).trimmed();
+            task.courseName = fields.at(2).trimmed();
+            task.dueDate = QDate::fromString(fields.at(3).trimmed(), "yyyy-MM-dd");
+            QString time = fields.at(4).trimmed();
+            task.dueTime = time.isEmpty() ? QTime() : QTime::fromString(time, "HH:mm");
+            task.exam = fields.at(5).trimmed() == "1";
+            task.description = fields.at(6).trimmed();
+
+            if (task.title.isEmpty()) {
+                result.errors << where + ": 任务标题为空";
+                continue;
+            }
+            if (!task.dueDate.isValid()) {
+                result.errors << where + ": 无效的截止日期 " + fields.at(3);
+                continue;
+            }
+            if (!time.isEmpty() && !task.dueTime.isValid()) {
+                result.errors << where + ": 无效的截止时间 " + time;
+                continue;
+            }
+            tasks.items.append(std::make_shared<const TaskRecord>(task));
+        } else {
+            result.errors << where + ": 未知的记录类型 " + fields.value(0);
+        }
+    }
+
+    qDeleteAll(accepted);
+    result.courseCount = courses.items.size();
+    result.taskCount = tasks.items.size();
+    return result;
+}
+
+// 拆分一行 CSV，支持双引号包裹的字段和 "" 转义
+QStringList ProfileImporter::splitCsvLine(const QString &line)
+{
+    QStringList fields;
+    QString field;
+    bool quoted = false;
+
+    for (int i = 0; i < line.size(); ++i) {
+        QChar c = line.at(i);
+        if (quoted) {
+            if (c == '"') {
+                if (i + 1 < line.size() && line.at(i + 1) == '"') {
+                    field += '"';
+                    ++i;
+                } else {
+                    quoted = false;
+                }
+            } else {
+                field += c;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            fields << field;
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    fields << field;
+    return fields;
+}
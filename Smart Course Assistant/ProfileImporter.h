@@ -0,0 +1,32 @@
+#ifndef PROFILEIMPORTER_H
+#define PROFILEIMPORTER_H
+
+#include <QString>
+#include <QStringList>
+#include "Snapshot.h"
+
+// 教务导出文件导入：一个学生一个 CSV 文件，每行一条记录
+//   course,课程名,星期(1-7),开始节次,结束节次,教室,教师,备注[,周次(0每周/1单周/2双周)]
+//   task,标题,课程名,截止日期(yyyy-MM-dd),截止时间(HH:mm，可空),是否考试(0/1),描述
+// 以 # 开头的行和空行会被忽略。不依赖任何共享状态，可在多个工作线程中同时调用
+class ProfileImporter
+{
+public:
+    struct Result {
+        QString profile;        // 档案名（CSV 文件名，不含扩展名）
+        int courseCount = 0;
+        int taskCount = 0;
+        QStringList errors;     // 带行号的错误信息，非空时不写出数据文件
+        bool ok() const { return errors.isEmpty(); }
+    };
+
+    // 解析并校验 csvPath，成功时写出 outDir/<档案名>/schedule.dat 与 tasks.dat
+    static Result importProfile(const QString &csvPath, const QString &outDir);
+
+    // 仅解析与校验，不写文件
+    static Result parseProfile(const QString &csvPath, ScheduleSnapshot &courses, TaskSnapshot &tasks);
+
+    static QStringList splitCsvLine(const QString &line);
+};
+
+#endif // PROFILEIMPORTER_H
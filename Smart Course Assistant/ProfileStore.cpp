@@ -0,0 +1,401 @@
+#include "ProfileStore.h"
+#include "MemoryStats.h"
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRegularExpression>
+#include <QThreadPool>
+
+namespace {
+
+const char CATALOG_FILE[] = "catalog.json";
+const char TIMETABLE_FILE[] = "timetable.json";
+const char SCHEDULE_FILE[] = "schedule.dat";
+const char TASKS_FILE[] = "tasks.dat";
+
+} // namespace
+
+ProfileStore::ProfileStore(const QString &rootDir, qint64 budgetBytes)
+    : m_rootDir(rootDir),
+    m_budgetBytes(budgetBytes),
+    m_totalBytes(0),
+    m_generation(0),
+    m_hits(0),
+    m_loads(0),
+    m_evictions(0)
+{
+    m_catalog.setStringPool(&m_strings);
+    reloadCatalogIfChanged();
+}
+
+// ID 直接作为目录名，只允许不以点开头的字母、数字和 _ . -
+bool ProfileStore::isValidId(const QString &studentId)
+{
+    static const QRegularExpression pattern("^[A-Za-z0-9_][A-Za-z0-9_.-]{0,63}$");
+    return pattern.match(studentId).hasMatch();
+}
+
+std::shared_ptr<const ScheduleIndex> ProfileStore::index(const QString &studentId, QString *error,
+                                                        bool *loading)
+{
+    if (loading) {
+        *loading = false;
+    }
+    if (!isValidId(studentId)) {
+        if (error) {
+            *error = "无效的学生 ID: " + studentId;
+        }
+        return nullptr;
+    }
+    reloadCatalogIfChanged();
+
+    // 后台读取已完成：换上新数据；重新读取失败时继续使用旧数据
+    auto pending = m_pending.constFind(studentId);
+    if (pending != m_pending.constEnd() && (*pending)->isFinished()) {
+        QString loadError;
+        if (!finishLoad(studentId, &loadError) && !m_profiles.contains(studentId)) {
+            if (error) {
+                *error = loadError;
+            }
+            return nullptr;
+        }
+    }
+
+    auto it = m_profiles.find(studentId);
+    if (it != m_profiles.end()) {
+        ++m_hits;
+        touch(*it);
+        // 文件已更新：在后台重新读取，读完之前仍回答旧数据
+        if (!m_pending.contains(studentId) && isStale(studentId, *it)) {
+            startLoad(studentId);
+        }
+        // 目录有变化时只重新解析课表
+        if (it->catalogVersion != m_catalog.version()) {
+            m_totalBytes -= it->bytes;
+            buildIndex(studentId, *it);
+            m_totalBytes += it->bytes;
+            std::shared_ptr<const ScheduleIndex> result = it->index;
+            evict();
+            return result;
+        }
+        return it->index;
+    }
+
+    if (!m_pending.contains(studentId)) {
+        if (!QDir(QDir(m_rootDir).filePath(studentId)).exists()) {
+            if (error) {
+                *error = "未知的学生: " + studentId;
+            }
+            return nullptr;
+        }
+        if (m_pending.size() >= MAX_PENDING_LOADS) {
+            if (loading) {
+                *loading = true;
+            }
+            if (error) {
+                *error = "正在加载的用户过多，请稍后重试";
+            }
+            return nullptr;
+        }
+        startLoad(studentId);
+    }
+
+    // 数据量小的用户通常很快读完，稍等片刻，免得客户端为此重试
+    std::shared_ptr<PendingLoad> load = m_pending.value(studentId);
+    if (!load->done.tryAcquire(1, COLD_LOAD_WAIT_MS)) {
+        if (loading) {
+            *loading = true;
+        }
+        if (error) {
+            *error = QString("正在加载 %1 的数据，请稍后重试").arg(studentId);
+        }
+        return nullptr;
+    }
+    load->done.release();
+    if (!finishLoad(studentId, error)) {
+        return nullptr;
+    }
+    return m_profiles.value(studentId).index;
+}
+
+// 只读取文件，不接触目录和字符串池，可在任意线程中运行
+// 复用 ScheduleManager/TaskManager 的读取与校验，读出的对象转换为记录后即释放
+void ProfileStore::readProfile(const QString &studentId, const QString &dirPath, LoadResult &result)
+{
+    QDir dir(dirPath);
+    QFileInfo timetableInfo(dir.filePath(TIMETABLE_FILE));
+    QFileInfo scheduleInfo(dir.filePath(SCHEDULE_FILE));
+    QFileInfo tasksInfo(dir.filePath(TASKS_FILE));
+    result.timetableModified = timetableInfo.lastModified();
+    result.scheduleModified = scheduleInfo.lastModified();
+    result.tasksModified = tasksInfo.lastModified();
+    QString readError;
+
+    // 学生更新了旧格式的 schedule.dat 时重新迁移，否则直接使用上次迁移或手工编写的 timetable.json
+    if (timetableInfo.exists()
+        && !(scheduleInfo.exists() && scheduleInfo.lastModified() > timetableInfo.lastModified())) {
+        result.hasTimetable = true;
+        if (!CourseCatalog::loadTimetable(timetableInfo.filePath(), result.timetable, &readError)) {
+            result.error = QString("无法读取 %1 的课表: %2").arg(studentId, readError);
+            return;
+        }
+    } else if (scheduleInfo.exists()) {
+        QList<Course*> courses;
+        if (!ScheduleManager::readCourses(scheduleInfo.filePath(), courses, nullptr, &readError)) {
+            qDeleteAll(courses);
+            result.error = QString("无法读取 %1 的课程: %2").arg(studentId, readError);
+            return;
+        }
+        if (!readError.isEmpty()) {
+            qWarning() << studentId << "的课程文件已损坏，只加载了前" << courses.size() << "门:" << readError;
+        }
+        result.courses.reserve(courses.size());
+        for (const Course *course : std::as_const(courses)) {
+            result.courses.append(CourseRecord::fromCourse(*course));
+        }
+        qDeleteAll(courses);
+    }
+
+    QList<Task*> tasks;
+    readError.clear();
+    if (tasksInfo.exists()) {
+        QFile file(tasksInfo.filePath());
+        if (!file.open(QIODevice::ReadOnly) || !TaskManager::readTasks(&file, tasks, nullptr, &readError)) {
+            qDeleteAll(tasks);
+            result.error = QString("无法读取 %1 的任务: %2").arg(studentId, readError);
+            return;
+        }
+    }
+    if (!readError.isEmpty()) {
+        qWarning() << studentId << "的任务文件已损坏，只加载了前" << tasks.size() << "项:" << readError;
+    }
+    result.tasks.reserve(tasks.size());
+    for (const Task *task : std::as_const(tasks)) {
+        result.tasks.append(TaskRecord::fromTask(*task));
+    }
+    qDeleteAll(tasks);
+    result.ok = true;
+}
+
+// 读取任务只引用共享的 PendingLoad，不引用 ProfileStore 本身
+void ProfileStore::startLoad(const QString &studentId)
+{
+    auto load = std::make_shared<PendingLoad>();
+    m_pending.insert(studentId, load);
+    const QString dirPath = QDir(m_rootDir).filePath(studentId);
+    QThreadPool::globalInstance()->start([load, studentId, dirPath]() {
+        readProfile(studentId, dirPath, load->result);
+        load->done.release();
+    });
+}
+
+bool ProfileStore::finishLoad(const QString &studentId, QString *error)
+{
+    std::shared_ptr<PendingLoad> load = m_pending.take(studentId);
+    if (!load->result.ok) {
+        qWarning() << load->result.error;
+        if (error) {
+            *error = load->result.error;
+        }
+        return false;
+    }
+    install(studentId, load->result);
+    return true;
+}
+
+// 在服务线程中把读出的记录接入目录和字符串池，替换已有的数据
+// 迁移的结果写回 timetable.json，之后的冷加载按 ID 引用，不再逐门匹配，也不会重复生成 auto- 课程
+void ProfileStore::install(const QString &studentId, const LoadResult &result)
+{
+    Profile profile;
+    profile.timetableModified = result.timetableModified;
+    if (result.hasTimetable) {
+        profile.timetable = result.timetable;
+    } else {
+        profile.timetable = m_catalog.toTimetable(result.courses);
+        QString path = QDir(QDir(m_rootDir).filePath(studentId)).filePath(TIMETABLE_FILE);
+        if (CourseCatalog::saveTimetable(path, profile.timetable)) {
+            profile.timetableModified = QFileInfo(path).lastModified();
+        }
+    }
+    m_catalog.retain(profile.timetable);
+
+    auto taskSnapshot = std::make_shared<TaskSnapshot>();
+    taskSnapshot->version = ++m_generation;
+    qint64 taskBytes = 0;
+    for (TaskRecord record : result.tasks) {
+        record.courseName = m_strings.intern(record.courseName);
+        record.title = m_strings.intern(record.title);
+        taskBytes += MemoryStats::taskRecordBytes() + MemoryStats::stringBytes(record.description);
+        taskSnapshot->items.append(std::make_shared<const TaskRecord>(record));
+    }
+
+    // 指针数组：任务快照与未完成任务的索引各一份
+    profile.taskBytes = qint64(sizeof(TaskSnapshot)) + MemoryStats::SHARED_PTR_BLOCK_BYTES
+                        + 2 * MemoryStats::vectorBytes(taskSnapshot->items) + taskBytes;
+    profile.tasks = taskSnapshot;
+    profile.scheduleModified = result.scheduleModified;
+    profile.tasksModified = result.tasksModified;
+    profile.checked.start();
+    buildIndex(studentId, profile);
+    ++m_loads;
+
+    auto it = m_profiles.find(studentId);
+    if (it != m_profiles.end()) {
+        m_totalBytes -= it->bytes;
+        m_catalog.release(it->timetable);
+        profile.lru = it->lru;
+        *it = profile;
+        touch(*it);
+        m_catalog.dropUnreferenced();
+    } else {
+        m_lru.push_front(studentId);
+        profile.lru = m_lru.begin();
+        m_profiles.insert(studentId, profile);
+    }
+    m_totalBytes += profile.bytes;
+    evict();
+}
+
+// 按当前目录解析课表并重建索引；课程记录和驻留的字符串由所有用户共用，不计入单个用户
+void ProfileStore::buildIndex(const QString &studentId, Profile &profile)
+{
+    CourseCatalog::DataPtr catalog = m_catalog.current();
+    int missing = 0;
+    auto schedule = std::make_shared<ScheduleSnapshot>();
+    schedule->items = CourseCatalog::resolve(*catalog, profile.timetable, &missing);
+    if (missing > 0) {
+        qWarning() << studentId << "的课表中有" << missing << "门课程已不在目录中";
+    }
+
+    // 每次解析都使用新的版本号，ETag 随之变化
+    schedule->version = ++m_generation;
+    profile.index = std::make_shared<const ScheduleIndex>(schedule, profile.tasks);
+    profile.catalogVersion = catalog->version;
+
+    // 只有带覆盖项的课程单独占用一条记录
+    qint64 overrideBytes = 0;
+    for (const TimetableEntry &entry : std::as_const(profile.timetable)) {
+        overrideBytes += MemoryStats::stringBytes(entry.note);
+        if (entry.color.isValid() || !entry.note.isEmpty()) {
+            overrideBytes += MemoryStats::courseRecordBytes();
+        }
+    }
+    // 指针数组：快照与按星期分组的索引各一份
+    profile.bytes = profile.taskBytes + qint64(sizeof(ScheduleIndex)) + qint64(sizeof(ScheduleSnapshot))
+                    + 2 * MemoryStats::SHARED_PTR_BLOCK_BYTES
+                    + MemoryStats::vectorBytes(profile.timetable)
+                    + 2 * MemoryStats::vectorBytes(schedule->items)
+                    + overrideBytes;
+}
+
+bool ProfileStore::isStale(const QString &studentId, Profile &profile) const
+{
+    if (!profile.checked.hasExpired(RECHECK_INTERVAL_MS)) {
+        return false;
+    }
+    profile.checked.restart();
+    QDir dir(QDir(m_rootDir).filePath(studentId));
+    return QFileInfo(dir.filePath(TIMETABLE_FILE)).lastModified() != profile.timetableModified
+           || QFileInfo(dir.filePath(SCHEDULE_FILE)).lastModified() != profile.scheduleModified
+           || QFileInfo(dir.filePath(TASKS_FILE)).lastModified() != profile.tasksModified;
+}
+
+// 教务修改 catalog.json 后合并到目录中，引用它的用户在下次查询时得到新内容
+void ProfileStore::reloadCatalogIfChanged()
+{
+    if (m_catalogChecked.isValid() && !m_catalogChecked.hasExpired(RECHECK_INTERVAL_MS)) {
+        return;
+    }
+    m_catalogChecked.start();
+
+    QFileInfo info(QDir(m_rootDir).filePath(CATALOG_FILE));
+    if (!info.exists() || info.lastModified() == m_catalogModified) {
+        return;
+    }
+    QString error;
+    if (!m_catalog.loadJson(info.filePath(), &error)) {
+        qWarning() << "无法读取课程目录" << info.filePath() << ":" << error;
+        return;
+    }
+    m_catalogModified = info.lastModified();
+    m_catalog.dropUnreferenced();
+}
+
+void ProfileStore::touch(Profile &profile)
+{
+    m_lru.splice(m_lru.begin(), m_lru, profile.lru);
+}
+
+qint64 ProfileStore::sharedBytes() const
+{
+    return m_catalog.bytes() + m_strings.bytes();
+}
+
+// 先移除无人引用的 auto- 课程，它们的字符串随后才能释放；再释放不再被任何用户引用的字符串
+void ProfileStore::purgeShared()
+{
+    m_catalog.dropUnreferenced();
+    m_strings.purgeUnused();
+}
+
+void ProfileStore::unload(const QString &studentId)
+{
+    auto it = m_profiles.find(studentId);
+    if (it == m_profiles.end()) {
+        return;
+    }
+    m_lru.erase(it->lru);
+    m_totalBytes -= it->bytes;
+    m_catalog.release(it->timetable);
+    m_profiles.erase(it);
+}
+
+// 预算包含共用部分：共用部分只有清理后才会变小，因此先清理一次；仍超出时按最近最少使用的顺序
+// 卸载到用户数据不超过剩余预算，再清理并重新核算。至少保留刚使用的用户，即使它本身就超出预算
+void ProfileStore::evict()
+{
+    if (m_totalBytes + sharedBytes() <= m_budgetBytes) {
+        return;
+    }
+    purgeShared();
+    while (m_totalBytes + sharedBytes() > m_budgetBytes && m_lru.size() > 1) {
+        const qint64 target = m_budgetBytes - sharedBytes();
+        while (m_totalBytes > target && m_lru.size() > 1) {
+            QString studentId = m_lru.back();
+            unload(studentId);
+            ++m_evictions;
+        }
+        purgeShared();
+    }
+}
+
+ProfileStore::Stats ProfileStore::stats() const
+{
+    Stats stats;
+    stats.profiles = m_profiles.size();
+    stats.bytes = m_totalBytes;
+    stats.sharedBytes = sharedBytes();
+    stats.budgetBytes = m_budgetBytes;
+    stats.loading = m_pending.size();
+    stats.hits = m_hits;
+    stats.loads = m_loads;
+    stats.evictions = m_evictions;
+    stats.catalogSections = m_catalog.size();
+    stats.catalogVersion = m_catalog.version();
+    stats.internedStrings = m_strings.size();
+    return stats;
+}
+
+void ProfileStore::reportMemory(MemoryReport &report) const
+{
+    report.add("用户数据", m_profiles.size(), m_totalBytes);
+
+    m_catalog.reportMemory(report);
+
+    qint64 stringBytes = m_strings.bytes();
+    report.add("字符串池", m_strings.size(), stringBytes, stringBytes);
+}
@@ -0,0 +1,120 @@
+#ifndef PROFILESTORE_H
+#define PROFILESTORE_H
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QSemaphore>
+#include <QString>
+#include <list>
+#include <memory>
+#include "CourseCatalog.h"
+#include "ScheduleIndex.h"
+#include "StringPool.h"
+
+class MemoryReport;
+
+// 多用户数据：按需从 <根目录>/<学生ID>/ 加载，构建只读查询索引
+// 课程来自共用的课程目录（<根目录>/catalog.json）：学生目录中有 timetable.json 时按其中的 ID 引用，
+// 没有或 schedule.dat 更新时读取 schedule.dat 并按内容匹配目录中的课程，结果写回 timetable.json；
+// 目录中没有的课程生成 auto- 课程，按引用它的已加载用户计数，无人引用时从目录移除；任务读取 tasks.dat
+// 目录更新后，已加载的用户在下次查询时重新解析课表，不必重新读取文件
+// 文件在线程池中读取，服务线程不因个别用户的冷加载停顿；文件更新后读完新数据前继续使用旧数据
+// 内存预算按总占用计算（用户数据加上共用的课程目录和字符串池），超出时先清理共用部分，
+// 再按最近最少使用的顺序卸载；不是线程安全的，由服务线程独占使用
+class ProfileStore
+{
+public:
+    struct Stats {
+        int profiles = 0;
+        qint64 bytes = 0;           // 已加载用户的估算占用，不含共用的课程和字符串
+        qint64 sharedBytes = 0;     // 共用的课程目录和字符串池，与 bytes 一起计入预算
+        qint64 budgetBytes = 0;
+        int loading = 0;            // 正在后台读取的用户数
+        quint64 hits = 0;
+        quint64 loads = 0;
+        quint64 evictions = 0;
+        int catalogSections = 0;
+        quint64 catalogVersion = 0;
+        int internedStrings = 0;
+    };
+
+    ProfileStore(const QString &rootDir, qint64 budgetBytes);
+
+    // 取得学生的查询索引，磁盘上的文件更新后会重新加载；失败时返回空指针并给出原因
+    // 首次加载未能在 COLD_LOAD_WAIT_MS 内读完时返回空指针并置 loading，调用者稍后重试即可
+    std::shared_ptr<const ScheduleIndex> index(const QString &studentId, QString *error = nullptr,
+                                               bool *loading = nullptr);
+
+    static bool isValidId(const QString &studentId);
+
+    Stats stats() const;
+    void reportMemory(MemoryReport &report) const;
+
+    static const int RECHECK_INTERVAL_MS = 2000;    // 两次检查文件修改时间的最小间隔
+    static const int COLD_LOAD_WAIT_MS = 20;        // 首次加载时服务线程最多等待的时间
+    static const int MAX_PENDING_LOADS = 64;        // 同时在后台读取的用户数上限
+
+private:
+    // 在线程池中读出的文件内容，还未经过课程目录和字符串池
+    struct LoadResult {
+        bool ok = false;
+        QString error;
+        bool hasTimetable = false;
+        QVector<TimetableEntry> timetable;
+        QVector<CourseRecord> courses;      // 需要迁移时由 schedule.dat 读出
+        QVector<TaskRecord> tasks;
+        QDateTime timetableModified;
+        QDateTime scheduleModified;
+        QDateTime tasksModified;
+    };
+    struct PendingLoad {
+        LoadResult result;
+        QSemaphore done;                    // 读取线程写完 result 后释放
+        bool isFinished() const { return done.available() > 0; }
+    };
+
+    struct Profile {
+        std::shared_ptr<const ScheduleIndex> index;
+        QVector<TimetableEntry> timetable;
+        std::shared_ptr<const TaskSnapshot> tasks;
+        quint64 catalogVersion = 0;     // 解析课表时的目录版本
+        qint64 taskBytes = 0;
+        qint64 bytes = 0;
+        QDateTime timetableModified;
+        QDateTime scheduleModified;
+        QDateTime tasksModified;
+        QElapsedTimer checked;
+        std::list<QString>::iterator lru;
+    };
+
+    static void readProfile(const QString &studentId, const QString &dirPath, LoadResult &result);
+    void startLoad(const QString &studentId);
+    bool finishLoad(const QString &studentId, QString *error);
+    void install(const QString &studentId, const LoadResult &result);
+    void buildIndex(const QString &studentId, Profile &profile);
+    void unload(const QString &studentId);
+    bool isStale(const QString &studentId, Profile &profile) const;
+    void reloadCatalogIfChanged();
+    void touch(Profile &profile);
+    qint64 sharedBytes() const;
+    void purgeShared();
+    void evict();
+
+    QString m_rootDir;
+    qint64 m_budgetBytes;
+    qint64 m_totalBytes;
+    quint64 m_generation;           // 每次加载递增，作为快照版本，重新加载后 ETag 随之变化
+    QHash<QString, Profile> m_profiles;
+    QHash<QString, std::shared_ptr<PendingLoad>> m_pending;
+    std::list<QString> m_lru;       // 头部为最近使用
+    StringPool m_strings;
+    CourseCatalog m_catalog;
+    QDateTime m_catalogModified;
+    QElapsedTimer m_catalogChecked;
+    quint64 m_hits;
+    quint64 m_loads;
+    quint64 m_evictions;
+};
+
+#endif // PROFILESTORE_H
@@ -0,0 +1,150 @@
+#include "ReminderDedup.h"
+#include <QDataStream>
+#include <QIODevice>
+#include <QVector>
+#include <algorithm>
+
+ReminderDedup::ReminderDedup()
+{
+    clear();
+}
+
+bool ReminderDedup::contains(quint64 key, qint64 nowMinute) const
+{
+    int index = findSlot(key);
+    return index >= 0 && m_slots[index].expiry >= nowMinute;
+}
+
+// 添加记录；装载率过高时先清理过期项，仍然过满则淘汰最早过期的记录
+void ReminderDedup::insert(quint64 key, qint64 expiryMinute, qint64 nowMinute)
+{
+    if (key == 0) return;
+
+    int index = findSlot(key);
+    if (index >= 0) {
+        m_slots[index].expiry = expiryMinute;
+        return;
+    }
+
+    if (m_count >= CAPACITY * 3 / 4) {
+        rebuild(nowMinute, false);
+        if (m_count >= CAPACITY * 3 / 4) {
+            rebuild(nowMinute, true);
+        }
+    }
+    insertSlot(key, expiryMinute);
+}
+
+void ReminderDedup::purgeExpired(qint64 nowMinute)
+{
+    rebuild(nowMinute, false);
+}
+
+void ReminderDedup::clear()
+{
+    for (int i = 0; i < CAPACITY; ++i) {
+        m_slots[i].key = 0;
+        m_slots[i].expiry = 0;
+    }
+    m_count = 0;
+}
+
+QByteArray ReminderDedup::toByteArray() const
+{
+    QByteArray data;
+    QDataStream out(&data, QIODevice::WriteOnly);
+    out << FORMAT_VERSION << static_cast<quint16>(m_count);
+    for (int i = 0; i < CAPACITY; ++i) {
+        if (m_slots[i].key != 0) {
+            out << m_slots[i].key << m_slots[i].expiry;
+        }
+    }
+    return data;
+}
+
+bool ReminderDedup::fromByteArray(const QByteArray &data, qint64 nowMinute)
+{
+    clear();
+    if (data.isEmpty()) return false;
+
+    QDataStream in(data);
+    quint8 version = 0;
+    quint16 count = 0;
+    in >> version >> count;
+    if (in.status() != QDataStream::Ok || version != FORMAT_VERSION) {
+        return false;
+    }
+
+    for (quint16 i = 0; i < count && m_count < CAPACITY * 3 / 4; ++i) {
+        quint64 key = 0;
+        qint64 expiry = 0;
+        in >> key >> expiry;
+        if (in.status() != QDataStream::Ok) {
+            break;
+        }
+        if (key != 0 && expiry >= nowMinute && findSlot(key) < 0) {
+            insertSlot(key, expiry);
+        }
+    }
+    return true;
+}
+
+quint64 ReminderDedup::courseKey(qint64 startMinute, int section)
+{
+    return (static_cast<quint64>(startMinute) << 8) | static_cast<quint8>(section);
+}
+
+int ReminderDedup::findSlot(quint64 key) const
+{
+    int index = static_cast<int>(hashKey(key) & (CAPACITY - 1));
+    for (int probe = 0; probe < CAPACITY; ++probe) {
+        const Slot &slot = m_slots[index];
+        if (slot.key == key) return index;
+        if (slot.key == 0) return -1;
+        index = (index + 1) & (CAPACITY - 1);
+    }
+    return -1;
+}
+
+void ReminderDedup::insertSlot(quint64 key, qint64 expiry)
+{
+    int index = static_cast<int>(hashKey(key) & (CAPACITY - 1));
+    while (m_slots[index].key != 0) {
+        index = (index + 1) & (CAPACITY - 1);
+    }
+    m_slots[index].key = key;
+    m_slots[index].expiry = expiry;
+    ++m_count;
+}
+
+// 重新装填有效记录，可选淘汰最早过期的四分之一
+void ReminderDedup::rebuild(qint64 nowMinute, bool dropEarliest)
+{
+    QVector<Slot> live;
+    live.reserve(m_count);
+    for (int i = 0; i < CAPACITY; ++i) {
+        if (m_slots[i].key != 0 && m_slots[i].expiry >= nowMinute) {
+            live.append(m_slots[i]);
+        }
+    }
+
+    if (dropEarliest && !live.isEmpty()) {
+        std::sort(live.begin(), live.end(), [](const Slot &a, const Slot &b) {
+            return a.expiry > b.expiry;
+        });
+        live.resize(live.size() - qMax(1, live.size() / 4));
+    }
+
+    clear();
+    for (const Slot &slot : live) {
+        insertSlot(slot.key, slot.expiry);
+    }
+}
+
+quint32 ReminderDedup::hashKey(quint64 key)
+{
+    key ^= key >> 33;
+    key *= Q_UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    return static_cast<quint32>(key);
+}
@@ -0,0 +1,46 @@
+#ifndef REMINDERDEDUP_H
+#define REMINDERDEDUP_H
+
+#include <QtGlobal>
+#include <QByteArray>
+
+// 已提醒记录：固定容量的整数键开放寻址表
+// 每个键带有过期时刻（自纪元起的分钟数），事件发生后自动失效
+class ReminderDedup
+{
+public:
+    static const int CAPACITY = 256;    // 必须为2的幂
+
+    ReminderDedup();
+
+    bool contains(quint64 key, qint64 nowMinute) const;
+    void insert(quint64 key, qint64 expiryMinute, qint64 nowMinute);
+    void purgeExpired(qint64 nowMinute);
+    void clear();
+    int size() const { return m_count; }
+
+    // 持久化为紧凑的二进制数据
+    QByteArray toByteArray() const;
+    bool fromByteArray(const QByteArray &data, qint64 nowMinute);
+
+    // 课程某次上课的键：开始时刻(分钟) + 节次
+    static quint64 courseKey(qint64 startMinute, int section);
+
+private:
+    struct Slot {
+        quint64 key;     // 0 表示空槽
+        qint64 expiry;
+    };
+
+    static const quint8 FORMAT_VERSION = 1;
+
+    int findSlot(quint64 key) const;
+    void insertSlot(quint64 key, qint64 expiry);
+    void rebuild(qint64 nowMinute, bool dropEarliest);
+    static quint32 hashKey(quint64 key);
+
+    Slot m_slots[CAPACITY];
+    int m_count;
+};
+
+#endif // REMINDERDEDUP_H
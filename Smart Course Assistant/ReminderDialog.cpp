@@ -1,5 +1,6 @@
 #include "ReminderDialog.h"
 #include "ui_ReminderDialog.h"
+#include "TraceRecorder.h"
 #include <QMessageBox>
 #include <QSettings>
 #include <QPushButton>
@@ -8,6 +9,7 @@ ReminderDialog::ReminderDialog(int currentMinutes, QWidget *parent)
     : QDialog(parent),
     ui(new Ui::ReminderDialog)
 {
+    TRACE_SCOPE_CAT("ReminderDialog::ReminderDialog", "dialog");
     ui->setupUi(this);
     QSettings settings;
     int savedMinutes = settings.value("Notification/ReminderMinutes", currentMinutes).toInt();
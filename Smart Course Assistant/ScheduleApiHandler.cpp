@@ -0,0 +1,176 @@
+#include "ScheduleApiHandler.h"
+#include "Course.h"
+#include "ScheduleManager.h"
+#include <QJsonArray>
+
+namespace {
+
+const int MAX_DUE_DAYS = 3650;
+
+QJsonValue occurrenceToJson(const ScheduleIndex::CourseOccurrence &occurrence)
+{
+    if (!occurrence.course) {
+        return QJsonValue::Null;
+    }
+    QJsonObject obj = ScheduleApiHandler::courseToJson(*occurrence.course);
+    obj["date"] = occurrence.date.toString(Qt::ISODate);
+    return obj;
+}
+
+template <typename Tasks>
+QJsonArray tasksToJson(const Tasks &tasks, const QDate &today)
+{
+    QJsonArray array;
+    for (const ScheduleIndex::TaskPtr &task : tasks) {
+        array.append(ScheduleApiHandler::taskToJson(*task, today));
+    }
+    return array;
+}
+
+} // namespace
+
+ScheduleApiHandler::ScheduleApiHandler(const SnapshotPublisher<CourseRecord> *courses,
+                                       const SnapshotPublisher<TaskRecord> *tasks)
+    : m_courses(courses),
+    m_tasks(tasks),
+    m_semesterStart(0)
+{
+}
+
+void ScheduleApiHandler::setSemesterStart(const QDate &firstMonday)
+{
+    m_semesterStart.store(firstMonday.isValid() ? firstMonday.toJulianDay() : 0, std::memory_order_relaxed);
+}
+
+ApiResource ScheduleApiHandler::resolve(const QString &path, const QUrlQuery &query)
+{
+    auto courses = m_courses->current();
+    auto tasks = m_tasks->current();
+    if (!m_index || !m_index->isCurrent(*courses, *tasks)) {
+        m_index = std::make_shared<const ScheduleIndex>(courses, tasks);
+    }
+    const qint64 semesterStart = m_semesterStart.load(std::memory_order_relaxed);
+    return ScheduleApiHandler::query(m_index, path, query, QByteArray(),
+                                     semesterStart ? QDate::fromJulianDay(semesterStart) : QDate());
+}
+
+// ETag 由数据版本、路径、参数和结果依赖的时刻组成，生成正文前即可比较
+ApiResource ScheduleApiHandler::query(const std::shared_ptr<const ScheduleIndex> &index, const QString &path,
+                                      const QUrlQuery &query, const QByteArray &etagPrefix,
+                                      const QDate &semesterStart)
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    const QDate today = now.date();
+    QByteArray version = etagPrefix + 'c' + QByteArray::number(index->courseVersion())
+                         + 't' + QByteArray::number(index->taskVersion());
+    if (semesterStart.isValid()) {
+        version += 's' + QByteArray::number(semesterStart.toJulianDay());
+    }
+    const QByteArray minuteKey = now.toString("yyyyMMddHHmm").toLatin1();
+    const QByteArray dateKey = today.toString("yyyyMMdd").toLatin1();
+
+    ApiResource resource;
+    if (path == "/version") {
+        resource.etag = version + "-version";
+        resource.render = [index]() {
+            return QJsonDocument(QJsonObject{
+                {"courses", QString::number(index->courseVersion())},
+                {"tasks", QString::number(index->taskVersion())}});
+        };
+    } else if (path == "/now") {
+        resource.etag = version + "-now-" + minuteKey;
+        resource.render = [index, now, semesterStart]() {
+            return QJsonDocument(QJsonObject{
+                {"course", occurrenceToJson(index->currentCourse(now, semesterStart))}});
+        };
+    } else if (path == "/next") {
+        resource.etag = version + "-next-" + minuteKey;
+        resource.render = [index, now, semesterStart]() {
+            return QJsonDocument(QJsonObject{
+                {"course", occurrenceToJson(index->nextCourse(now, semesterStart))}});
+        };
+    } else if (path == "/today") {
+        int day = today.dayOfWeek();
+        if (query.hasQueryItem("day")) {
+            bool ok = false;
+            day = query.queryItemValue("day").toInt(&ok);
+            if (!ok || day < 1 || day > 7) {
+                return error(400, "day 应为 1-7");
+            }
+        }
+        resource.etag = version + "-today-" + dateKey + '-' + QByteArray::number(day);
+        // 本周的这一天，单双周课程只列出该周上课的
+        const int week = ScheduleManager::semesterWeek(semesterStart, today.addDays(day - today.dayOfWeek()));
+        resource.render = [index, day, week]() {
+            QJsonArray array;
+            for (const ScheduleIndex::CoursePtr &course : index->coursesOn(day)) {
+                if (Course::occursInWeek(course->weekParity, week)) {
+                    array.append(courseToJson(*course));
+                }
+            }
+            return QJsonDocument(QJsonObject{{"dayOfWeek", day}, {"courses", array}});
+        };
+    } else if (path == "/due") {
+        int days = 0;
+        if (query.hasQueryItem("days")) {
+            bool ok = false;
+            days = query.queryItemValue("days").toInt(&ok);
+            if (!ok || days < 0 || days > MAX_DUE_DAYS) {
+                return error(400, QString("days 应为 0-%1").arg(MAX_DUE_DAYS));
+            }
+        }
+        resource.etag = version + "-due-" + dateKey + '-' + QByteArray::number(days);
+        resource.render = [index, today, days]() {
+            return QJsonDocument(QJsonObject{
+                {"tasks", tasksToJson(index->openTasksDueBy(today.addDays(days)), today)}});
+        };
+    } else if (path == "/tasks") {
+        resource.etag = version + "-tasks-" + dateKey;
+        resource.render = [index, today]() {
+            return QJsonDocument(QJsonObject{{"tasks", tasksToJson(index->allTasks(), today)}});
+        };
+    } else if (path == "/conflicts") {
+        resource.etag = etagPrefix + 'c' + QByteArray::number(index->courseVersion()) + "-conflicts";
+        resource.render = [index]() {
+            QJsonArray array;
+            for (const auto &pair : index->conflicts()) {
+                array.append(QJsonArray{courseToJson(*pair.first), courseToJson(*pair.second)});
+            }
+            return QJsonDocument(QJsonObject{{"conflicts", array}});
+        };
+    } else {
+        return error(404, "未知的查询: " + path);
+    }
+    return resource;
+}
+
+QJsonObject ScheduleApiHandler::courseToJson(const CourseRecord &course)
+{
+    QJsonObject obj;
+    obj["name"] = course.name;
+    obj["dayOfWeek"] = course.dayOfWeek;
+    obj["startSection"] = course.startSection;
+    obj["endSection"] = course.endSection;
+    obj["startTime"] = ScheduleManager::getSectionStartTime(course.startSection).toString("HH:mm");
+    obj["endTime"] = ScheduleManager::getSectionEndTime(course.endSection).toString("HH:mm");
+    obj["classroom"] = course.classroom;
+    obj["teacher"] = course.teacher;
+    obj["weeks"] = Course::weekParityText(course.weekParity);
+    return obj;
+}
+
+// 剩余天数按请求时的日期计算，与 Task 一样已完成的任务记为 0
+QJsonObject ScheduleApiHandler::taskToJson(const TaskRecord &task, const QDate &today)
+{
+    QJsonObject obj;
+    obj["title"] = task.title;
+    obj["course"] = task.courseName;
+    obj["dueDate"] = task.dueDate.toString(Qt::ISODate);
+    if (task.dueTime.isValid()) {
+        obj["dueTime"] = task.dueTime.toString("HH:mm");
+    }
+    obj["exam"] = task.exam;
+    obj["completed"] = task.completed;
+    obj["daysRemaining"] = task.completed ? 0 : int(today.daysTo(task.dueDate));
+    return obj;
+}
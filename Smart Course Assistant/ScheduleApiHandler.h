@@ -0,0 +1,43 @@
+#ifndef SCHEDULEAPIHANDLER_H
+#define SCHEDULEAPIHANDLER_H
+
+#include "ApiServer.h"
+#include "ScheduleIndex.h"
+#include <QJsonObject>
+#include <atomic>
+
+// 单个用户的查询接口：读取课程和任务的快照，版本变化时在服务线程中重建 ScheduleIndex
+//   GET /api/version          数据版本
+//   GET /api/now              当前课程
+//   GET /api/next             下一节课及日期
+//   GET /api/today[?day=1..7] 某天的课程，默认今天
+//   GET /api/due[?days=N]     N 天内截止的未完成任务（含已过期），默认今天
+//   GET /api/tasks            全部任务
+//   GET /api/conflicts        时间冲突的课程
+// 设置了学期开始日期时，now/next/today 按学期周次区分单双周
+class ScheduleApiHandler : public ApiHandler
+{
+public:
+    ScheduleApiHandler(const SnapshotPublisher<CourseRecord> *courses,
+                       const SnapshotPublisher<TaskRecord> *tasks);
+
+    ApiResource resolve(const QString &path, const QUrlQuery &query) override;
+    // 学期第一周的周一，界面线程设置，服务线程读取；无效表示不区分单双周
+    void setSemesterStart(const QDate &firstMonday);
+
+    // 针对给定索引回答查询，多用户服务复用；etagPrefix 用于区分不同用户的数据
+    static ApiResource query(const std::shared_ptr<const ScheduleIndex> &index, const QString &path,
+                             const QUrlQuery &query, const QByteArray &etagPrefix = QByteArray(),
+                             const QDate &semesterStart = QDate());
+
+    static QJsonObject courseToJson(const CourseRecord &course);
+    static QJsonObject taskToJson(const TaskRecord &task, const QDate &today);
+
+private:
+    const SnapshotPublisher<CourseRecord> *m_courses;
+    const SnapshotPublisher<TaskRecord> *m_tasks;
+    std::shared_ptr<const ScheduleIndex> m_index;
+    std::atomic<qint64> m_semesterStart;   // 儒略日，0 表示未设置
+};
+
+#endif // SCHEDULEAPIHANDLER_H
@@ -0,0 +1,126 @@
+#include "ScheduleIndex.h"
+#include "ScheduleManager.h"
+#include <algorithm>
+
+namespace {
+
+// 没有具体时间的任务排在当天最后
+bool dueBefore(const ScheduleIndex::TaskPtr &a, const ScheduleIndex::TaskPtr &b)
+{
+    if (a->dueDate != b->dueDate) {
+        return a->dueDate < b->dueDate;
+    }
+    if (a->dueTime.isValid() != b->dueTime.isValid()) {
+        return a->dueTime.isValid();
+    }
+    return a->dueTime < b->dueTime;
+}
+
+} // namespace
+
+ScheduleIndex::ScheduleIndex(std::shared_ptr<const ScheduleSnapshot> courses,
+                             std::shared_ptr<const TaskSnapshot> tasks)
+    : m_courses(std::move(courses)),
+    m_tasks(std::move(tasks))
+{
+    for (const CoursePtr &course : m_courses->items) {
+        if (course->dayOfWeek >= 1 && course->dayOfWeek <= 7) {
+            m_byDay[course->dayOfWeek - 1].append(course);
+        }
+    }
+    // 稳定排序：同一节次开始的课程保持原有顺序，与线性扫描的结果相同
+    for (QVector<CoursePtr> &day : m_byDay) {
+        std::stable_sort(day.begin(), day.end(), [](const CoursePtr &a, const CoursePtr &b) {
+            return a->startSection < b->startSection;
+        });
+    }
+
+    for (const TaskPtr &task : m_tasks->items) {
+        if (!task->completed && task->dueDate.isValid()) {
+            m_openByDue.append(task);
+        }
+    }
+    std::stable_sort(m_openByDue.begin(), m_openByDue.end(), dueBefore);
+}
+
+bool ScheduleIndex::isCurrent(const ScheduleSnapshot &courses, const TaskSnapshot &tasks) const
+{
+    return courses.version == m_courses->version && tasks.version == m_tasks->version;
+}
+
+ScheduleIndex::CourseOccurrence ScheduleIndex::currentCourse(const QDateTime &now,
+                                                           const QDate &semesterStart) const
+{
+    int section = ScheduleManager::sectionAt(now.time());
+    if (section == -1) {
+        return {};
+    }
+    const int week = ScheduleManager::semesterWeek(semesterStart, now.date());
+    for (const CoursePtr &course : coursesOn(now.date().dayOfWeek())) {
+        if (course->startSection > section) {
+            break;
+        }
+        if (course->endSection >= section && Course::occursInWeek(course->weekParity, week)) {
+            return {course, now.date()};
+        }
+    }
+    return {};
+}
+
+// 从今天起逐日查找，今天只考虑尚未开始的课程
+// 今天已开始的课程下周才会再上，单双周课程最晚在两周后的同一天上课，因此最多看 14 天
+ScheduleIndex::CourseOccurrence ScheduleIndex::nextCourse(const QDateTime &now,
+                                                        const QDate &semesterStart) const
+{
+    const int today = now.date().dayOfWeek();
+    for (int offset = 0; offset <= 14; ++offset) {
+        const QDate date = now.date().addDays(offset);
+        const int week = ScheduleManager::semesterWeek(semesterStart, date);
+        for (const CoursePtr &course : m_byDay[(today - 1 + offset) % 7]) {
+            if (offset == 0 && ScheduleManager::getSectionStartTime(course->startSection) < now.time()) {
+                continue;
+            }
+            if (!Course::occursInWeek(course->weekParity, week)) {
+                continue;
+            }
+            return {course, date};
+        }
+    }
+    return {};
+}
+
+const QVector<ScheduleIndex::CoursePtr> &ScheduleIndex::coursesOn(int dayOfWeek) const
+{
+    static const QVector<CoursePtr> empty;
+    if (dayOfWeek < 1 || dayOfWeek > 7) {
+        return empty;
+    }
+    return m_byDay[dayOfWeek - 1];
+}
+
+// 同一天的课程已按开始节次排序，遇到开始晚于结束节次的课程即可停止
+// 单周与双周课程交替使用同一时段，不算冲突
+QVector<QPair<ScheduleIndex::CoursePtr, ScheduleIndex::CoursePtr>> ScheduleIndex::conflicts() const
+{
+    QVector<QPair<CoursePtr, CoursePtr>> result;
+    for (const QVector<CoursePtr> &day : m_byDay) {
+        for (int i = 0; i < day.size(); ++i) {
+            const CourseRecord &a = *day.at(i);
+            for (int j = i + 1; j < day.size() && day.at(j)->startSection <= a.endSection; ++j) {
+                if (Course::sharesWeeks(a.weekParity, day.at(j)->weekParity)) {
+                    result.append(qMakePair(day.at(i), day.at(j)));
+                }
+            }
+        }
+    }
+    return result;
+}
+
+QVector<ScheduleIndex::TaskPtr> ScheduleIndex::openTasksDueBy(const QDate &last) const
+{
+    auto end = std::upper_bound(m_openByDue.cbegin(), m_openByDue.cend(), last,
+                                [](const QDate &date, const TaskPtr &task) {
+                                    return date < task->dueDate;
+                                });
+    return QVector<TaskPtr>(m_openByDue.cbegin(), end);
+}
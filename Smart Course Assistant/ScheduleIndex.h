@@ -0,0 +1,51 @@
+#ifndef SCHEDULEINDEX_H
+#define SCHEDULEINDEX_H
+
+#include <QDateTime>
+#include <QPair>
+#include <QVector>
+#include <memory>
+#include "Snapshot.h"
+
+// 查询索引：由课程和任务快照构建，构建后只读，可在任意线程并发查询
+// 与 OccurrenceTimeline/DeadlineIndex 不同，这里只引用快照记录，不接触界面线程的对象
+class ScheduleIndex
+{
+public:
+    using CoursePtr = std::shared_ptr<const CourseRecord>;
+    using TaskPtr = std::shared_ptr<const TaskRecord>;
+
+    struct CourseOccurrence {
+        CoursePtr course;
+        QDate date;
+    };
+
+    ScheduleIndex(std::shared_ptr<const ScheduleSnapshot> courses,
+                  std::shared_ptr<const TaskSnapshot> tasks);
+
+    quint64 courseVersion() const { return m_courses->version; }
+    quint64 taskVersion() const { return m_tasks->version; }
+    // 快照版本未变化时可以继续使用
+    bool isCurrent(const ScheduleSnapshot &courses, const TaskSnapshot &tasks) const;
+
+    // 与 ScheduleManager::currentCourseAt/nextCourseAt 的结果一致
+    // semesterStart 为学期第一周的周一，无效时不区分单双周
+    CourseOccurrence currentCourse(const QDateTime &now, const QDate &semesterStart = QDate()) const;
+    CourseOccurrence nextCourse(const QDateTime &now, const QDate &semesterStart = QDate()) const;
+    // 某天（1=周一）的课程，按开始节次排序
+    const QVector<CoursePtr> &coursesOn(int dayOfWeek) const;
+    // 时间冲突的课程对，判定规则与 Course::hasTimeConflictWith 相同（单周与双周课程可以共用时段）
+    QVector<QPair<CoursePtr, CoursePtr>> conflicts() const;
+
+    // 截止日期不晚于 last 的未完成任务（含已过期），按截止时间排序
+    QVector<TaskPtr> openTasksDueBy(const QDate &last) const;
+    const ChunkedVector<TaskPtr> &allTasks() const { return m_tasks->items; }
+
+private:
+    std::shared_ptr<const ScheduleSnapshot> m_courses;
+    std::shared_ptr<const TaskSnapshot> m_tasks;
+    QVector<CoursePtr> m_byDay[7];      // 周一到周日
+    QVector<TaskPtr> m_openByDue;
+};
+
+#endif // SCHEDULEINDEX_H
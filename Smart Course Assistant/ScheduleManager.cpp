@@ -1,38 +1,53 @@
 #include "ScheduleManager.h"
+#include "TraceRecorder.h"
+#include "MemoryStats.h"
+#include "DataFileReader.h"
 #include <QFile>
 #include <QDataStream>
 #include <QDebug>
 #include <QDate>
 #include <algorithm>
+#include <limits>
 #include <QStandardPaths>
 #include <QDir>
-#include <QFile>
+#include <QFileInfo>
 const QString ScheduleManager::DATA_FILE_PATH = "schedule.dat";
 ScheduleManager::ScheduleManager(QObject *parent)
-    : QObject(parent)
+    : ScheduleManager(LoadDefaultFile, parent)
 {
-    loadCourses();
+}
+
+ScheduleManager::ScheduleManager(LoadPolicy policy, QObject *parent)
+    : QObject(parent),
+    m_autoSave(true),
+    m_defaultLoaded(false)
+{
+    if (policy == LoadDefaultFile) {
+        loadCourses();
+    }
 }
 
 ScheduleManager::~ScheduleManager()
 {
-    saveCourses();
+    if (m_autoSave && m_defaultLoaded) {
+        saveCourses();
+    }
 }
 
 // 添加课程
 bool ScheduleManager::addCourse(const Course &course)
 {
     // 检查时间冲突
-    for (const auto &existingCourse : m_courses) {
-        if (existingCourse->hasTimeConflictWith(course)) {
-            qWarning() << "课程时间冲突:" << course.name();
-            return false;
-        }
+    if (hasConflict(course)) {
+        qWarning() << "课程时间冲突:" << course.name();
+        return false;
     }
 
     // 创建新课程对象，并设置父对象为this
     Course *newCourse = new Course(course, this);
     m_courses.append(newCourse);
+    m_snapshots.append(CourseRecord::fromCourse(*newCourse));
+    emit coursesInserted(m_courses.size() - 1, m_courses.size() - 1);
     emit coursesChanged();
     return true;
 }
@@ -44,15 +59,15 @@ bool ScheduleManager::editCourse(int index, const Course &newCourse)
     }
 
     // 检查时间冲突（排除自身）
-    for (int i = 0; i < m_courses.size(); ++i) {
-        if (i != index && m_courses[i]->hasTimeConflictWith(newCourse)) {
-            qWarning() << "Course time conflict:" << newCourse.name();
-            return false;
-        }
+    if (hasConflict(newCourse, index)) {
+        qWarning() << "Course time conflict:" << newCourse.name();
+        return false;
     }
 
     // 更新课程信息
     *m_courses[index] = newCourse;
+    m_snapshots.replace(index, CourseRecord::fromCourse(newCourse));
+    emit courseEdited(index);
     emit coursesChanged();
     return true;
 }
@@ -65,12 +80,111 @@ bool ScheduleManager::removeCourse(int index)
     }
 
     Course* course = m_courses.takeAt(index);
+    m_snapshots.remove(index);
     course->deleteLater(); // 安全删除
 
+    emit coursesRemoved({course});
+    emit coursesChanged();
+    return true;
+}
+
+// 在指定位置插入课程，记录直接进入快照，不再复制
+bool ScheduleManager::insertCourse(int index, const std::shared_ptr<const CourseRecord> &record)
+{
+    if (!record || index < 0 || index > m_courses.size()) {
+        return false;
+    }
+
+    Course *course = new Course(this);
+    record->applyTo(*course);
+    if (hasConflict(*course)) {
+        qWarning() << "课程时间冲突:" << course->name();
+        delete course;
+        return false;
+    }
+
+    m_courses.insert(index, course);
+    m_snapshots.insert(index, record);
+    emit coursesInserted(index, index);
     emit coursesChanged();
     return true;
 }
 
+// 批量追加：全部不冲突时才添加，快照只发布一次
+bool ScheduleManager::addCourses(const QVector<std::shared_ptr<const CourseRecord>> &records)
+{
+    if (!canAddCourses(records)) {
+        return false;
+    }
+
+    QList<Course*> added;
+    added.reserve(records.size());
+    for (const auto &record : records) {
+        Course *course = new Course(this);
+        record->applyTo(*course);
+        added.append(course);
+    }
+
+    int first = m_courses.size();
+    m_courses += added;
+    m_snapshots.appendAll(records);
+    if (!added.isEmpty()) {
+        emit coursesInserted(first, m_courses.size() - 1);
+    }
+    emit coursesChanged();
+    return true;
+}
+
+bool ScheduleManager::removeCourses(int index, int count)
+{
+    if (index < 0 || count <= 0 || index + count > m_courses.size()) {
+        return false;
+    }
+
+    QList<Course*> removed = m_courses.mid(index, count);
+    m_courses.erase(m_courses.begin() + index, m_courses.begin() + index + count);
+    m_snapshots.removeRange(index, count);
+    for (Course *course : std::as_const(removed)) {
+        course->deleteLater();
+    }
+    emit coursesRemoved(removed);
+    emit coursesChanged();
+    return true;
+}
+
+// 检查一批课程能否整体加入：既不与现有课程冲突，彼此之间也不冲突
+bool ScheduleManager::canAddCourses(const QVector<std::shared_ptr<const CourseRecord>> &records) const
+{
+    QList<Course*> checked;
+    bool ok = true;
+    for (const auto &record : records) {
+        Course *course = new Course;
+        record->applyTo(*course);
+        bool conflict = hasConflict(*course);
+        for (const Course *other : std::as_const(checked)) {
+            conflict = conflict || other->hasTimeConflictWith(*course);
+        }
+        checked.append(course);
+        if (conflict) {
+            qWarning() << "课程时间冲突:" << course->name();
+            ok = false;
+            break;
+        }
+    }
+    qDeleteAll(checked);
+    return ok;
+}
+
+bool ScheduleManager::hasConflict(const Course &course, int ignoreIndex) const
+{
+    for (int i = 0; i < m_courses.size(); ++i) {
+        if (i != ignoreIndex && m_courses[i]->hasTimeConflictWith(course)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 // 获取某天的所有课程
 QList<Course*> ScheduleManager::getCoursesByDay(int dayOfWeek) const
 {
@@ -92,18 +206,45 @@ QList<Course*> ScheduleManager::getCoursesByDay(int dayOfWeek) const
 // 获取当前课程
 Course* ScheduleManager::getCurrentCourse() const
 {
-    QDateTime now = QDateTime::currentDateTime();
+    return currentCourseAt(m_courses, QDateTime::currentDateTime(), m_semesterStart);
+}
+
+// 获取下一节课
+Course* ScheduleManager::getNextCourse() const
+{
+    return nextCourseAt(m_courses, QDateTime::currentDateTime(), m_semesterStart);
+}
+
+void ScheduleManager::setSemesterStart(const QDate &firstMonday)
+{
+    m_semesterStart = firstMonday.isValid() ? firstMonday.addDays(1 - firstMonday.dayOfWeek()) : QDate();
+}
+
+int ScheduleManager::semesterWeek(const QDate &semesterStart, const QDate &date)
+{
+    if (!semesterStart.isValid() || !date.isValid()) return 0;
+
+    QDate monday = semesterStart.addDays(1 - semesterStart.dayOfWeek());
+    qint64 days = monday.daysTo(date);
+    return days < 0 ? 0 : static_cast<int>(days / 7) + 1;
+}
+
+Course* ScheduleManager::currentCourseAt(const QList<Course*> &courses, const QDateTime &now,
+                                         const QDate &semesterStart)
+{
     int currentDay = now.date().dayOfWeek(); // Qt中1=周一，7=周日
-    int currentSection = getCurrentSection();
+    int currentSection = sectionAt(now.time());
 
     if (currentSection == -1) {
         return nullptr;
     }
 
-    for (auto course : m_courses) {
+    int week = semesterWeek(semesterStart, now.date());
+    for (auto course : courses) {
         if (course->dayOfWeek() == currentDay &&
             course->startSection() <= currentSection &&
-            course->endSection() >= currentSection) {
+            course->endSection() >= currentSection &&
+            course->occursInWeek(week)) {
             return course;
         }
     }
@@ -111,47 +252,45 @@ Course* ScheduleManager::getCurrentCourse() const
     return nullptr;
 }
 
-// 获取下一节课
-Course* ScheduleManager::getNextCourse() const
+// 单双周课程最多隔一周才上，因此只需看本周、下周和下下周的同一天
+QDateTime ScheduleManager::nextStartOf(const Course &course, const QDateTime &now,
+                                       const QDate &semesterStart)
 {
-    QDateTime now = QDateTime::currentDateTime();
-    int currentDay = now.date().dayOfWeek();
-    int currentSection = getCurrentSection();
+    QTime startTime = getSectionStartTime(course.startSection());
+    if (!startTime.isValid()) {
+        qWarning() << "无效的课程开始时间: 节次" << course.startSection();
+        return QDateTime();
+    }
 
-    // 如果当前不在任何节次内，设置为0以便找到所有未来的课程
-    if (currentSection == -1) {
-        currentSection = 0;
+    int daysToAdd = course.dayOfWeek() - now.date().dayOfWeek();
+    if (daysToAdd < 0) {
+        daysToAdd += 7; // 处理跨周情况
     }
 
+    for (int week = 0; week < 3; ++week) {
+        QDate courseDate = now.date().addDays(daysToAdd + week * 7);
+        QDateTime courseStart(courseDate, startTime);
+        if (courseStart >= now && course.occursInWeek(semesterWeek(semesterStart, courseDate))) {
+            return courseStart;
+        }
+    }
+    return QDateTime();
+}
+
+Course* ScheduleManager::nextCourseAt(const QList<Course*> &courses, const QDateTime &now,
+                                      const QDate &semesterStart)
+{
     Course *nextCourse = nullptr;
     qint64 minTimeDiff = std::numeric_limits<qint64>::max();
 
-    for (auto course : m_courses) {
+    for (auto course : courses) {
         if (!course) continue; // 跳过空指针
 
-        // 计算课程日期
-        int daysToAdd = course->dayOfWeek() - currentDay;
-        if (daysToAdd < 0) {
-            daysToAdd += 7; // 处理跨周情况
-        }
-
-        QDate courseDate = now.date().addDays(daysToAdd);
-        QTime startTime = getSectionStartTime(course->startSection());
-
-        if (!startTime.isValid()) {
-            qWarning() << "无效的课程开始时间: 节次" << course->startSection();
-            continue;
-        }
-
-        QDateTime courseStart(courseDate, startTime);
-
-        // 跳过已结束的课程
-        if (courseStart < now) continue;
-
-        // 计算时间差
-        qint64 timeDiff = now.secsTo(courseStart);
+        QDateTime courseStart = nextStartOf(*course, now, semesterStart);
+        if (!courseStart.isValid()) continue;
 
         // 找到时间差最小的课程
+        qint64 timeDiff = now.secsTo(courseStart);
         if (timeDiff < minTimeDiff) {
             minTimeDiff = timeDiff;
             nextCourse = course;
@@ -160,79 +299,228 @@ Course* ScheduleManager::getNextCourse() const
 
     return nextCourse;
 }
+
+QString ScheduleManager::dataFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/" + DATA_FILE_PATH;
+}
+
 // 保存课程到文件
 void ScheduleManager::saveCourses() const
 {
-    // 创建应用数据目录
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir(dataDir);
+    saveCourses(dataFilePath());
+}
+
+bool ScheduleManager::saveCourses(const QString &filePath) const
+{
+    TRACE_SCOPE_CAT("ScheduleManager::saveCourses", "io");
+    return writeCourses(filePath, *snapshot());
+}
+
+// 按快照写入课程文件，格式与 Course 的序列化一致，可在工作线程中调用
+bool ScheduleManager::writeCourses(const QString &filePath, const ScheduleSnapshot &snapshot)
+{
+    // 创建数据目录
+    QDir dir = QFileInfo(filePath).absoluteDir();
     if (!dir.exists()) {
-        dir.mkpath(dataDir);
+        dir.mkpath(".");
     }
 
-    QString filePath = dataDir + "/schedule.dat";
     QFile file(filePath);
 
     if (!file.open(QIODevice::WriteOnly)) {
         qWarning() << "无法打开文件进行写入:" << filePath;
-        return;
+        return false;
     }
 
     QDataStream out(&file);
     out.setVersion(QDataStream::Qt_5_15); // 设置版本确保兼容性
 
-    // 写入版本和课程数量
+    writeCoursesHeader(out, static_cast<quint32>(snapshot.items.size()));
+    for (const auto &course : snapshot.items) {
+        writeCourseRecord(out, *course);
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+// 写入版本和课程数量
+void ScheduleManager::writeCoursesHeader(QDataStream &out, quint32 count)
+{
     out << VERSION_CODE;
-    out << static_cast<quint32>(m_courses.size()); // 使用quint32确保跨平台兼容
+    out << count; // 使用quint32确保跨平台兼容
+}
 
-    // 写入每个课程
-    for (const auto &course : m_courses) {
-        out << *course;
-    }
+// 写入单个课程：前半部分与 Course 的序列化一致，之后是版本2新增的周次
+void ScheduleManager::writeCourseRecord(QDataStream &out, const CourseRecord &course)
+{
+    out << course.name
+        << course.dayOfWeek
+        << course.startSection
+        << course.endSection
+        << course.classroom
+        << course.teacher
+        << course.note
+        << course.color
+        << static_cast<qint32>(course.weekParity);
 }
 
 void ScheduleManager::loadCourses()
 {
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QString filePath = dataDir + "/schedule.dat";
+    m_defaultLoaded = true;
+    loadCourses(dataFilePath());
+}
+
+bool ScheduleManager::loadCourses(const QString &filePath)
+{
+    TRACE_SCOPE_CAT("ScheduleManager::loadCourses", "io");
+    QList<Course*> courses;
+    QString error;
+    if (!readCourses(filePath, courses, this, &error)) {
+        return false;
+    }
+    if (!error.isEmpty()) {
+        DataFileReader::preserveDamagedFile(filePath);
+    }
+
+    // 重新加载时释放旧的课程对象
+    qDeleteAll(m_courses);
+    m_courses = courses;
+    publishAll();
+
+    emit coursesReset();
+    return true;
+}
+
+// 只读取课程文件，不涉及任何 ScheduleManager 实例，可在工作线程中调用
+bool ScheduleManager::readCourses(const QString &filePath, QList<Course*> &courses, QObject *parent,
+                                  QString *error)
+{
     QFile file(filePath);
 
     if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
         qWarning() << "无法打开文件进行读取:" << filePath;
-        return;
+        return false;
     }
 
-    QDataStream in(&file);
-    in.setVersion(QDataStream::Qt_5_15);
-
-    int version;
-    in >> version;
+    QString readError;
+    bool ok = readCourses(&file, courses, parent, &readError);
+    if (!readError.isEmpty()) {
+        qWarning() << "课程文件已损坏:" << filePath << readError << "，保留前" << courses.size() << "门课程";
+    }
+    if (error) {
+        *error = readError;
+    }
+    return ok;
+}
 
-    if (version != VERSION_CODE) {
+// 逐条读取并校验，遇到损坏的记录即停止，已读出的课程保留在 courses 中
+// 只有文件头无效时返回 false
+bool ScheduleManager::readCourses(QIODevice *device, QList<Course*> &courses, QObject *parent,
+                                  QString *error)
+{
+    MemoryStats::Scope memoryScope(MemoryStats::Courses);
+    DataFileReader reader(device);
+    QDataStream &in = reader.stream();
+
+    qint32 version = 0;
+    quint32 declared = 0;
+    in >> version >> declared;
+
+    // 版本1没有周次字段，按每周上课读取
+    if (!reader.checkStatus("文件头") || version < 1 || version > VERSION_CODE) {
+        if (error) {
+            *error = reader.hasError() ? reader.error() : QString("数据版本不匹配: %1").arg(version);
+        }
         qWarning() << "数据版本不匹配";
-        return;
+        return false;
     }
 
-    quint32 count;
-    in >> count;
+    // 名称、教室、教师、备注四个字符串 + 三个整数 + 颜色 (+ 周次)
+    const qint64 minRecordBytes = 4 * DataFileReader::STRING_HEADER_BYTES + 3 * 4
+                                  + DataFileReader::COLOR_BYTES + (version >= 2 ? 4 : 0);
+    const quint32 count = reader.checkedCount(declared, minRecordBytes);
 
-    m_courses.clear();
     for (quint32 i = 0; i < count; ++i) {
-        Course *course = new Course(this);
-        in >> *course;
-        m_courses.append(course);
+        CourseRecord record;
+        qint32 day = 0, start = 0, end = 0, parity = Course::EveryWeek;
+        if (!reader.readString(record.name)) break;
+        in >> day >> start >> end;
+        if (!reader.checkStatus("节次")) break;
+        if (!reader.readString(record.classroom)
+            || !reader.readString(record.teacher)
+            || !reader.readString(record.note)) {
+            break;
+        }
+        in >> record.color;
+        if (version >= 2) {
+            in >> parity;
+        }
+        if (!reader.checkStatus("颜色和周次")) break;
+
+        if (day < 1 || day > 7 || start < 1 || end < start || end > Course::MAX_SECTION
+            || parity < Course::EveryWeek || parity > Course::EvenWeeks) {
+            reader.fail(QString("第 %1 条课程的字段超出范围").arg(i + 1));
+            break;
+        }
+        record.dayOfWeek = day;
+        record.startSection = start;
+        record.endSection = end;
+        record.weekParity = parity;
+
+        // 校验通过后才创建对象，损坏的文件不会产生多余的 QObject
+        Course *course = new Course(parent);
+        record.applyTo(*course);
+        courses.append(course);
+    }
+
+    if (error) {
+        *error = reader.error();
+    }
+    return true;
+}
+
+// 重新生成全部记录的快照
+void ScheduleManager::publishAll()
+{
+    MemoryStats::Scope memoryScope(MemoryStats::Snapshots);
+    QVector<CourseRecord> records;
+    records.reserve(m_courses.size());
+    for (const Course *course : std::as_const(m_courses)) {
+        records.append(CourseRecord::fromCourse(*course));
     }
+    m_snapshots.reset(records);
+}
+
+void ScheduleManager::reportMemory(MemoryReport &report) const
+{
+    qint64 bytes = MemoryStats::ARRAY_HEADER_BYTES + qint64(m_courses.size()) * qint64(sizeof(Course*));
+    qint64 stringBytes = 0;
+    for (const Course *course : std::as_const(m_courses)) {
+        bytes += MemoryStats::courseBytes(*course);
+        stringBytes += MemoryStats::courseStringBytes(*course);
+    }
+    report.add("课程对象", m_courses.size(), bytes, stringBytes);
+
+    std::shared_ptr<const ScheduleSnapshot> current = snapshot();
+    report.add("课程快照", current->items.size(),
+               qint64(sizeof(ScheduleSnapshot)) + MemoryStats::SHARED_PTR_BLOCK_BYTES
+                   + MemoryStats::vectorBytes(current->items)
+                   + qint64(current->items.size()) * MemoryStats::courseRecordBytes());
 }
 
 // 获取当前节次
 int ScheduleManager::getCurrentSection() const
 {
-    QTime currentTime = QTime::currentTime();
+    return sectionAt(QTime::currentTime());
+}
+
+int ScheduleManager::sectionAt(const QTime &time)
+{
     const auto& sectionTimes = getSectionTimes();
 
     for (int i = 0; i < sectionTimes.size(); ++i) {
         const auto& timePair = sectionTimes[i];
-        if (currentTime >= timePair.first && currentTime <= timePair.second) {
+        if (time >= timePair.first && time <= timePair.second) {
             return i + 1; // 节次从1开始
         }
     }
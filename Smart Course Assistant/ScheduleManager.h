@@ -5,7 +5,12 @@
 #include <QList>
 #include <QVector>
 #include <QTime>
+#include <QDateTime>
 #include "Course.h"
+#include "Snapshot.h"
+
+class MemoryReport;
+class QIODevice;
 
 class ScheduleManager : public QObject
 {
@@ -15,32 +20,94 @@ public:
     static QTime getSectionStartTime(int section);
     static QTime getSectionEndTime(int section);
     static const QVector<QPair<QTime, QTime>>& getSectionTimes();
+    // 纯函数版本的查询，供主程序和命令行工具共用
+    static int sectionAt(const QTime &time);
+    // semesterStart 为学期第一周的周一，无效时不区分单双周
+    static Course* currentCourseAt(const QList<Course*> &courses, const QDateTime &now,
+                                   const QDate &semesterStart = QDate());
+    static Course* nextCourseAt(const QList<Course*> &courses, const QDateTime &now,
+                                const QDate &semesterStart = QDate());
+    // 课程在 now 之后（含正在开始的时刻）最近一次上课的开始时间，两周内没有则返回无效值
+    static QDateTime nextStartOf(const Course &course, const QDateTime &now,
+                                 const QDate &semesterStart = QDate());
+    // date 是学期第几周（从1开始），未设置学期或在开学之前返回 0
+    static int semesterWeek(const QDate &semesterStart, const QDate &date);
+    static QString dataFilePath();
+    // 构造时是否读取默认数据文件。DeferLoad 时只在调用 loadCourses() 后才读取默认文件，
+    // 在此之前析构也不会自动保存，避免用空列表覆盖用户数据
+    enum LoadPolicy {
+        LoadDefaultFile,
+        DeferLoad
+    };
     explicit ScheduleManager(QObject *parent = nullptr);
+    explicit ScheduleManager(LoadPolicy policy, QObject *parent = nullptr);
     ~ScheduleManager();
 
     // 课程管理
     bool addCourse(const Course &course);
     bool editCourse(int index, const Course &newCourse);
     bool removeCourse(int index);
+    // 撤销/重做与批量导入使用：按快照记录插入，或一次移除一段连续的课程
+    bool insertCourse(int index, const std::shared_ptr<const CourseRecord> &record);
+    bool addCourses(const QVector<std::shared_ptr<const CourseRecord>> &records);
+    bool removeCourses(int index, int count);
+    // 是否与现有课程时间冲突，ignoreIndex 为编辑时排除的自身
+    bool hasConflict(const Course &course, int ignoreIndex = -1) const;
+    bool canAddCourses(const QVector<std::shared_ptr<const CourseRecord>> &records) const;
 
     // 课程查询
     QList<Course*> getCoursesByDay(int dayOfWeek) const;
     Course* getCurrentCourse() const;
     Course* getNextCourse() const;
     const QList<Course*>& getAllCourses() const;
+    // 当前/下一节课按此日期计算单双周；无效表示尚未设置学期
+    void setSemesterStart(const QDate &firstMonday);
+    QDate semesterStart() const { return m_semesterStart; }
+
+    // 最新的只读快照，可交给工作线程使用
+    std::shared_ptr<const ScheduleSnapshot> snapshot() const { return m_snapshots.current(); }
+    const SnapshotPublisher<CourseRecord> &snapshots() const { return m_snapshots; }
     void loadCourses();
     void saveCourses() const;
+    // 指定文件读写；成功返回 true
+    bool loadCourses(const QString &filePath);
+    bool saveCourses(const QString &filePath) const;
+    // 把快照整体写入课程文件；成功返回 true
+    static bool writeCourses(const QString &filePath, const ScheduleSnapshot &snapshot);
+    // 流式写入，供数据生成等不必整体放入内存的场景使用
+    static void writeCoursesHeader(QDataStream &out, quint32 count);
+    static void writeCourseRecord(QDataStream &out, const CourseRecord &course);
+    // 读取课程文件到 courses（追加），新建的课程对象以 parent 为父对象
+    // 文件损坏时保留能读出的前缀，error 中给出原因；只有无法打开或文件头无效时返回 false
+    static bool readCourses(const QString &filePath, QList<Course*> &courses, QObject *parent = nullptr,
+                            QString *error = nullptr);
+    static bool readCourses(QIODevice *device, QList<Course*> &courses, QObject *parent = nullptr,
+                            QString *error = nullptr);
+    // 析构时是否自动保存（只读工具应关闭）
+    void setAutoSave(bool enabled) { m_autoSave = enabled; }
+    // 课程对象与当前快照的内存估算
+    void reportMemory(MemoryReport &report) const;
 
 signals:
     void coursesChanged();
+    // 细粒度变化通知，批量增删只发一次
+    void coursesInserted(int first, int last);
+    void courseEdited(int index);
+    void coursesRemoved(const QList<Course*> &courses);   // 对象随后才会被删除
+    void coursesReset();
 
 private:
     static const QString DATA_FILE_PATH;
-    static const int VERSION_CODE = 1;
+    static const int VERSION_CODE = 2;   // 2: 增加单双周
 
     int getCurrentSection() const;
+    void publishAll();
 
     QList<Course*> m_courses;
+    bool m_autoSave;
+    bool m_defaultLoaded;       // 是否读取过默认数据文件，只有读取过才会自动保存回去
+    QDate m_semesterStart;
+    SnapshotPublisher<CourseRecord> m_snapshots;
 };
 
 #endif // SCHEDULEMANAGER_H
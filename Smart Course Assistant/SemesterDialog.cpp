@@ -0,0 +1,52 @@
+#include "SemesterDialog.h"
+#include "ui_SemesterDialog.h"
+#include "TraceRecorder.h"
+
+SemesterDialog::SemesterDialog(const QDate &startDate, int weeks, QWidget *parent)
+    : QDialog(parent),
+    ui(new Ui::SemesterDialog)
+{
+    TRACE_SCOPE_CAT("SemesterDialog::SemesterDialog", "dialog");
+    ui->setupUi(this);
+
+    QDate today = QDate::currentDate();
+    ui->startDateEdit->setDate(startDate.isValid() ? startDate : today.addDays(1 - today.dayOfWeek()));
+    ui->weeksSpinBox->setValue(weeks);
+
+    connect(ui->startDateEdit, &QDateEdit::dateChanged, this, &SemesterDialog::updateHint);
+    connect(ui->weeksSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &SemesterDialog::updateHint);
+    connect(ui->buttonBox, &QDialogButtonBox::accepted, this, &QDialog::accept);
+    connect(ui->buttonBox, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    updateHint();
+}
+
+SemesterDialog::~SemesterDialog()
+{
+    delete ui;
+}
+
+// 不是周一时按所在周的周一计算
+QDate SemesterDialog::startDate() const
+{
+    QDate date = ui->startDateEdit->date();
+    return date.addDays(1 - date.dayOfWeek());
+}
+
+int SemesterDialog::weeks() const
+{
+    return ui->weeksSpinBox->value();
+}
+
+void SemesterDialog::updateHint()
+{
+    QDate start = startDate();
+    QDate end = start.addDays(weeks() * 7 - 1);
+    QString text = QString("第1周从 %1 开始，学期到 %2 结束")
+                       .arg(start.toString("yyyy-MM-dd"), end.toString("yyyy-MM-dd"));
+
+    qint64 days = start.daysTo(QDate::currentDate());
+    if (days >= 0 && days < weeks() * 7) {
+        text += QString("；本周为第%1周").arg(days / 7 + 1);
+    }
+    ui->hintLabel->setText(text);
+}
@@ -0,0 +1,30 @@
+#ifndef SEMESTERDIALOG_H
+#define SEMESTERDIALOG_H
+
+#include <QDate>
+#include <QDialog>
+
+namespace Ui {
+class SemesterDialog;
+}
+
+// 设置学期第一周的周一和学期周数；单双周课程与日历的周次都以此为准
+class SemesterDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    // startDate 无效表示尚未设置，此时默认选中本周一
+    SemesterDialog(const QDate &startDate, int weeks, QWidget *parent = nullptr);
+    ~SemesterDialog();
+
+    QDate startDate() const;
+    int weeks() const;
+
+private:
+    void updateHint();
+
+    Ui::SemesterDialog *ui;
+};
+
+#endif // SEMESTERDIALOG_H
@@ -9,6 +9,8 @@ const int DEFAULT_REMINDER_MINUTES = 15;
 const bool DEFAULT_MUTE_STATE = false;
 const QString DEFAULT_THEME = "light";
 const QByteArray DEFAULT_WINDOW_GEOMETRY;
+const int DEFAULT_SEMESTER_WEEKS = 20;
+const int DEFAULT_API_PORT = 8765;
 }
 
 Settings::Settings(QObject *parent)
@@ -111,6 +113,34 @@ void Settings::setDataFilePath(const QString &path)
     m_settings->setValue("Data/FilePath", path);
 }
 
+// 获取/设置学期开始日期（未设置时返回无效日期，由用户在“设置学期”中指定）
+QDate Settings::semesterStartDate() const
+{
+    return m_settings->value("Semester/StartDate").toDate();
+}
+
+void Settings::setSemesterStartDate(const QDate &date)
+{
+    if (date.isValid() && date != semesterStartDate()) {
+        m_settings->setValue("Semester/StartDate", date);
+        emit semesterChanged();
+    }
+}
+
+// 获取/设置学期周数
+int Settings::semesterWeeks() const
+{
+    return m_settings->value("Semester/Weeks", DEFAULT_SEMESTER_WEEKS).toInt();
+}
+
+void Settings::setSemesterWeeks(int weeks)
+{
+    if (weeks > 0 && weeks != semesterWeeks()) {
+        m_settings->setValue("Semester/Weeks", weeks);
+        emit semesterChanged();
+    }
+}
+
 // 重置所有设置为默认值
 void Settings::resetToDefaults()
 {
@@ -130,3 +160,22 @@ void Settings::setTrayEnabled(bool enabled)
         emit trayEnabledChanged(enabled);
     }
 }
+
+bool Settings::isApiEnabled() const
+{
+    return m_settings->value("Api/Enabled", false).toBool();
+}
+
+void Settings::setApiEnabled(bool enabled)
+{
+    if (enabled != isApiEnabled()) {
+        m_settings->setValue("Api/Enabled", enabled);
+        m_settings->sync();
+    }
+}
+
+// 端口只能在配置文件中修改
+int Settings::apiPort() const
+{
+    return m_settings->value("Api/Port", DEFAULT_API_PORT).toInt();
+}
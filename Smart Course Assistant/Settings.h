@@ -5,6 +5,7 @@
 #include <QSettings>
 #include <QColor>
 #include <QByteArray>
+#include <QDate>
 
 class Settings : public QObject
 {
@@ -28,6 +29,10 @@ public:
     // 数据文件设置
     QString dataFilePath() const;
 
+    // 学期设置：开学日期未设置时返回无效日期
+    QDate semesterStartDate() const;
+    int semesterWeeks() const;
+
 public slots:
     void setReminderMinutes(int minutes);
     void setMuted(bool muted);
@@ -36,9 +41,15 @@ public slots:
     void setWindowState(const QByteArray &state);
     void setLastUsedCourseColor(const QColor &color);
     void setDataFilePath(const QString &path);
+    void setSemesterStartDate(const QDate &date);
+    void setSemesterWeeks(int weeks);
     void resetToDefaults();
     bool isTrayEnabled() const;
     void setTrayEnabled(bool enabled);
+    // 本地查询接口（默认关闭）
+    bool isApiEnabled() const;
+    void setApiEnabled(bool enabled);
+    int apiPort() const;
 
 signals:
     void reminderMinutesChanged(int minutes);
@@ -46,6 +57,7 @@ signals:
     void themeChanged(const QString &theme);
     void settingsReset();
     void trayEnabledChanged(bool enabled);
+    void semesterChanged();
 
 private:
     QSettings *m_settings;
@@ -0,0 +1,146 @@
+#include "SingleInstance.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QThread>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace {
+
+// 本地套接字名在 Unix 上位于共享的临时目录，需要按用户区分
+QString instanceName(const QString &key)
+{
+    QString user = qEnvironmentVariable("USER");
+    if (user.isEmpty()) {
+        user = qEnvironmentVariable("USERNAME");
+    }
+    QByteArray hash = QCryptographicHash::hash((key + '\n' + user).toUtf8(),
+                                                QCryptographicHash::Sha1);
+    return key + '-' + QString::fromLatin1(hash.toHex().left(16));
+}
+
+} // namespace
+
+SingleInstance::SingleInstance(const QString &key, QObject *parent)
+    : QObject(parent),
+    m_serverName(instanceName(key)),
+    m_lock(QDir(QDir::tempPath()).filePath(m_serverName + ".lock")),
+    m_server(nullptr)
+{
+    // 主实例可能运行很久，锁文件只按进程是否存在判断残留，不按时间
+    m_lock.setStaleLockTime(0);
+}
+
+SingleInstance::~SingleInstance()
+{
+    if (m_server) {
+        m_server->close();
+    }
+}
+
+bool SingleInstance::listen()
+{
+    if (!m_lock.tryLock(0)) {
+        return false;
+    }
+
+    // 持有锁说明没有其他主实例，遗留的套接字文件来自上次异常退出
+    QLocalServer::removeServer(m_serverName);
+    m_server = new QLocalServer(this);
+    m_server->setSocketOptions(QLocalServer::UserAccessOption);
+    if (!m_server->listen(m_serverName)) {
+        // 仍作为主实例运行，只是之后的启动无法转交命令行
+        qWarning() << "单实例监听失败:" << m_server->errorString();
+        return true;
+    }
+    connect(m_server, &QLocalServer::newConnection, this, &SingleInstance::onNewConnection);
+    return true;
+}
+
+bool SingleInstance::sendArguments(const QStringList &arguments, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    QLocalSocket socket;
+    for (;;) {
+        socket.connectToServer(m_serverName);
+        if (socket.waitForConnected(qMax(1, timeoutMs - int(timer.elapsed())))) {
+            break;
+        }
+        // 主实例已持有锁但还没开始监听时连接会立即失败，稍后重试
+        if (timer.elapsed() >= timeoutMs) {
+            qWarning() << "无法连接到正在运行的实例:" << socket.errorString();
+            return false;
+        }
+        QThread::msleep(20);
+    }
+
+#ifdef Q_OS_WIN
+    // 允许主实例把窗口切到前台，否则系统只会闪烁任务栏按钮
+    AllowSetForegroundWindow(ASFW_ANY);
+#endif
+
+    QDataStream out(&socket);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << MESSAGE_MAGIC << arguments;
+    while (socket.bytesToWrite() > 0) {
+        if (!socket.waitForBytesWritten(qMax(1, timeoutMs - int(timer.elapsed())))) {
+            qWarning() << "向正在运行的实例发送命令行失败:" << socket.errorString();
+            return false;
+        }
+    }
+    socket.disconnectFromServer();
+    if (socket.state() != QLocalSocket::UnconnectedState) {
+        socket.waitForDisconnected(qMax(1, timeoutMs - int(timer.elapsed())));
+    }
+    return true;
+}
+
+void SingleInstance::onNewConnection()
+{
+    while (QLocalSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QLocalSocket::readyRead, this, [this, socket]() {
+            readArguments(socket);
+        });
+        connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+        if (socket->bytesAvailable() > 0) {
+            readArguments(socket);
+        }
+    }
+}
+
+// 消息可能分多次到达，用事务读取，数据不完整时等待下一次 readyRead
+void SingleInstance::readArguments(QLocalSocket *socket)
+{
+    if (socket->bytesAvailable() > MAX_MESSAGE_BYTES) {
+        qWarning() << "转交的命令行过长，已丢弃";
+        socket->abort();
+        return;
+    }
+
+    QDataStream in(socket);
+    in.setVersion(QDataStream::Qt_5_15);
+    in.startTransaction();
+    quint32 magic = 0;
+    QStringList arguments;
+    in >> magic >> arguments;
+    if (!in.commitTransaction()) {
+        return;
+    }
+    if (magic != MESSAGE_MAGIC) {
+        qWarning() << "收到无法识别的单实例消息，已丢弃";
+        socket->abort();
+        return;
+    }
+
+    socket->disconnectFromServer();
+    emit argumentsReceived(arguments);
+}
@@ -0,0 +1,46 @@
+#ifndef SINGLEINSTANCE_H
+#define SINGLEINSTANCE_H
+
+#include <QObject>
+#include <QLockFile>
+#include <QStringList>
+
+class QLocalServer;
+class QLocalSocket;
+
+// 单实例保护：同一用户只运行一个主实例
+// 主实例持有锁文件并监听本地套接字；之后启动的进程把命令行转交给主实例后退出
+// 锁文件按进程号判断是否残留，主实例崩溃后下次启动可以直接接管
+class SingleInstance : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SingleInstance(const QString &key, QObject *parent = nullptr);
+    ~SingleInstance();
+
+    // 成为主实例时返回 true；已有主实例时返回 false，应调用 sendArguments 后退出
+    bool listen();
+    // 把命令行参数（不含程序名）发给主实例，主实例仍在启动时会在超时内重试连接
+    bool sendArguments(const QStringList &arguments, int timeoutMs = 2000);
+
+    QString serverName() const { return m_serverName; }
+
+signals:
+    void argumentsReceived(const QStringList &arguments);
+
+private slots:
+    void onNewConnection();
+
+private:
+    void readArguments(QLocalSocket *socket);
+
+    static const quint32 MESSAGE_MAGIC = 0x53534931;    // "SSI1"
+    static const qint64 MAX_MESSAGE_BYTES = 64 * 1024;
+
+    QString m_serverName;
+    QLockFile m_lock;
+    QLocalServer *m_server;
+};
+
+#endif // SINGLEINSTANCE_H
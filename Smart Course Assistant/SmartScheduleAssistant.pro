@@ -8,37 +8,69 @@ TEMPLATE = app
 QT += core gui
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
+# 后台排序/过滤使用 QtConcurrent
+QT += concurrent
+
+# 单实例保护使用 QLocalServer/QLocalSocket
+QT += network
+
+# 数据模型与存储代码，与命令行工具共用
+include(SmartScheduleCore.pri)
+# 本地查询接口
+include(SmartScheduleServer.pri)
+
 # 源文件列表，列出项目中所有的源文件（.cpp 文件）
 SOURCES += \
     ReminderDialog.cpp \
-    TaskManager.cpp \
     main.cpp \
     MainWindow.cpp \
-    ScheduleManager.cpp \
     Notification.cpp \
-    Task.cpp \
-    Course.cpp \
     CourseDialog.cpp \
     TaskDialog.cpp \
-    Settings.cpp
+    Settings.cpp \
+    NotificationQueue.cpp \
+    TaskTableModel.cpp \
+    TaskSortFilterModel.cpp \
+    CourseTableModel.cpp \
+    CourseItemDelegate.cpp \
+    IconCache.cpp \
+    ThemeManager.cpp \
+    CalendarView.cpp \
+    CalendarDialog.cpp \
+    UndoCommands.cpp \
+    MemoryDialog.cpp \
+    SemesterDialog.cpp \
+    SingleInstance.cpp
 
 # 头文件列表，列出项目中所有的头文件（.h 文件）
 HEADERS += \
     MainWindow.h \
     ReminderDialog.h \
-    ScheduleManager.h \
     Notification.h \
-    Task.h \
-    Course.h \
     CourseDialog.h \
     TaskDialog.h \
     Settings.h \
-    TaskManager.h
+    NotificationQueue.h \
+    TaskTableModel.h \
+    TaskSortFilterModel.h \
+    CourseTableModel.h \
+    CourseItemDelegate.h \
+    IconCache.h \
+    ThemeManager.h \
+    CalendarView.h \
+    CalendarDialog.h \
+    UndoCommands.h \
+    MemoryDialog.h \
+    SemesterDialog.h \
+    SingleInstance.h
 FORMS += \
     MainWindow.ui\
     CourseDialog.ui\
     ReminderDialog.ui \
-    TaskDialog.ui
+    TaskDialog.ui \
+    CalendarDialog.ui \
+    MemoryDialog.ui \
+    SemesterDialog.ui
 # 资源文件列表，指定项目使用的资源文件（.qrc 文件）
 RESOURCES += resources.qrc
 
@@ -0,0 +1,47 @@
+# 核心代码：课程/任务模型、数据文件读写与索引，不依赖 widgets 和 network
+# 由主程序和 cli 等工具共同包含；CMake 构建中对应静态库 SmartScheduleCore
+# 查询接口与多用户服务在 SmartScheduleServer.pri 中，只有主程序和 server 需要
+# qmake CONFIG+=alloc_tracking 时替换全局 operator new/delete，按类别统计分配（见 MemoryStats）
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/Course.cpp \
+    $$PWD/Task.cpp \
+    $$PWD/ScheduleManager.cpp \
+    $$PWD/TaskManager.cpp \
+    $$PWD/Snapshot.cpp \
+    $$PWD/TraceRecorder.cpp \
+    $$PWD/MemoryStats.cpp \
+    $$PWD/DataFileReader.cpp \
+    $$PWD/ProfileImporter.cpp \
+    $$PWD/OccurrenceTimeline.cpp \
+    $$PWD/DeadlineIndex.cpp \
+    $$PWD/TimingWheel.cpp \
+    $$PWD/ReminderDedup.cpp \
+    $$PWD/ScheduleIndex.cpp
+
+HEADERS += \
+    $$PWD/Course.h \
+    $$PWD/Task.h \
+    $$PWD/ScheduleManager.h \
+    $$PWD/TaskManager.h \
+    $$PWD/Snapshot.h \
+    $$PWD/ChunkedVector.h \
+    $$PWD/TraceRecorder.h \
+    $$PWD/MemoryStats.h \
+    $$PWD/DataFileReader.h \
+    $$PWD/ProfileImporter.h \
+    $$PWD/OccurrenceTimeline.h \
+    $$PWD/DeadlineIndex.h \
+    $$PWD/TimingWheel.h \
+    $$PWD/ReminderDedup.h \
+    $$PWD/ScheduleIndex.h
+
+# MemoryStats::peakRssKb 在 Windows 上使用 GetProcessMemoryInfo
+win32: LIBS += -lpsapi
+
+alloc_tracking {
+    DEFINES += SMARTSCHEDULE_ALLOC_TRACKING
+}
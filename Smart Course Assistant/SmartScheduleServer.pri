@@ -0,0 +1,18 @@
+# 查询接口与多用户服务：HTTP 服务器、查询处理、课程目录与用户数据缓存，使用 QtNetwork
+# 只由主程序、server 和 bench 包含，需同时包含 SmartScheduleCore.pri；CMake 构建中对应静态库 SmartScheduleServer
+
+QT += network
+
+SOURCES += \
+    $$PWD/ApiServer.cpp \
+    $$PWD/ScheduleApiHandler.cpp \
+    $$PWD/StringPool.cpp \
+    $$PWD/CourseCatalog.cpp \
+    $$PWD/ProfileStore.cpp
+
+HEADERS += \
+    $$PWD/ApiServer.h \
+    $$PWD/ScheduleApiHandler.h \
+    $$PWD/StringPool.h \
+    $$PWD/CourseCatalog.h \
+    $$PWD/ProfileStore.h
@@ -0,0 +1,56 @@
+#include "Snapshot.h"
+#include "Course.h"
+#include "Task.h"
+
+CourseRecord CourseRecord::fromCourse(const Course &course)
+{
+    CourseRecord record;
+    record.name = course.name();
+    record.dayOfWeek = course.dayOfWeek();
+    record.startSection = course.startSection();
+    record.endSection = course.endSection();
+    record.classroom = course.classroom();
+    record.teacher = course.teacher();
+    record.note = course.note();
+    record.color = course.color();
+    record.weekParity = course.weekParity();
+    return record;
+}
+
+void CourseRecord::applyTo(Course &course) const
+{
+    course.setName(name);
+    course.setDayOfWeek(dayOfWeek);
+    course.setSections(startSection, endSection);
+    course.setClassroom(classroom);
+    course.setTeacher(teacher);
+    course.setNote(note);
+    course.setColor(color);
+    course.setWeekParity(weekParity);
+}
+
+TaskRecord TaskRecord::fromTask(const Task &task)
+{
+    TaskRecord record;
+    record.title = task.title();
+    record.courseName = task.courseName();
+    record.description = task.description();
+    record.dueDate = task.dueDate();
+    record.dueTime = task.dueTime();
+    record.completed = task.isCompleted();
+    record.exam = task.isExam();
+    return record;
+}
+
+Task *TaskRecord::createTask(QObject *parent) const
+{
+    Task *task = new Task(parent);
+    task->setTitle(title);
+    task->setCourseName(courseName);
+    task->setDueDate(dueDate);
+    task->setDueTime(dueTime);
+    task->setDescription(description);
+    task->setCompleted(completed);
+    task->setExam(exam);
+    return task;
+}
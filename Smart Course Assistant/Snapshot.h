@@ -0,0 +1,160 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <QColor>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTime>
+#include <QVector>
+#include <atomic>
+#include <memory>
+#include "ChunkedVector.h"
+
+class Course;
+class Task;
+class QObject;
+
+// 课程的只读副本，可在任意线程读取
+struct CourseRecord {
+    QString name;
+    int dayOfWeek = 1;
+    int startSection = 1;
+    int endSection = 1;
+    QString classroom;
+    QString teacher;
+    QString note;
+    QColor color;
+    int weekParity = 0;     // Course::WeekParity
+
+    static CourseRecord fromCourse(const Course &course);
+    void applyTo(Course &course) const;
+};
+
+// 任务的只读副本，可在任意线程读取
+struct TaskRecord {
+    QString title;
+    QString courseName;
+    QString description;
+    QDate dueDate;
+    QTime dueTime;
+    bool completed = false;
+    bool exam = false;
+
+    static TaskRecord fromTask(const Task &task);
+    Task *createTask(QObject *parent = nullptr) const;
+};
+
+// 某一时刻的完整数据：发布后不再修改
+// 相邻版本之间未变化的记录共用同一份数据；指针数组分块共享，发布一次只复制块索引和被修改的块
+template <typename Record>
+struct Snapshot {
+    quint64 version = 0;
+    ChunkedVector<std::shared_ptr<const Record>> items;
+};
+
+using ScheduleSnapshot = Snapshot<CourseRecord>;
+using TaskSnapshot = Snapshot<TaskRecord>;
+
+// 快照发布器：只在界面线程写入，读取可在任意线程进行且无需加锁
+// 单条修改的开销与块数和块大小有关（约 n/256 个块句柄加 256 个指针），与记录总数 n 不成正比；
+// 基准 snapshotPublish 测量每次修改的发布耗时
+template <typename Record>
+class SnapshotPublisher
+{
+public:
+    using SnapshotPtr = std::shared_ptr<const Snapshot<Record>>;
+
+    SnapshotPublisher()
+        : m_current(std::make_shared<const Snapshot<Record>>()),
+        m_publishCount(0),
+        m_publishNs(0)
+    {
+    }
+
+    using RecordPtr = std::shared_ptr<const Record>;
+
+    SnapshotPtr current() const { return std::atomic_load(&m_current); }
+    quint64 version() const { return current()->version; }
+    RecordPtr at(int index) const { return current()->items.value(index); }
+
+    void append(const Record &record)
+    {
+        insert(-1, std::make_shared<const Record>(record));
+    }
+
+    // 插入已有的记录，与其他快照或撤销历史共用同一份数据；index 为 -1 时追加
+    void insert(int index, const RecordPtr &record)
+    {
+        auto next = begin();
+        if (index < 0 || index > next->items.size()) index = next->items.size();
+        next->items.insert(index, record);
+        publish(next);
+    }
+
+    // 批量追加只发布一次
+    void appendAll(const QVector<RecordPtr> &records)
+    {
+        auto next = begin();
+        next->items += records;
+        publish(next);
+    }
+
+    void replace(int index, const Record &record)
+    {
+        auto next = begin();
+        if (index < 0 || index >= next->items.size()) return;
+        next->items.replace(index, std::make_shared<const Record>(record));
+        publish(next);
+    }
+
+    void remove(int index)
+    {
+        removeRange(index, 1);
+    }
+
+    void removeRange(int index, int count)
+    {
+        auto next = begin();
+        if (index < 0 || count <= 0 || index + count > next->items.size()) return;
+        next->items.remove(index, count);
+        publish(next);
+    }
+
+    void reset(const QVector<Record> &records)
+    {
+        auto next = begin();
+        next->items.clear();
+        for (const Record &record : records) {
+            next->items.append(std::make_shared<const Record>(record));
+        }
+        publish(next);
+    }
+
+    // 发布统计，用于评估每次修改的额外开销
+    quint64 publishCount() const { return m_publishCount; }
+    qint64 totalPublishNs() const { return m_publishNs; }
+
+private:
+    std::shared_ptr<Snapshot<Record>> begin()
+    {
+        m_timer.start();
+        auto next = std::make_shared<Snapshot<Record>>(*current());
+        ++next->version;
+        return next;
+    }
+
+    void publish(const std::shared_ptr<Snapshot<Record>> &next)
+    {
+        std::atomic_store(&m_current, SnapshotPtr(next));
+        ++m_publishCount;
+        m_publishNs += m_timer.nsecsElapsed();
+    }
+
+    SnapshotPtr m_current;
+    QElapsedTimer m_timer;
+    quint64 m_publishCount;
+    qint64 m_publishNs;
+};
+
+#endif // SNAPSHOT_H
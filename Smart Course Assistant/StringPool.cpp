@@ -0,0 +1,38 @@
+#include "StringPool.h"
+#include "MemoryStats.h"
+
+QString StringPool::intern(const QString &text)
+{
+    if (text.isEmpty()) {
+        return QString();
+    }
+    auto it = m_strings.constFind(text);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+    m_strings.insert(text);
+    m_bytes += entryBytes(text);
+    return text;
+}
+
+// 池中的副本未与外部共享时 isDetached() 为 true
+int StringPool::purgeUnused()
+{
+    int removed = 0;
+    for (auto it = m_strings.begin(); it != m_strings.end();) {
+        if (it->isDetached()) {
+            m_bytes -= entryBytes(*it);
+            it = m_strings.erase(it);
+            ++removed;
+        } else {
+            ++it;
+        }
+    }
+    return removed;
+}
+
+// 与 MemoryStats::nodeBytes 的估算方式一致：节点开销加上字符串数据
+qint64 StringPool::entryBytes(const QString &text)
+{
+    return MemoryStats::NODE_OVERHEAD_BYTES + qint64(sizeof(QString)) + MemoryStats::stringBytes(text);
+}
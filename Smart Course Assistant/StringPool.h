@@ -0,0 +1,28 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QSet>
+#include <QString>
+
+// 字符串驻留池：内容相同的字符串共用一份数据（依赖 QString 的隐式共享）
+// 多个用户数据中重复出现的课程名、教室、教师等只保存一次；不是线程安全的
+class StringPool
+{
+public:
+    QString intern(const QString &text);
+
+    // 移除只被池本身引用的字符串，返回移除的数量
+    int purgeUnused();
+
+    int size() const { return m_strings.size(); }
+    // 随驻留和清理增减，不必遍历
+    qint64 bytes() const { return m_bytes; }
+
+private:
+    static qint64 entryBytes(const QString &text);
+
+    QSet<QString> m_strings;
+    qint64 m_bytes = 0;
+};
+
+#endif // STRINGPOOL_H
@@ -2,13 +2,19 @@
 #include <QDate>
 #include <QDebug>
 
+int Task::s_statusEpoch = 0;
+QDate Task::s_statusDate;
+
 // 构造函数
 Task::Task(QObject *parent)
     : QObject(parent),
     m_dueDate(QDate::currentDate()),
     m_dueTime(QTime(23, 59)), // 默认时间 23:59
     m_isCompleted(false),
-    m_isExam(false)
+    m_isExam(false),
+    m_statusEpoch(-1),
+    m_daysRemaining(0),
+    m_statusBucket(UpcomingBucket)
 {
 }
 // 带参数的构造函数
@@ -17,54 +23,92 @@ Task::Task(const QString &title, const QDate &dueDate, bool isExam, QObject *par
     m_title(title),
     m_dueDate(dueDate),
     m_isCompleted(false),
-    m_isExam(isExam)
+    m_isExam(isExam),
+    m_statusEpoch(-1),
+    m_daysRemaining(0),
+    m_statusBucket(UpcomingBucket)
 {
 }
 
-// 计算剩余天数
-int Task::daysRemaining() const
+// 当前用于计算状态的日期，在日期翻转前保持不变
+QDate Task::statusDate()
 {
-    QDate today = QDate::currentDate();
-    if (m_isCompleted) {
-        return 0;
+    if (!s_statusDate.isValid()) {
+        s_statusDate = QDate::currentDate();
     }
-    return today.daysTo(m_dueDate);
+    return s_statusDate;
 }
 
-// 获取状态文本
-QString Task::statusText() const
+void Task::advanceStatusDate()
 {
-    if (m_isCompleted) {
-        return tr("已完成");
+    s_statusDate = QDate::currentDate();
+    ++s_statusEpoch;
+}
+
+// 一次性计算剩余天数、分类、颜色和文本
+void Task::ensureStatus() const
+{
+    if (m_statusEpoch == s_statusEpoch) {
+        return;
     }
 
-    int days = daysRemaining();
-    if (days < 0) {
-        return tr("已过期 %1 天").arg(-days);
-    } else if (days == 0) {
-        return tr("今天截止");
+    if (m_isCompleted) {
+        m_daysRemaining = 0;
+        m_statusBucket = CompletedBucket;
+        m_statusText = tr("已完成");
+        m_priorityColor = QColor(200, 200, 200); // 灰色表示已完成
     } else {
-        return tr("还剩 %1 天").arg(days);
+        int days = statusDate().daysTo(m_dueDate);
+        m_daysRemaining = days;
+        if (days < 0) {
+            m_statusBucket = OverdueBucket;
+            m_statusText = tr("已过期 %1 天").arg(-days);
+            m_priorityColor = QColor(255, 100, 100); // 红色表示已过期
+        } else if (days == 0) {
+            m_statusBucket = DueTodayBucket;
+            m_statusText = tr("今天截止");
+            m_priorityColor = QColor(255, 200, 100); // 橙色表示即将截止
+        } else {
+            m_statusBucket = days <= 3 ? DueSoonBucket : UpcomingBucket;
+            m_statusText = tr("还剩 %1 天").arg(days);
+            if (days <= 3) {
+                m_priorityColor = QColor(255, 200, 100); // 橙色表示即将截止
+            } else if (m_isExam) {
+                m_priorityColor = QColor(100, 150, 255); // 蓝色表示考试
+            } else {
+                m_priorityColor = QColor(150, 255, 150); // 绿色表示普通作业
+            }
+        }
     }
+
+    m_statusEpoch = s_statusEpoch;
+}
+
+// 计算剩余天数
+int Task::daysRemaining() const
+{
+    ensureStatus();
+    return m_daysRemaining;
+}
+
+// 获取状态文本
+QString Task::statusText() const
+{
+    ensureStatus();
+    return m_statusText;
 }
 
 // 获取优先级颜色
 QColor Task::priorityColor() const
 {
-    if (m_isCompleted) {
-        return QColor(200, 200, 200); // 灰色表示已完成
-    }
+    ensureStatus();
+    return m_priorityColor;
+}
 
-    int days = daysRemaining();
-    if (days < 0) {
-        return QColor(255, 100, 100); // 红色表示已过期
-    } else if (days <= 3) {
-        return QColor(255, 200, 100); // 橙色表示即将截止
-    } else if (m_isExam) {
-        return QColor(100, 150, 255); // 蓝色表示考试
-    } else {
-        return QColor(150, 255, 150); // 绿色表示普通作业
-    }
+Task::StatusBucket Task::statusBucket() const
+{
+    ensureStatus();
+    return static_cast<StatusBucket>(m_statusBucket);
 }
 
 // 序列化操作
@@ -89,6 +133,7 @@ QDataStream &operator>>(QDataStream &in, Task &task)
         >> task.m_description
         >> task.m_isCompleted
         >> task.m_isExam;
+    task.invalidateStatus();
     return in;
 }
 
@@ -97,7 +142,11 @@ QString Task::title() const { return m_title; }
 void Task::setTitle(const QString &title) { m_title = title; }
 
 QDate Task::dueDate() const { return m_dueDate; }
-void Task::setDueDate(const QDate &date) { m_dueDate = date; }
+void Task::setDueDate(const QDate &date)
+{
+    m_dueDate = date;
+    invalidateStatus();
+}
 
 QString Task::courseName() const { return m_courseName; }
 void Task::setCourseName(const QString &name) { m_courseName = name; }
@@ -110,6 +159,7 @@ void Task::setCompleted(bool completed)
 {
     if (m_isCompleted != completed) {
         m_isCompleted = completed;
+        invalidateStatus();
         emit statusChanged();
     }
 }
@@ -119,6 +169,7 @@ void Task::setExam(bool exam)
 {
     if (m_isExam != exam) {
         m_isExam = exam;
+        invalidateStatus();
         emit statusChanged();
     }
 }
@@ -31,6 +31,19 @@ private:
     bool m_isCompleted;      // 是否完成
     bool m_isExam;           // 是否为考试
 
+    // 派生状态缓存：任务变化或日期翻转后才重新计算
+    mutable int m_statusEpoch;
+    mutable int m_daysRemaining;
+    mutable int m_statusBucket;
+    mutable QColor m_priorityColor;
+    mutable QString m_statusText;
+
+    static int s_statusEpoch;
+    static QDate s_statusDate;
+
+    void ensureStatus() const;
+    void invalidateStatus() { m_statusEpoch = -1; }
+
 public:
     explicit Task(QObject *parent = nullptr);
     Task(const QString &title, const QDate &dueDate, bool isExam = false, QObject *parent = nullptr);
@@ -44,10 +57,26 @@ public:
     friend QDataStream &operator<<(QDataStream &out, const Task &task);
     friend QDataStream &operator>>(QDataStream &in, Task &task);
 
-    // 状态计算
+    // 状态分类
+    enum StatusBucket {
+        CompletedBucket = 0,
+        OverdueBucket,
+        DueTodayBucket,
+        DueSoonBucket,      // 3天内截止
+        UpcomingBucket
+    };
+
+    // 状态计算（结果按天缓存）
     int daysRemaining() const;
     QString statusText() const;
     QColor priorityColor() const;
+    StatusBucket statusBucket() const;
+    // 已缓存的状态文本（可能已过期），从未计算过时为空；内存统计用，不触发计算
+    const QString &cachedStatusText() const { return m_statusText; }
+
+    // 日期翻转时调用，使所有任务的状态缓存失效（仅在界面线程使用）
+    static void advanceStatusDate();
+    static QDate statusDate();
 
     // Getter和Setter
     QString title() const;
@@ -1,5 +1,6 @@
 #include "TaskDialog.h"
 #include "ui_TaskDialog.h"
+#include "TraceRecorder.h"
 #include <QMessageBox>
 #include <QDate>
 
@@ -7,6 +8,7 @@ TaskDialog::TaskDialog(QWidget *parent) :
     QDialog(parent),
     ui(new Ui::TaskDialog)
 {
+    TRACE_SCOPE_CAT("TaskDialog::TaskDialog", "dialog");
     // 调用 Qt 自动生成的 setupUi 函数来初始化 UI
     ui->setupUi(this);
 
@@ -1,14 +1,89 @@
 #include "TaskManager.h"
+#include "TraceRecorder.h"
+#include "MemoryStats.h"
+#include "DataFileReader.h"
 #include <QStandardPaths>
 #include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QDateTime>
 
-TaskManager::TaskManager(QObject *parent) : QObject(parent) {}
+TaskManager::TaskManager(QObject *parent) : QObject(parent)
+{
+    // 只在午夜统一刷新任务状态，不在每次绘制时重新计算
+    m_rolloverTimer.setSingleShot(true);
+    connect(&m_rolloverTimer, &QTimer::timeout, this, &TaskManager::onDayRollover);
+    scheduleDayRollover();
+}
+
+void TaskManager::scheduleDayRollover()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QDateTime midnight(now.date().addDays(1), QTime(0, 0));
+    // 多等一秒，确保触发时已经是新的一天
+    qint64 msecs = now.msecsTo(midnight) + 1000;
+    m_rolloverTimer.start(static_cast<int>(qMax<qint64>(1000, msecs)));
+}
+
+void TaskManager::onDayRollover()
+{
+    if (QDate::currentDate() != Task::statusDate()) {
+        Task::advanceStatusDate();
+        emit statusDateChanged();
+    }
+    scheduleDayRollover();
+}
 
 void TaskManager::addTask(Task *task)
 {
     if (!task) return;
     m_tasks.append(task);
+    m_snapshots.append(TaskRecord::fromTask(*task));
+    emit tasksInserted(m_tasks.size() - 1, m_tasks.size() - 1);
+    emit tasksChanged();
+}
+
+void TaskManager::insertTask(int index, Task *task)
+{
+    if (!task) return;
+    if (index < 0 || index > m_tasks.size()) index = m_tasks.size();
+    m_tasks.insert(index, task);
+    m_snapshots.insert(index, std::make_shared<const TaskRecord>(TaskRecord::fromTask(*task)));
+    emit tasksInserted(index, index);
+    emit tasksChanged();
+}
+
+// 批量追加，快照只发布一次，插入通知也只发一次
+void TaskManager::addTasks(const QList<Task*> &tasks)
+{
+    QVector<std::shared_ptr<const TaskRecord>> records;
+    records.reserve(tasks.size());
+    int first = m_tasks.size();
+    for (Task *task : tasks) {
+        if (!task) continue;
+        m_tasks.append(task);
+        records.append(std::make_shared<const TaskRecord>(TaskRecord::fromTask(*task)));
+    }
+    if (records.isEmpty()) return;
+    m_snapshots.appendAll(records);
+    emit tasksInserted(first, m_tasks.size() - 1);
+    emit tasksChanged();
+}
+
+// 连续区间整体移除，前后各通知一次
+void TaskManager::removeTasks(int index, int count)
+{
+    if (index < 0 || count <= 0 || index + count > m_tasks.size()) return;
+
+    const int last = index + count - 1;
+    emit tasksAboutToBeRemoved(index, last);
+    for (int i = index; i <= last; ++i) {
+        m_tasks.at(i)->deleteLater();
+    }
+    m_tasks.erase(m_tasks.begin() + index, m_tasks.begin() + index + count);
+    m_snapshots.removeRange(index, count);
+    emit tasksRemoved(index, last);
     emit tasksChanged();
 }
 
@@ -19,13 +94,17 @@ void TaskManager::removeTask(Task *task)
         return;
     }
 
-    if (!m_tasks.contains(task)) {
+    int index = m_tasks.indexOf(task);
+    if (index < 0) {
         qWarning() << "任务不在列表中:" << task->title();
         return;
     }
 
-    m_tasks.removeOne(task);
+    emit tasksAboutToBeRemoved(index, index);
+    m_tasks.removeAt(index);
+    m_snapshots.remove(index);
     task->deleteLater();
+    emit tasksRemoved(index, index);
     emit tasksChanged();
     qDebug() << "已删除任务:" << task->title();
 }
@@ -38,15 +117,18 @@ void TaskManager::setTaskCompleted(Task *task, bool completed)
     }
 
     // 确保任务存在于列表中
-    if (!m_tasks.contains(task)) {
+    int index = m_tasks.indexOf(task);
+    if (index < 0) {
         qWarning() << "任务不在列表中:" << task->title();
         return;
     }
 
     // 设置完成状态
     task->setCompleted(completed);
+    m_snapshots.replace(index, TaskRecord::fromTask(*task));
 
     // 通知变化
+    emit taskUpdated(index, task);
     emit tasksChanged();
 }
 
@@ -56,75 +138,163 @@ const QList<Task*>& TaskManager::getAllTasks() const
 }
 
 
-const QString TaskManager::TASK_FILE_PATH =
-    QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/tasks.dat";
+// 重新生成全部记录的快照
+void TaskManager::publishAll()
+{
+    MemoryStats::Scope memoryScope(MemoryStats::Snapshots);
+    QVector<TaskRecord> records;
+    records.reserve(m_tasks.size());
+    for (const Task *task : std::as_const(m_tasks)) {
+        records.append(TaskRecord::fromTask(*task));
+    }
+    m_snapshots.reset(records);
+}
+
+const QString TaskManager::TASK_FILE_PATH = "tasks.dat";
+
+QString TaskManager::dataFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/" + TASK_FILE_PATH;
+}
 
 void TaskManager::saveTasks() const
 {
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir(dataDir);
+    saveTasks(dataFilePath());
+}
+
+bool TaskManager::saveTasks(const QString &filePath) const
+{
+    TRACE_SCOPE_CAT("TaskManager::saveTasks", "io");
+    return writeTasks(filePath, *snapshot());
+}
+
+// 按快照写入任务文件，可在工作线程中调用
+bool TaskManager::writeTasks(const QString &filePath, const TaskSnapshot &snapshot)
+{
+    QDir dir = QFileInfo(filePath).absoluteDir();
     if (!dir.exists()) {
-        dir.mkpath(dataDir);
+        dir.mkpath(".");
     }
 
-    QString filePath = dataDir + "/tasks.dat";
     QFile file(filePath);
 
     if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "无法打开任务文件进行写入:" << TASK_FILE_PATH;
-        return;
+        qWarning() << "无法打开任务文件进行写入:" << filePath;
+        return false;
     }
 
     QDataStream out(&file);
     out.setVersion(QDataStream::Qt_5_15);
-    out << static_cast<quint32>(m_tasks.size());
+    out << static_cast<quint32>(snapshot.items.size());
+
+    for (const auto &task : snapshot.items) {
+        writeTaskRecord(out, *task);
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+// 写入单个任务，字段顺序与 readTasks 一致
+void TaskManager::writeTaskRecord(QDataStream &out, const TaskRecord &task)
+{
+    out << task.title
+    << task.courseName
+    << task.dueDate
+    << task.dueTime
+    << task.description
+    << task.completed
+    << task.exam;
+}
+void TaskManager::reportMemory(MemoryReport &report) const
+{
+    qint64 bytes = MemoryStats::ARRAY_HEADER_BYTES + qint64(m_tasks.size()) * qint64(sizeof(Task*));
+    qint64 stringBytes = 0;
+    for (const Task *task : std::as_const(m_tasks)) {
+        bytes += MemoryStats::taskBytes(*task);
+        stringBytes += MemoryStats::taskStringBytes(*task);
+    }
+    report.add("任务对象", m_tasks.size(), bytes, stringBytes);
+
+    std::shared_ptr<const TaskSnapshot> current = snapshot();
+    report.add("任务快照", current->items.size(),
+               qint64(sizeof(TaskSnapshot)) + MemoryStats::SHARED_PTR_BLOCK_BYTES
+                   + MemoryStats::vectorBytes(current->items)
+                   + qint64(current->items.size()) * MemoryStats::taskRecordBytes());
+}
+
+// 逐条读取并校验，遇到损坏的记录即停止，已读出的任务保留在 tasks 中
+// 文件只有记录数而没有版本号，记录数读不出来时返回 false
+bool TaskManager::readTasks(QIODevice *device, QList<Task*> &tasks, QObject *parent, QString *error)
+{
+    MemoryStats::Scope memoryScope(MemoryStats::Tasks);
+    DataFileReader reader(device);
+    QDataStream &in = reader.stream();
 
-    for (const auto &task : m_tasks) {
-        out << task->title()
-        << task->courseName()
-        << task->dueDate()
-        << task->dueTime()
-        << task->description()
-        << task->isCompleted()
-        << task->isExam();
+    quint32 declared = 0;
+    in >> declared;
+    if (!reader.checkStatus("记录数")) {
+        if (error) {
+            *error = reader.error();
+        }
+        return false;
     }
+
+    // 标题、课程、描述三个字符串 + 日期 + 时间 + 两个布尔值
+    const qint64 minRecordBytes = 3 * DataFileReader::STRING_HEADER_BYTES + DataFileReader::DATE_BYTES
+                                  + DataFileReader::TIME_BYTES + 2;
+    const quint32 count = reader.checkedCount(declared, minRecordBytes);
+
+    for (quint32 i = 0; i < count; ++i) {
+        TaskRecord record;
+        if (!reader.readString(record.title) || !reader.readString(record.courseName)) break;
+        in >> record.dueDate >> record.dueTime;
+        if (!reader.checkStatus("截止时间")) break;
+        if (!reader.readString(record.description)) break;
+        in >> record.completed >> record.exam;
+        if (!reader.checkStatus("任务状态")) break;
+
+        if (!record.dueDate.isNull() && !record.dueDate.isValid()) {
+            reader.fail(QString("第 %1 项任务的截止日期无效").arg(i + 1));
+            break;
+        }
+        tasks.append(record.createTask(parent));
+    }
+
+    if (error) {
+        *error = reader.error();
+    }
+    return true;
 }
 
 void TaskManager::loadTasks()
 {
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    loadTasks(dataFilePath());
+}
 
-    QString filePath = dataDir + "/tasks.dat";
+bool TaskManager::loadTasks(const QString &filePath)
+{
+    TRACE_SCOPE_CAT("TaskManager::loadTasks", "io");
     QFile file(filePath);
     if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
-        qWarning() << "无法打开任务文件进行读取:" << TASK_FILE_PATH;
-        return;
+        qWarning() << "无法打开任务文件进行读取:" << filePath;
+        return false;
     }
 
-    QDataStream in(&file);
-    in.setVersion(QDataStream::Qt_5_15);
-
-    quint32 count;
-    in >> count;
+    QList<Task*> tasks;
+    QString error;
+    if (!readTasks(&file, tasks, this, &error)) {
+        qWarning() << "无法读取任务文件:" << filePath << error;
+        return false;
+    }
+    if (!error.isEmpty()) {
+        qWarning() << "任务文件已损坏:" << filePath << error << "，保留前" << tasks.size() << "项任务";
+        DataFileReader::preserveDamagedFile(filePath);
+    }
 
-    for (quint32 i = 0; i < count; ++i) {
-        QString title, courseName, description;
-        QDate dueDate;
-        QTime dueTime;
-        bool isCompleted, isExam;
-
-        // 确保读取所有字段
-        in >> title >> courseName >> dueDate >> dueTime >> description >> isCompleted >> isExam;
-
-        Task *task = new Task(this);
-        task->setTitle(title);
-        task->setCourseName(courseName);
-        task->setDueDate(dueDate);
-        task->setDueTime(dueTime);  // 设置时间
-        task->setDescription(description);
-        task->setCompleted(isCompleted);
-        task->setExam(isExam);
+    // 重新加载时释放旧的任务对象
+    qDeleteAll(m_tasks);
+    m_tasks = tasks;
+    publishAll();
 
-        m_tasks.append(task);
-    }
+    emit tasksReset();
+    return true;
 }
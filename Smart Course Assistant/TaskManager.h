@@ -3,7 +3,12 @@
 
 #include <QObject>
 #include <QList>
+#include <QTimer>
 #include "Task.h"
+#include "Snapshot.h"
+
+class MemoryReport;
+class QIODevice;
 
 class TaskManager : public QObject
 {
@@ -14,15 +19,49 @@ public:
     void addTask(Task *task);
     void removeTask(Task *task);
     void setTaskCompleted(Task *task, bool completed);
+    // 撤销/重做与批量导入使用
+    void insertTask(int index, Task *task);
+    void addTasks(const QList<Task*> &tasks);
+    void removeTasks(int index, int count);
     const QList<Task*>& getAllTasks() const;
     void loadTasks();
     void saveTasks() const;
+    // 指定文件读写；成功返回 true
+    bool loadTasks(const QString &filePath);
+    bool saveTasks(const QString &filePath) const;
+    static QString dataFilePath();
+    static bool writeTasks(const QString &filePath, const TaskSnapshot &snapshot);
+    static void writeTaskRecord(QDataStream &out, const TaskRecord &task);
+    // 文件损坏时保留能读出的前缀，error 中给出原因；连记录数都读不出时返回 false
+    static bool readTasks(QIODevice *device, QList<Task*> &tasks, QObject *parent = nullptr,
+                          QString *error = nullptr);
+
+    // 最新的只读快照，可交给工作线程使用
+    std::shared_ptr<const TaskSnapshot> snapshot() const { return m_snapshots.current(); }
+    const SnapshotPublisher<TaskRecord> &snapshots() const { return m_snapshots; }
+
+    // 任务对象与当前快照的内存估算
+    void reportMemory(MemoryReport &report) const;
 
 signals:
     void tasksChanged();
+    // 细粒度变化通知，行号区间 [first, last] 为闭区间，批量增删只发一次
+    void tasksInserted(int first, int last);
+    void tasksAboutToBeRemoved(int first, int last);   // 任务仍在列表中
+    void tasksRemoved(int first, int last);
+    void taskUpdated(int index, Task *task);
+    void tasksReset();
+    // 日期翻转，所有任务的剩余天数和状态文本已失效
+    void statusDateChanged();
 
 private:
+    void scheduleDayRollover();
+    void onDayRollover();
+    void publishAll();
+
     QList<Task*> m_tasks;
+    QTimer m_rolloverTimer;
+    SnapshotPublisher<TaskRecord> m_snapshots;
     static const QString TASK_FILE_PATH;
 };
 
@@ -0,0 +1,509 @@
+#include "TaskSortFilterModel.h"
+#include "TaskTableModel.h"
+#include "TraceRecorder.h"
+#include "MemoryStats.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QDate>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+#include <utility>
+
+namespace {
+const int FILTER_DEBOUNCE_MS = 150;
+// 一次删除分散成过多代理区间时改为整体重置，避免逐段通知视图
+const int MAX_REMOVE_RANGES = 32;
+}
+
+TaskSortFilterModel::TaskSortFilterModel(QObject *parent)
+    : QAbstractProxyModel(parent),
+    m_generation(new QAtomicInt(0))
+{
+    m_debounce.setSingleShot(true);
+    connect(&m_debounce, &QTimer::timeout, this, &TaskSortFilterModel::startRecompute);
+    connect(&m_watcher, &QFutureWatcher<Result>::finished, this, &TaskSortFilterModel::applyResult);
+}
+
+void TaskSortFilterModel::setSourceModel(QAbstractItemModel *newSource)
+{
+    beginResetModel();
+
+    if (sourceModel()) {
+        disconnect(sourceModel(), nullptr, this, nullptr);
+    }
+    QAbstractProxyModel::setSourceModel(newSource);
+
+    if (newSource) {
+        connect(newSource, &QAbstractItemModel::rowsAboutToBeRemoved,
+                this, &TaskSortFilterModel::onSourceRowsAboutToBeRemoved);
+        connect(newSource, &QAbstractItemModel::rowsRemoved,
+                this, &TaskSortFilterModel::onSourceRowsRemoved);
+        connect(newSource, &QAbstractItemModel::rowsInserted,
+                this, &TaskSortFilterModel::onSourceRowsInserted);
+        connect(newSource, &QAbstractItemModel::dataChanged,
+                this, &TaskSortFilterModel::onSourceDataChanged);
+        connect(newSource, &QAbstractItemModel::modelReset,
+                this, &TaskSortFilterModel::onSourceReset);
+    }
+
+    // 结果返回前先按源顺序显示
+    rebuildKeys();
+    m_proxyToSource.resize(m_keys.size());
+    for (int i = 0; i < m_keys.size(); ++i) {
+        m_proxyToSource[i] = i;
+    }
+    rebuildSourceToProxy();
+
+    endResetModel();
+    scheduleRecompute();
+}
+
+QModelIndex TaskSortFilterModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (parent.isValid() || row < 0 || row >= m_proxyToSource.size() ||
+        column < 0 || column >= columnCount()) {
+        return QModelIndex();
+    }
+    return createIndex(row, column);
+}
+
+QModelIndex TaskSortFilterModel::parent(const QModelIndex &) const
+{
+    return QModelIndex();
+}
+
+int TaskSortFilterModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_proxyToSource.size();
+}
+
+int TaskSortFilterModel::columnCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !sourceModel()) return 0;
+    return sourceModel()->columnCount();
+}
+
+QModelIndex TaskSortFilterModel::mapToSource(const QModelIndex &proxyIndex) const
+{
+    if (!proxyIndex.isValid() || !sourceModel() ||
+        proxyIndex.row() >= m_proxyToSource.size()) {
+        return QModelIndex();
+    }
+    return sourceModel()->index(m_proxyToSource.at(proxyIndex.row()), proxyIndex.column());
+}
+
+QModelIndex TaskSortFilterModel::mapFromSource(const QModelIndex &sourceIndex) const
+{
+    if (!sourceIndex.isValid() || sourceIndex.row() >= m_sourceToProxy.size()) {
+        return QModelIndex();
+    }
+    int row = m_sourceToProxy.at(sourceIndex.row());
+    return row < 0 ? QModelIndex() : createIndex(row, sourceIndex.column());
+}
+
+QVariant TaskSortFilterModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && sourceModel()) {
+        return sourceModel()->headerData(section, orientation, role);
+    }
+    if (role == Qt::DisplayRole) {
+        return section + 1;
+    }
+    return QVariant();
+}
+
+void TaskSortFilterModel::sort(int column, Qt::SortOrder order)
+{
+    m_criteria.sortColumn = column;
+    m_criteria.order = order;
+    scheduleRecompute();
+}
+
+void TaskSortFilterModel::setFilterText(const QString &text)
+{
+    QString normalized = text.trimmed().toLower();
+    if (normalized == m_criteria.text) return;
+    m_criteria.text = normalized;
+    // 连续输入时只计算最后一次
+    scheduleRecompute(FILTER_DEBOUNCE_MS);
+}
+
+void TaskSortFilterModel::setStatusFilter(StatusFilter filter)
+{
+    if (filter == m_criteria.status) return;
+    m_criteria.status = filter;
+    scheduleRecompute();
+}
+
+void TaskSortFilterModel::setTypeFilter(TypeFilter filter)
+{
+    if (filter == m_criteria.type) return;
+    m_criteria.type = filter;
+    scheduleRecompute();
+}
+
+// 工作线程：对快照过滤并排序，发现有更新的请求时提前放弃
+TaskSortFilterModel::Result TaskSortFilterModel::compute(QVector<SortKey> keys, Criteria criteria,
+                                                         int generation,
+                                                         QSharedPointer<QAtomicInt> latest)
+{
+    TRACE_SCOPE_CAT("TaskSortFilterModel::compute", "model");
+    QElapsedTimer timer;
+    timer.start();
+
+    Result result;
+    result.generation = generation;
+
+    QVector<const SortKey*> selected;
+    selected.reserve(keys.size());
+    for (const SortKey &key : std::as_const(keys)) {
+        if (matches(key, criteria)) {
+            selected.append(&key);
+        }
+    }
+
+    if (latest->loadAcquire() != generation) {
+        return result;
+    }
+
+    if (criteria.sortColumn >= 0) {
+        auto less = [&criteria](const SortKey *a, const SortKey *b) {
+            switch (criteria.sortColumn) {
+            case TaskTableModel::StatusColumn:
+                if (a->completed != b->completed) return a->completed < b->completed;
+                return a->dueKey < b->dueKey;
+            case TaskTableModel::CourseColumn:
+                if (a->course != b->course) return a->course < b->course;
+                return a->dueKey < b->dueKey;
+            case TaskTableModel::TitleColumn:
+                return a->title < b->title;
+            default:
+                return a->dueKey < b->dueKey;
+            }
+        };
+        if (criteria.order == Qt::AscendingOrder) {
+            std::stable_sort(selected.begin(), selected.end(), less);
+        } else {
+            std::stable_sort(selected.begin(), selected.end(),
+                             [&less](const SortKey *a, const SortKey *b) { return less(b, a); });
+        }
+    }
+
+    if (latest->loadAcquire() != generation) {
+        return result;
+    }
+
+    result.proxyToSource.reserve(selected.size());
+    for (const SortKey *key : std::as_const(selected)) {
+        result.proxyToSource.append(key->sourceRow);
+    }
+    result.elapsedMs = timer.nsecsElapsed() / 1e6;
+    return result;
+}
+
+bool TaskSortFilterModel::matches(const SortKey &key, const Criteria &criteria)
+{
+    if (!criteria.text.isEmpty() &&
+        !key.title.contains(criteria.text) && !key.course.contains(criteria.text)) {
+        return false;
+    }
+
+    switch (criteria.status) {
+    case OpenOnly:
+        if (key.completed) return false;
+        break;
+    case CompletedOnly:
+        if (!key.completed) return false;
+        break;
+    case OverdueOnly:
+        if (key.completed || key.dueDay >= criteria.today) return false;
+        break;
+    default:
+        break;
+    }
+
+    switch (criteria.type) {
+    case HomeworkOnly:
+        return !key.exam;
+    case ExamOnly:
+        return key.exam;
+    default:
+        return true;
+    }
+}
+
+// 剩余时间列与背景色等只影响显示，不需要重新生成排序键
+bool TaskSortFilterModel::affectsKeys(int firstColumn, int, const QVector<int> &roles)
+{
+    if (firstColumn > TaskTableModel::DueDateColumn) {
+        return false;
+    }
+    return roles.isEmpty() || roles.contains(Qt::DisplayRole) || roles.contains(Qt::DecorationRole)
+           || roles.contains(TaskTableModel::TaskRole);
+}
+
+// 从任务字段生成排序键
+TaskSortFilterModel::SortKey TaskSortFilterModel::makeKey(int sourceRow) const
+{
+    SortKey key;
+    key.sourceRow = sourceRow;
+
+    Task *task = sourceModel()->index(sourceRow, 0).data(TaskTableModel::TaskRole).value<Task*>();
+    if (!task) {
+        return key;
+    }
+
+    QTime dueTime = task->dueTime().isValid() ? task->dueTime() : QTime(23, 59);
+    key.dueDay = task->dueDate().toJulianDay();
+    key.dueKey = key.dueDay * 1440 + dueTime.hour() * 60 + dueTime.minute();
+    key.course = task->courseName().toLower();
+    key.title = task->title().toLower();
+    key.completed = task->isCompleted();
+    key.exam = task->isExam();
+    return key;
+}
+
+void TaskSortFilterModel::rebuildKeys()
+{
+    m_keys.clear();
+    if (!sourceModel()) return;
+
+    int rows = sourceModel()->rowCount();
+    m_keys.reserve(rows);
+    for (int row = 0; row < rows; ++row) {
+        m_keys.append(makeKey(row));
+    }
+}
+
+void TaskSortFilterModel::rebuildSourceToProxy()
+{
+    m_sourceToProxy.fill(-1, m_keys.size());
+    for (int i = 0; i < m_proxyToSource.size(); ++i) {
+        int source = m_proxyToSource.at(i);
+        if (source >= 0 && source < m_sourceToProxy.size()) {
+            m_sourceToProxy[source] = i;
+        }
+    }
+}
+
+// 任何变化都使正在进行的计算失效
+void TaskSortFilterModel::scheduleRecompute(int delayMs)
+{
+    m_generation->fetchAndAddOrdered(1);
+    m_debounce.start(delayMs);
+}
+
+void TaskSortFilterModel::startRecompute()
+{
+    if (!sourceModel()) return;
+
+    m_criteria.today = QDate::currentDate().toJulianDay();
+    // QVector 为隐式共享，传给工作线程的快照不需要复制数据
+    m_watcher.setFuture(QtConcurrent::run(&TaskSortFilterModel::compute,
+                                          m_keys, m_criteria,
+                                          m_generation->loadAcquire(), m_generation));
+}
+
+// 界面线程：一次性替换行序
+void TaskSortFilterModel::applyResult()
+{
+    TRACE_SCOPE_CAT("TaskSortFilterModel::applyResult", "model");
+    Result result = m_watcher.result();
+    if (result.generation != m_generation->loadAcquire()) {
+        return; // 已有更新的请求
+    }
+
+    if (result.proxyToSource.size() != m_proxyToSource.size()) {
+        beginResetModel();
+        m_proxyToSource = result.proxyToSource;
+        rebuildSourceToProxy();
+        endResetModel();
+    } else {
+        // 行数不变时保留选中状态
+        emit layoutAboutToBeChanged();
+        const QModelIndexList oldIndexes = persistentIndexList();
+        QVector<int> sourceRows;
+        sourceRows.reserve(oldIndexes.size());
+        for (const QModelIndex &index : oldIndexes) {
+            sourceRows.append(m_proxyToSource.value(index.row(), -1));
+        }
+
+        m_proxyToSource = result.proxyToSource;
+        rebuildSourceToProxy();
+
+        QModelIndexList newIndexes;
+        newIndexes.reserve(oldIndexes.size());
+        for (int i = 0; i < oldIndexes.size(); ++i) {
+            int row = m_sourceToProxy.value(sourceRows.at(i), -1);
+            newIndexes.append(row < 0 ? QModelIndex() : createIndex(row, oldIndexes.at(i).column()));
+        }
+        changePersistentIndexList(oldIndexes, newIndexes);
+        emit layoutChanged();
+    }
+
+    emit resultApplied(m_proxyToSource.size(), result.elapsedMs);
+}
+
+void TaskSortFilterModel::onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) return;
+
+    // 源行删除前先移除对应的代理行：按代理行号合并为连续区间，从后往前移除
+    QVector<int> rows;
+    for (int source = first; source <= last; ++source) {
+        int row = m_sourceToProxy.value(source, -1);
+        if (row >= 0) {
+            rows.append(row);
+        }
+    }
+    if (rows.isEmpty()) return;
+    std::sort(rows.begin(), rows.end());
+
+    QVector<std::pair<int, int>> ranges;
+    for (int i = 0; i < rows.size();) {
+        int j = i;
+        while (j + 1 < rows.size() && rows.at(j + 1) == rows.at(j) + 1) {
+            ++j;
+        }
+        ranges.append({rows.at(i), rows.at(j)});
+        i = j + 1;
+    }
+
+    if (ranges.size() > MAX_REMOVE_RANGES) {
+        beginResetModel();
+        QVector<int> kept;
+        kept.reserve(m_proxyToSource.size() - rows.size());
+        for (int source : std::as_const(m_proxyToSource)) {
+            if (source < first || source > last) {
+                kept.append(source);
+            }
+        }
+        m_proxyToSource = kept;
+        rebuildSourceToProxy();
+        endResetModel();
+        return;
+    }
+
+    for (int i = ranges.size() - 1; i >= 0; --i) {
+        beginRemoveRows(QModelIndex(), ranges.at(i).first, ranges.at(i).second);
+        m_proxyToSource.remove(ranges.at(i).first, ranges.at(i).second - ranges.at(i).first + 1);
+        endRemoveRows();
+    }
+    rebuildSourceToProxy();
+}
+
+void TaskSortFilterModel::onSourceRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) return;
+
+    int count = last - first + 1;
+    m_keys.remove(first, count);
+    for (int i = first; i < m_keys.size(); ++i) {
+        m_keys[i].sourceRow = i;
+    }
+    for (int &source : m_proxyToSource) {
+        if (source > last) {
+            source -= count;
+        }
+    }
+    rebuildSourceToProxy();
+    scheduleRecompute();
+}
+
+void TaskSortFilterModel::onSourceRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    if (parent.isValid()) return;
+
+    int count = last - first + 1;
+    for (int &source : m_proxyToSource) {
+        if (source >= first) {
+            source += count;
+        }
+    }
+    // 整段插入后再填充，避免逐行插入时反复移动后面的键
+    m_keys.insert(first, count, SortKey());
+    for (int row = first; row <= last; ++row) {
+        m_keys[row] = makeKey(row);
+    }
+    for (int i = last + 1; i < m_keys.size(); ++i) {
+        m_keys[i].sourceRow = i;
+    }
+
+    // 新行先追加在末尾，后台计算完成后再排到正确位置
+    int begin = m_proxyToSource.size();
+    beginInsertRows(QModelIndex(), begin, begin + count - 1);
+    for (int row = first; row <= last; ++row) {
+        m_proxyToSource.append(row);
+    }
+    rebuildSourceToProxy();
+    endInsertRows();
+
+    scheduleRecompute();
+}
+
+void TaskSortFilterModel::onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                                              const QVector<int> &roles)
+{
+    if (topLeft.parent().isValid()) return;
+
+    int first = topLeft.row();
+    int last = qMin(bottomRight.row(), m_keys.size() - 1);
+
+    bool keysChanged = false;
+    if (affectsKeys(topLeft.column(), bottomRight.column(), roles)) {
+        for (int source = first; source <= last; ++source) {
+            SortKey key = makeKey(source);
+            if (!(key == m_keys.at(source))) {
+                m_keys[source] = key;
+                keysChanged = true;
+            }
+        }
+    }
+
+    // 可见的代理行合并为连续区间，每段只通知一次
+    QVector<int> rows;
+    for (int source = first; source <= last; ++source) {
+        int row = m_sourceToProxy.value(source, -1);
+        if (row >= 0) {
+            rows.append(row);
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    for (int i = 0; i < rows.size();) {
+        int j = i;
+        while (j + 1 < rows.size() && rows.at(j + 1) == rows.at(j) + 1) {
+            ++j;
+        }
+        emit dataChanged(index(rows.at(i), topLeft.column()), index(rows.at(j), bottomRight.column()), roles);
+        i = j + 1;
+    }
+
+    // 键不变时行序不变；只有“已逾期”过滤依赖当天日期
+    if (keysChanged || m_criteria.status == OverdueOnly) {
+        scheduleRecompute();
+    }
+}
+
+void TaskSortFilterModel::onSourceReset()
+{
+    beginResetModel();
+    rebuildKeys();
+    m_proxyToSource.resize(m_keys.size());
+    for (int i = 0; i < m_keys.size(); ++i) {
+        m_proxyToSource[i] = i;
+    }
+    rebuildSourceToProxy();
+    endResetModel();
+    scheduleRecompute();
+}
+
+void TaskSortFilterModel::reportMemory(MemoryReport &report) const
+{
+    qint64 stringBytes = 0;
+    for (const SortKey &key : m_keys) {
+        stringBytes += MemoryStats::stringBytes(key.course) + MemoryStats::stringBytes(key.title);
+    }
+    qint64 bytes = MemoryStats::vectorBytes(m_keys) + MemoryStats::vectorBytes(m_proxyToSource)
+                   + MemoryStats::vectorBytes(m_sourceToProxy) + stringBytes;
+    report.add("任务表格项", m_keys.size(), bytes, stringBytes);
+}
@@ -0,0 +1,121 @@
+#ifndef TASKSORTFILTERMODEL_H
+#define TASKSORTFILTERMODEL_H
+
+#include <QAbstractProxyModel>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QTimer>
+#include <QVector>
+
+class MemoryReport;
+
+// 任务排序/过滤代理：在工作线程上对快照计算行序，完成后在界面线程一次性替换
+// 排序键在任务变化时预先计算，比较时不再访问 Task 对象
+class TaskSortFilterModel : public QAbstractProxyModel
+{
+    Q_OBJECT
+public:
+    enum StatusFilter {
+        AllStatus = 0,
+        OpenOnly,
+        CompletedOnly,
+        OverdueOnly
+    };
+
+    enum TypeFilter {
+        AllTypes = 0,
+        HomeworkOnly,
+        ExamOnly
+    };
+
+    explicit TaskSortFilterModel(QObject *parent = nullptr);
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex mapToSource(const QModelIndex &proxyIndex) const override;
+    QModelIndex mapFromSource(const QModelIndex &sourceIndex) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void setFilterText(const QString &text);
+    void setStatusFilter(StatusFilter filter);
+    void setTypeFilter(TypeFilter filter);
+
+    // 是否有尚未完成的后台计算
+    bool isBusy() const { return m_watcher.isRunning(); }
+
+    // 排序键与行映射的内存估算
+    void reportMemory(MemoryReport &report) const;
+
+signals:
+    void resultApplied(int visibleRows, double elapsedMs);
+
+private:
+    // 预先计算的排序/过滤键
+    struct SortKey {
+        int sourceRow = -1;
+        qint64 dueKey = 0;        // 截止时刻（儒略日×1440+分钟）
+        qint64 dueDay = 0;        // 截止日期（儒略日）
+        QString course;           // 小写课程名
+        QString title;            // 小写任务标题
+        bool completed = false;
+        bool exam = false;
+
+        bool operator==(const SortKey &other) const
+        {
+            return sourceRow == other.sourceRow && dueKey == other.dueKey && dueDay == other.dueDay
+                   && completed == other.completed && exam == other.exam
+                   && course == other.course && title == other.title;
+        }
+    };
+
+    struct Criteria {
+        QString text;
+        StatusFilter status = AllStatus;
+        TypeFilter type = AllTypes;
+        int sortColumn = -1;
+        Qt::SortOrder order = Qt::AscendingOrder;
+        qint64 today = 0;
+    };
+
+    struct Result {
+        int generation = 0;
+        QVector<int> proxyToSource;
+        double elapsedMs = 0.0;
+    };
+
+    static Result compute(QVector<SortKey> keys, Criteria criteria, int generation,
+                          QSharedPointer<QAtomicInt> latest);
+    static bool matches(const SortKey &key, const Criteria &criteria);
+    static bool affectsKeys(int firstColumn, int lastColumn, const QVector<int> &roles);
+
+    SortKey makeKey(int sourceRow) const;
+    void rebuildKeys();
+    void rebuildSourceToProxy();
+    void scheduleRecompute(int delayMs = 0);
+    void startRecompute();
+    void applyResult();
+
+    void onSourceRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onSourceRowsInserted(const QModelIndex &parent, int first, int last);
+    void onSourceDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight,
+                             const QVector<int> &roles);
+    void onSourceReset();
+
+    QVector<SortKey> m_keys;          // 与源模型行一一对应
+    QVector<int> m_proxyToSource;
+    QVector<int> m_sourceToProxy;     // 被过滤掉的行为 -1
+    Criteria m_criteria;
+    QSharedPointer<QAtomicInt> m_generation;
+    QFutureWatcher<Result> m_watcher;
+    QTimer m_debounce;
+};
+
+#endif // TASKSORTFILTERMODEL_H
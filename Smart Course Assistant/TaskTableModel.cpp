@@ -0,0 +1,139 @@
+#include "TaskTableModel.h"
+#include "IconCache.h"
+#include "TraceRecorder.h"
+
+TaskTableModel::TaskTableModel(TaskManager *taskManager, QObject *parent)
+    : QAbstractTableModel(parent),
+    m_taskManager(taskManager),
+    m_rowCount(taskManager ? taskManager->getAllTasks().size() : 0),
+    m_checkedIcon(IconCache::icon("checked")),
+    m_examIcon(IconCache::icon("exam")),
+    m_homeworkIcon(IconCache::icon("homework"))
+{
+    if (!m_taskManager) return;
+
+    connect(m_taskManager, &TaskManager::tasksInserted, this, &TaskTableModel::onTasksInserted);
+    connect(m_taskManager, &TaskManager::tasksAboutToBeRemoved,
+            this, &TaskTableModel::onTasksAboutToBeRemoved);
+    connect(m_taskManager, &TaskManager::tasksRemoved, this, &TaskTableModel::onTasksRemoved);
+    connect(m_taskManager, &TaskManager::taskUpdated, this, &TaskTableModel::onTaskUpdated);
+    connect(m_taskManager, &TaskManager::tasksReset, this, &TaskTableModel::onTasksReset);
+    connect(m_taskManager, &TaskManager::statusDateChanged,
+            this, &TaskTableModel::onStatusDateChanged);
+}
+
+int TaskTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rowCount;
+}
+
+int TaskTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+// 只在视图绘制可见行时才生成显示数据
+QVariant TaskTableModel::data(const QModelIndex &index, int role) const
+{
+    Task *task = taskAt(index.row());
+    if (!task) {
+        return QVariant();
+    }
+
+    if (role == TaskRole) {
+        return QVariant::fromValue(task);
+    }
+
+    switch (index.column()) {
+    case StatusColumn:
+        if (role == Qt::DecorationRole) {
+            if (task->isCompleted()) return m_checkedIcon;
+            if (task->isExam()) return m_examIcon;
+            return m_homeworkIcon;
+        }
+        if (role == Qt::BackgroundRole) {
+            return task->priorityColor();
+        }
+        break;
+    case CourseColumn:
+        if (role == Qt::DisplayRole) return task->courseName();
+        break;
+    case TitleColumn:
+        if (role == Qt::DisplayRole) return task->title();
+        break;
+    case DueDateColumn:
+        if (role == Qt::DisplayRole) return task->dueDate().toString("yyyy-MM-dd");
+        break;
+    case RemainingColumn:
+        if (role == Qt::DisplayRole) return task->statusText();
+        break;
+    default:
+        break;
+    }
+    return QVariant();
+}
+
+QVariant TaskTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole || orientation != Qt::Horizontal) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section) {
+    case StatusColumn: return QString("状态");
+    case CourseColumn: return QString("课程");
+    case TitleColumn: return QString("任务");
+    case DueDateColumn: return QString("截止日期");
+    case RemainingColumn: return QString("剩余时间");
+    default: return QVariant();
+    }
+}
+
+Task *TaskTableModel::taskAt(int row) const
+{
+    if (!m_taskManager || row < 0 || row >= m_rowCount) {
+        return nullptr;
+    }
+    const QList<Task*> &tasks = m_taskManager->getAllTasks();
+    return row < tasks.size() ? tasks.at(row) : nullptr;
+}
+
+void TaskTableModel::onTasksInserted(int first, int last)
+{
+    beginInsertRows(QModelIndex(), first, last);
+    m_rowCount += last - first + 1;
+    endInsertRows();
+}
+
+void TaskTableModel::onTasksAboutToBeRemoved(int first, int last)
+{
+    beginRemoveRows(QModelIndex(), first, last);
+}
+
+void TaskTableModel::onTasksRemoved(int first, int last)
+{
+    m_rowCount -= last - first + 1;
+    endRemoveRows();
+}
+
+// 只刷新发生变化的一行
+void TaskTableModel::onTaskUpdated(int index, Task *)
+{
+    emit dataChanged(this->index(index, 0), this->index(index, ColumnCount - 1));
+}
+
+void TaskTableModel::onTasksReset()
+{
+    TRACE_SCOPE_CAT("TaskTableModel::onTasksReset", "model");
+    beginResetModel();
+    m_rowCount = m_taskManager->getAllTasks().size();
+    endResetModel();
+}
+
+// 日期翻转：只通知状态相关的列与角色，视图仅重绘可见行，排序键不受影响
+void TaskTableModel::onStatusDateChanged()
+{
+    if (m_rowCount == 0) return;
+    emit dataChanged(index(0, StatusColumn), index(m_rowCount - 1, StatusColumn), {Qt::BackgroundRole});
+    emit dataChanged(index(0, RemainingColumn), index(m_rowCount - 1, RemainingColumn), {Qt::DisplayRole});
+}
@@ -0,0 +1,52 @@
+#ifndef TASKTABLEMODEL_H
+#define TASKTABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QIcon>
+#include "TaskManager.h"
+
+// 任务表格模型：直接读取 TaskManager 的任务列表，按行增量更新
+class TaskTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+public:
+    enum Column {
+        StatusColumn = 0,
+        CourseColumn,
+        TitleColumn,
+        DueDateColumn,
+        RemainingColumn,
+        ColumnCount
+    };
+
+    enum Roles {
+        TaskRole = Qt::UserRole    // 返回 Task* 指针
+    };
+
+    explicit TaskTableModel(TaskManager *taskManager, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+    Task *taskAt(int row) const;
+
+private slots:
+    void onTasksInserted(int first, int last);
+    void onTasksAboutToBeRemoved(int first, int last);
+    void onTasksRemoved(int first, int last);
+    void onTaskUpdated(int index, Task *task);
+    void onTasksReset();
+    void onStatusDateChanged();
+
+private:
+    TaskManager *m_taskManager;
+    int m_rowCount;          // 模型已公布的行数，只在 begin/end 之间改变
+    QIcon m_checkedIcon;
+    QIcon m_examIcon;
+    QIcon m_homeworkIcon;
+};
+
+#endif // TASKTABLEMODEL_H
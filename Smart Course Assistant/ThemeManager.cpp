@@ -0,0 +1,101 @@
+#include "ThemeManager.h"
+#include "TraceRecorder.h"
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QFile>
+#include <QWidget>
+#include <QDebug>
+
+namespace {
+const QString STYLE_PREFIX = ":/styles/resources/styles/";
+}
+
+ThemeManager::ThemeManager(QObject *parent)
+    : QObject(parent),
+    m_lastSwitchMs(0.0)
+{
+    m_baseSheet = readStyleFile(STYLE_PREFIX + "main_style.css");
+
+    // 监听顶层窗口的显示事件，延迟更新隐藏时错过的主题
+    qApp->installEventFilter(this);
+}
+
+ThemeManager::~ThemeManager()
+{
+    if (qApp) {
+        qApp->removeEventFilter(this);
+    }
+}
+
+// 获取合并后的样式表，首次请求时读取并缓存
+QString ThemeManager::styleSheet(const QString &theme)
+{
+    auto it = m_compiled.constFind(theme);
+    if (it != m_compiled.constEnd()) {
+        return it.value();
+    }
+
+    QString themeSheet = readStyleFile(STYLE_PREFIX + theme + "_theme.css");
+    QString merged = m_baseSheet + "\n" + themeSheet;
+    m_compiled.insert(theme, merged);
+    return merged;
+}
+
+void ThemeManager::apply(const QString &theme)
+{
+    TRACE_SCOPE_CAT("ThemeManager::apply", "ui");
+    QElapsedTimer timer;
+    timer.start();
+
+    QString sheet = styleSheet(theme);
+    m_currentTheme = theme;
+    if (sheet == m_currentSheet) {
+        return; // 样式未变化，无需重新应用
+    }
+    m_currentSheet = sheet;
+
+    // 只更新当前可见的顶层窗口
+    const QWidgetList windows = QApplication::topLevelWidgets();
+    for (QWidget *window : windows) {
+        // 有父窗口的对话框和菜单从父窗口继承样式
+        if (window->isVisible() && !window->parentWidget()) {
+            applyTo(window);
+        }
+    }
+
+    m_lastSwitchMs = timer.nsecsElapsed() / 1e6;
+    emit themeApplied(theme, m_lastSwitchMs);
+}
+
+bool ThemeManager::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Show && watched->isWidgetType()) {
+        QWidget *widget = static_cast<QWidget*>(watched);
+        if (widget->isWindow() && !widget->parentWidget()) {
+            applyTo(widget);
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+QString ThemeManager::readStyleFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "无法读取样式表:" << path;
+        return QString();
+    }
+    return QString::fromUtf8(file.readAll());
+}
+
+// 样式相同时跳过，避免重复 polish 整个窗口
+// 主题之间只有颜色不同，但 QWidget 规则覆盖所有控件，换主题时每个控件的规则都会变化，
+// 只重新 polish 部分控件省不下多少；样式表存在时调色板又会被规则覆盖，因此整窗重新应用
+void ThemeManager::applyTo(QWidget *window)
+{
+    if (m_currentSheet.isEmpty() || window->styleSheet() == m_currentSheet) {
+        return;
+    }
+    window->setStyleSheet(m_currentSheet);
+}
@@ -0,0 +1,43 @@
+#ifndef THEMEMANAGER_H
+#define THEMEMANAGER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+
+class QWidget;
+
+// 主题管理：合并基础样式与主题样式，每个主题只读取和拼接一次
+// 切换主题时只立即更新可见的顶层窗口，隐藏的窗口在下次显示时再更新
+class ThemeManager : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ThemeManager(QObject *parent = nullptr);
+    ~ThemeManager();
+
+    void apply(const QString &theme);
+    QString currentTheme() const { return m_currentTheme; }
+    QString styleSheet(const QString &theme);
+
+    // 最近一次主题切换耗时（毫秒）
+    double lastSwitchMs() const { return m_lastSwitchMs; }
+
+signals:
+    void themeApplied(const QString &theme, double elapsedMs);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    static QString readStyleFile(const QString &path);
+    void applyTo(QWidget *window);
+
+    QHash<QString, QString> m_compiled;   // 主题名 -> 合并后的样式表
+    QString m_baseSheet;
+    QString m_currentTheme;
+    QString m_currentSheet;
+    double m_lastSwitchMs;
+};
+
+#endif // THEMEMANAGER_H
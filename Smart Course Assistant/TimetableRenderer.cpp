@@ -0,0 +1,186 @@
+#include "TimetableRenderer.h"
+#include "ScheduleManager.h"
+#include <QFontMetricsF>
+#include <QPainter>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QPageLayout>
+#include <QDebug>
+
+namespace {
+const int DAYS_PER_WEEK = 7;
+const qreal TEXT_MARGIN = 4;
+const QColor GRID_COLOR(200, 200, 200);
+const QColor HEADER_COLOR(240, 240, 240);
+}
+
+TimetableRenderer::TimetableRenderer(const QSize &size, const QFont &font)
+    : m_size(size),
+    m_font(font),
+    m_rows(ScheduleManager::getSectionTimes().size())
+{
+    // 统一使用像素字号，PNG 和 PDF 的排版结果一致
+    int pixelSize = qMax(10, size.height() / 70);
+    m_font.setPixelSize(pixelSize);
+    m_headerFont = m_font;
+    m_headerFont.setBold(true);
+    m_titleFont = m_headerFont;
+    m_titleFont.setPixelSize(pixelSize * 3 / 2);
+
+    QFontMetricsF metrics(m_font);
+    QFontMetricsF headerMetrics(m_headerFont);
+    QFontMetricsF titleMetrics(m_titleFont);
+    m_lineHeight = metrics.lineSpacing();
+
+    // 表头文本与 CourseTableModel 保持一致
+    m_dayHeaders << "周一" << "周二" << "周三" << "周四" << "周五" << "周六" << "周日";
+    qreal sectionTextWidth = 0;
+    for (int i = 0; i < m_rows; ++i) {
+        int section = i + 1;
+        QString header = QString("第%1节\n%2-%3")
+                             .arg(section)
+                             .arg(ScheduleManager::getSectionStartTime(section).toString("hh:mm"))
+                             .arg(ScheduleManager::getSectionEndTime(section).toString("hh:mm"));
+        m_sectionHeaders << header;
+        for (const QString &line : header.split('\n')) {
+            sectionTextWidth = qMax(sectionTextWidth, headerMetrics.horizontalAdvance(line));
+        }
+    }
+
+    m_titleHeight = titleMetrics.lineSpacing() + 2 * TEXT_MARGIN;
+    m_headerHeight = headerMetrics.lineSpacing() + 2 * TEXT_MARGIN;
+    m_sectionWidth = sectionTextWidth + 4 * TEXT_MARGIN;
+    m_columnWidth = (size.width() - m_sectionWidth) / DAYS_PER_WEEK;
+    m_rowHeight = (size.height() - m_titleHeight - m_headerHeight) / qMax(1, m_rows);
+}
+
+QRectF TimetableRenderer::cellRect(int row, int column, int rowSpan) const
+{
+    return QRectF(m_sectionWidth + column * m_columnWidth,
+                  m_titleHeight + m_headerHeight + row * m_rowHeight,
+                  m_columnWidth,
+                  rowSpan * m_rowHeight);
+}
+
+void TimetableRenderer::paint(QPainter *painter, const QList<Course*> &courses, const QString &title) const
+{
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setRenderHint(QPainter::TextAntialiasing, true);
+    painter->fillRect(QRectF(QPointF(0, 0), QSizeF(m_size)), Qt::white);
+
+    // 标题
+    painter->setFont(m_titleFont);
+    painter->setPen(Qt::black);
+    painter->drawText(QRectF(0, 0, m_size.width(), m_titleHeight), Qt::AlignCenter, title);
+
+    // 表头
+    painter->setFont(m_headerFont);
+    QRectF dayHeader(m_sectionWidth, m_titleHeight, m_size.width() - m_sectionWidth, m_headerHeight);
+    painter->fillRect(dayHeader, HEADER_COLOR);
+    painter->fillRect(QRectF(0, m_titleHeight + m_headerHeight,
+                             m_sectionWidth, m_rows * m_rowHeight), HEADER_COLOR);
+    for (int column = 0; column < DAYS_PER_WEEK; ++column) {
+        QRectF rect(m_sectionWidth + column * m_columnWidth, m_titleHeight, m_columnWidth, m_headerHeight);
+        painter->drawText(rect, Qt::AlignCenter, m_dayHeaders.at(column));
+    }
+    for (int row = 0; row < m_rows; ++row) {
+        QRectF rect(0, m_titleHeight + m_headerHeight + row * m_rowHeight, m_sectionWidth, m_rowHeight);
+        painter->drawText(rect, Qt::AlignCenter, m_sectionHeaders.at(row));
+    }
+
+    // 网格
+    painter->setPen(GRID_COLOR);
+    qreal top = m_titleHeight;
+    qreal bottom = m_titleHeight + m_headerHeight + m_rows * m_rowHeight;
+    for (int column = 0; column <= DAYS_PER_WEEK; ++column) {
+        qreal x = m_sectionWidth + column * m_columnWidth;
+        painter->drawLine(QPointF(x, top), QPointF(x, bottom));
+    }
+    painter->drawLine(QPointF(0, top), QPointF(m_size.width(), top));
+    for (int row = 0; row <= m_rows; ++row) {
+        qreal y = m_titleHeight + m_headerHeight + row * m_rowHeight;
+        painter->drawLine(QPointF(0, y), QPointF(m_size.width(), y));
+    }
+
+    // 每个单元格里单周、双周课程的占用位，用来找出交替上课、共用时段的课程
+    QVector<int> parityMask(m_rows * DAYS_PER_WEEK, 0);
+    for (const Course *course : courses) {
+        int column = course->dayOfWeek() - 1;
+        if (course->weekParity() == Course::EveryWeek || column < 0 || column >= DAYS_PER_WEEK) continue;
+        for (int section = qMax(1, course->startSection()); section <= qMin(m_rows, course->endSection()); ++section) {
+            parityMask[(section - 1) * DAYS_PER_WEEK + column] |= 1 << course->weekParity();
+        }
+    }
+
+    // 课程块
+    painter->setFont(m_font);
+    for (const Course *course : courses) {
+        int startSection = course->startSection();
+        int endSection = course->endSection();
+        int column = course->dayOfWeek() - 1;
+        if (startSection < 1 || endSection < startSection || endSection > m_rows ||
+            column < 0 || column >= DAYS_PER_WEEK) {
+            qWarning() << "跳过无效的课程位置:" << course->name();
+            continue;
+        }
+
+        QRectF rect = cellRect(startSection - 1, column, endSection - startSection + 1);
+        // 与另一种周次的课程共用时段时，单周画在上半，双周画在下半
+        if (course->weekParity() != Course::EveryWeek) {
+            int other = 1 << (course->weekParity() == Course::OddWeeks ? Course::EvenWeeks : Course::OddWeeks);
+            for (int section = startSection; section <= endSection; ++section) {
+                if (parityMask.at((section - 1) * DAYS_PER_WEEK + column) & other) {
+                    rect.setHeight(rect.height() / 2);
+                    if (course->weekParity() == Course::EvenWeeks) {
+                        rect.translate(0, rect.height());
+                    }
+                    break;
+                }
+            }
+        }
+        painter->fillRect(rect.adjusted(1, 1, 0, 0), course->color());
+        painter->setPen(Qt::black);
+        painter->drawText(rect.adjusted(TEXT_MARGIN, TEXT_MARGIN, -TEXT_MARGIN, -TEXT_MARGIN),
+                          Qt::AlignCenter | Qt::TextWordWrap, course->displayText());
+    }
+
+    painter->restore();
+}
+
+QImage TimetableRenderer::renderImage(const QList<Course*> &courses, const QString &title) const
+{
+    QImage image(m_size, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&image);
+    paint(&painter, courses, title);
+    return image;
+}
+
+bool TimetableRenderer::renderPng(const QString &filePath, const QList<Course*> &courses,
+                                  const QString &title) const
+{
+    return renderImage(courses, title).save(filePath, "PNG");
+}
+
+bool TimetableRenderer::renderPdf(const QString &filePath, const QList<Course*> &courses,
+                                  const QString &title) const
+{
+    QPdfWriter writer(filePath);
+    writer.setPageSize(QPageSize(QPageSize::A4));
+    writer.setPageOrientation(QPageLayout::Landscape);
+    writer.setPageMargins(QMarginsF(10, 10, 10, 10), QPageLayout::Millimeter);
+    writer.setTitle(title);
+
+    QPainter painter;
+    if (!painter.begin(&writer)) {
+        qWarning() << "无法写入 PDF 文件:" << filePath;
+        return false;
+    }
+
+    // 按比例缩放到页面可绘制区域，矢量输出不损失清晰度
+    qreal scale = qMin(writer.width() / qreal(m_size.width()),
+                       writer.height() / qreal(m_size.height()));
+    painter.scale(scale, scale);
+    paint(&painter, courses, title);
+    return painter.end();
+}
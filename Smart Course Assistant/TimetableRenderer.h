@@ -0,0 +1,50 @@
+#ifndef TIMETABLERENDERER_H
+#define TIMETABLERENDERER_H
+
+#include <QFont>
+#include <QImage>
+#include <QList>
+#include <QRectF>
+#include <QSize>
+#include <QStringList>
+#include <QVector>
+#include "Course.h"
+
+class QPainter;
+
+// 课程表离屏渲染：布局与字体度量在构造时计算一次，之后只读
+// 同一个渲染器可以被多个工作线程同时用来绘制不同的课程表
+class TimetableRenderer
+{
+public:
+    explicit TimetableRenderer(const QSize &size = QSize(1600, 1130),
+                               const QFont &font = QFont());
+
+    QSize size() const { return m_size; }
+
+    // 绘制到任意绘图设备，坐标范围为 size()
+    void paint(QPainter *painter, const QList<Course*> &courses, const QString &title) const;
+
+    QImage renderImage(const QList<Course*> &courses, const QString &title) const;
+    bool renderPng(const QString &filePath, const QList<Course*> &courses, const QString &title) const;
+    bool renderPdf(const QString &filePath, const QList<Course*> &courses, const QString &title) const;
+
+private:
+    QRectF cellRect(int row, int column, int rowSpan = 1) const;
+
+    QSize m_size;
+    QFont m_font;
+    QFont m_headerFont;
+    QFont m_titleFont;
+    qreal m_titleHeight;
+    qreal m_headerHeight;
+    qreal m_sectionWidth;
+    qreal m_columnWidth;
+    qreal m_rowHeight;
+    qreal m_lineHeight;
+    int m_rows;
+    QStringList m_dayHeaders;
+    QStringList m_sectionHeaders;
+};
+
+#endif // TIMETABLERENDERER_H
@@ -0,0 +1,250 @@
+#include "TimingWheel.h"
+#include "MemoryStats.h"
+#include <utility>
+
+TimingWheel::TimingWheel(qint64 nowMinute)
+    : m_expired(nullptr),
+    m_current(nowMinute),
+    m_nextId(1)
+{
+    for (int level = 0; level < LEVELS; ++level) {
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            m_slots[level][slot] = nullptr;
+        }
+    }
+}
+
+TimingWheel::~TimingWheel()
+{
+    clear();
+}
+
+// 添加定时项
+TimingWheel::TimerId TimingWheel::schedule(qint64 dueMinute, quintptr owner, int tag)
+{
+    Entry *entry = new Entry;
+    entry->id = m_nextId++;
+    entry->owner = owner;
+    entry->tag = tag;
+    entry->due = dueMinute;
+    entry->prev = nullptr;
+    entry->next = nullptr;
+    entry->ownerPrev = nullptr;
+    entry->ownerNext = nullptr;
+
+    // 挂到 owner 链表头部
+    Entry *&head = m_ownerHeads[owner];
+    entry->ownerNext = head;
+    if (head) {
+        head->ownerPrev = entry;
+    }
+    head = entry;
+
+    m_entries.insert(entry->id, entry);
+    place(entry);
+    return entry->id;
+}
+
+// 取消单个定时项
+bool TimingWheel::cancel(TimerId id)
+{
+    Entry *entry = m_entries.take(id);
+    if (!entry) {
+        return false;
+    }
+    unlinkSlot(entry);
+    unlinkOwner(entry);
+    delete entry;
+    return true;
+}
+
+// 取消某个对象的全部定时项
+int TimingWheel::cancelOwner(quintptr owner)
+{
+    Entry *entry = m_ownerHeads.take(owner);
+    int count = 0;
+    while (entry) {
+        Entry *next = entry->ownerNext;
+        m_entries.remove(entry->id);
+        unlinkSlot(entry);
+        delete entry;
+        entry = next;
+        ++count;
+    }
+    return count;
+}
+
+void TimingWheel::clear()
+{
+    for (Entry *entry : std::as_const(m_entries)) {
+        delete entry;
+    }
+    m_entries.clear();
+    m_ownerHeads.clear();
+    for (int level = 0; level < LEVELS; ++level) {
+        for (int slot = 0; slot < SLOTS; ++slot) {
+            m_slots[level][slot] = nullptr;
+        }
+    }
+    m_expired = nullptr;
+}
+
+// 推进时间轮，收集到期的定时项
+QVector<TimingWheel::Expired> TimingWheel::advanceTo(qint64 nowMinute)
+{
+    QVector<Expired> result;
+
+    // 先处理插入时就已过期的定时项
+    while (m_expired) {
+        Entry *entry = m_expired;
+        unlinkSlot(entry);
+        result.append({entry->id, entry->owner, entry->tag, entry->due});
+        destroy(entry);
+    }
+
+    // 时间轮为空时直接跳到目标时刻
+    if (m_entries.isEmpty()) {
+        if (nowMinute > m_current) {
+            m_current = nowMinute;
+        }
+        return result;
+    }
+
+    while (m_current < nowMinute && !m_entries.isEmpty()) {
+        ++m_current;
+
+        // 低层转满一圈时，把上一层对应格子的定时项下放
+        if ((m_current & (SLOTS - 1)) == 0) {
+            int level = 1;
+            while (level < LEVELS - 1 &&
+                   ((m_current >> (SLOT_BITS * level)) & (SLOTS - 1)) == 0) {
+                ++level;
+            }
+            for (; level >= 1; --level) {
+                cascade(level);
+            }
+        }
+
+        // 下放时恰好到期的定时项会进入过期链表
+        int slot = static_cast<int>(m_current & (SLOTS - 1));
+        Entry *lists[2] = { m_expired, m_slots[0][slot] };
+        m_expired = nullptr;
+        m_slots[0][slot] = nullptr;
+        for (Entry *entry : lists) {
+            while (entry) {
+                Entry *next = entry->next;
+                result.append({entry->id, entry->owner, entry->tag, entry->due});
+                entry->prev = entry->next = nullptr;
+                entry->level = -2; // 已脱离格子
+                destroy(entry);
+                entry = next;
+            }
+        }
+    }
+
+    if (m_current < nowMinute) {
+        m_current = nowMinute;
+    }
+    return result;
+}
+
+qint64 TimingWheel::memoryBytes() const
+{
+    return qint64(sizeof(TimingWheel))
+           + qint64(m_entries.size()) * qint64(sizeof(Entry))
+           + MemoryStats::nodeBytes(m_entries, sizeof(TimerId) + sizeof(Entry*))
+           + MemoryStats::nodeBytes(m_ownerHeads, sizeof(quintptr) + sizeof(Entry*));
+}
+
+// 根据到期时间选择层级和格子
+void TimingWheel::place(Entry *entry)
+{
+    qint64 delta = entry->due - m_current;
+    Entry **head = nullptr;
+
+    if (delta <= 0) {
+        entry->level = -1;
+        entry->slot = 0;
+        head = &m_expired;
+    } else {
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (qint64(1) << (SLOT_BITS * (level + 1)))) {
+            ++level;
+        }
+        // 超出最大范围的定时项先放在最高层末端，之后再逐级下放
+        qint64 due = entry->due;
+        qint64 maxDelta = (qint64(1) << (SLOT_BITS * LEVELS)) - 1;
+        if (delta > maxDelta) {
+            due = m_current + maxDelta;
+        }
+        entry->level = level;
+        entry->slot = static_cast<int>((due >> (SLOT_BITS * level)) & (SLOTS - 1));
+        head = &m_slots[level][entry->slot];
+    }
+
+    entry->prev = nullptr;
+    entry->next = *head;
+    if (*head) {
+        (*head)->prev = entry;
+    }
+    *head = entry;
+}
+
+void TimingWheel::unlinkSlot(Entry *entry)
+{
+    if (entry->level == -2) {
+        return;
+    }
+    Entry **head = entry->level < 0 ? &m_expired : &m_slots[entry->level][entry->slot];
+    if (entry->prev) {
+        entry->prev->next = entry->next;
+    } else {
+        *head = entry->next;
+    }
+    if (entry->next) {
+        entry->next->prev = entry->prev;
+    }
+    entry->prev = entry->next = nullptr;
+    entry->level = -2;
+}
+
+void TimingWheel::unlinkOwner(Entry *entry)
+{
+    if (entry->ownerPrev) {
+        entry->ownerPrev->ownerNext = entry->ownerNext;
+    } else {
+        auto it = m_ownerHeads.find(entry->owner);
+        if (it != m_ownerHeads.end()) {
+            if (entry->ownerNext) {
+                it.value() = entry->ownerNext;
+            } else {
+                m_ownerHeads.erase(it);
+            }
+        }
+    }
+    if (entry->ownerNext) {
+        entry->ownerNext->ownerPrev = entry->ownerPrev;
+    }
+    entry->ownerPrev = entry->ownerNext = nullptr;
+}
+
+// 将某一层当前格子的定时项重新放置到更低层
+void TimingWheel::cascade(int level)
+{
+    int slot = static_cast<int>((m_current >> (SLOT_BITS * level)) & (SLOTS - 1));
+    Entry *entry = m_slots[level][slot];
+    m_slots[level][slot] = nullptr;
+    while (entry) {
+        Entry *next = entry->next;
+        place(entry);
+        entry = next;
+    }
+}
+
+// 释放已触发的定时项
+void TimingWheel::destroy(Entry *entry)
+{
+    m_entries.remove(entry->id);
+    unlinkOwner(entry);
+    delete entry;
+}
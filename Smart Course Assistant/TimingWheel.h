@@ -0,0 +1,76 @@
+#ifndef TIMINGWHEEL_H
+#define TIMINGWHEEL_H
+
+#include <QtGlobal>
+#include <QHash>
+#include <QVector>
+
+// 分层时间轮：以分钟为刻度，插入/取消/触发均为 O(1)
+// 第0层64格×1分钟，第1层64格×64分钟，依此类推，共4层（约31年）
+class TimingWheel
+{
+public:
+    using TimerId = quint64;
+
+    struct Expired {
+        TimerId id;
+        quintptr owner;    // 所属对象（如 Task 指针）
+        int tag;           // 附加信息（如提前量分钟数）
+        qint64 dueMinute;  // 计划触发时刻（自纪元起的分钟数）
+    };
+
+    explicit TimingWheel(qint64 nowMinute = 0);
+    ~TimingWheel();
+
+    TimingWheel(const TimingWheel &) = delete;
+    TimingWheel &operator=(const TimingWheel &) = delete;
+
+    // 在 dueMinute 时刻触发；已过期的时刻在下一次推进时立即触发
+    TimerId schedule(qint64 dueMinute, quintptr owner, int tag = 0);
+    bool cancel(TimerId id);
+    // 取消某个对象的全部定时项，返回取消数量
+    int cancelOwner(quintptr owner);
+    void clear();
+
+    // 推进到 nowMinute，返回期间到期的全部定时项（按到期时间先后）
+    QVector<Expired> advanceTo(qint64 nowMinute);
+
+    qint64 currentMinute() const { return m_current; }
+    int size() const { return m_entries.size(); }
+    bool isEmpty() const { return m_entries.isEmpty(); }
+    // 定时项、索引哈希表和格子数组的估算字节数
+    qint64 memoryBytes() const;
+
+private:
+    static const int SLOT_BITS = 6;
+    static const int SLOTS = 1 << SLOT_BITS;
+    static const int LEVELS = 4;
+
+    struct Entry {
+        TimerId id;
+        quintptr owner;
+        int tag;
+        qint64 due;
+        Entry *prev;
+        Entry *next;
+        Entry *ownerPrev;
+        Entry *ownerNext;
+        int level;
+        int slot;
+    };
+
+    void place(Entry *entry);
+    void unlinkSlot(Entry *entry);
+    void unlinkOwner(Entry *entry);
+    void cascade(int level);
+    void destroy(Entry *entry);
+
+    Entry *m_slots[LEVELS][SLOTS];
+    Entry *m_expired;                       // 插入时已过期、等待下次推进的定时项
+    QHash<TimerId, Entry*> m_entries;       // id -> 定时项，用于 O(1) 取消
+    QHash<quintptr, Entry*> m_ownerHeads;   // owner -> 定时项链表头
+    qint64 m_current;
+    TimerId m_nextId;
+};
+
+#endif // TIMINGWHEEL_H
@@ -0,0 +1,204 @@
+#include "TraceRecorder.h"
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QDebug>
+
+namespace {
+
+const int BUFFER_CAPACITY = 1 << 14;   // 每个线程保留最近的 16384 个事件
+
+// 每个槽位带序号：seq 为事件序号+1 表示写入完成，写入期间为 0
+// 导出线程读完字段后再核对一次 seq，不一致说明被覆盖，丢弃该事件
+struct TraceSlot {
+    std::atomic<quint64> seq{0};
+    std::atomic<const char *> name{nullptr};
+    std::atomic<const char *> category{nullptr};
+    std::atomic<qint64> startNs{0};
+    std::atomic<qint64> durationNs{0};
+};
+
+// 单写者环形缓冲区：只有所属线程写入
+// 线程结束后缓冲区归还到池中，事件仍可导出，直到被新线程接手
+struct ThreadBuffer {
+    TraceSlot events[BUFFER_CAPACITY];
+    std::atomic<quint64> head{0};
+    quint64 firstEvent = 0;     // 当前线程接手时的 head，更早的事件属于上一个线程
+    bool inUse = false;         // 以下字段由 registryMutex 保护
+    int tid = 0;
+    QString threadName;
+};
+
+QElapsedTimer &traceClock()
+{
+    static QElapsedTimer timer = [] {
+        QElapsedTimer t;
+        t.start();
+        return t;
+    }();
+    return timer;
+}
+
+// 缓冲区只在线程第一次记录时注册，之后写入不再经过这把锁
+QMutex &registryMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+// 缓冲区数量不超过同时记录过的线程数，线程退出后由下一个线程复用
+QVector<ThreadBuffer*> &registry()
+{
+    static QVector<ThreadBuffer*> buffers;
+    return buffers;
+}
+
+int nextTid = 0;
+
+ThreadBuffer *acquireBuffer()
+{
+    QThread *thread = QThread::currentThread();
+    QString threadName = thread ? thread->objectName() : QString();
+
+    QMutexLocker locker(&registryMutex());
+    ThreadBuffer *buffer = nullptr;
+    for (ThreadBuffer *candidate : std::as_const(registry())) {
+        if (!candidate->inUse) {
+            buffer = candidate;
+            break;
+        }
+    }
+    if (!buffer) {
+        buffer = new ThreadBuffer;
+        registry().append(buffer);
+    }
+    buffer->inUse = true;
+    buffer->firstEvent = buffer->head.load(std::memory_order_relaxed);
+    buffer->tid = ++nextTid;
+    buffer->threadName = !threadName.isEmpty()
+                             ? threadName
+                             : thread && qApp && thread == qApp->thread()
+                                   ? QString("main")
+                                   : QString("worker-%1").arg(buffer->tid);
+    return buffer;
+}
+
+// 线程结束时把缓冲区归还到池中
+struct BufferHandle {
+    ThreadBuffer *buffer = nullptr;
+    ~BufferHandle()
+    {
+        if (buffer) {
+            QMutexLocker locker(&registryMutex());
+            buffer->inUse = false;
+        }
+    }
+};
+
+ThreadBuffer *threadBuffer()
+{
+    thread_local BufferHandle handle;
+    if (!handle.buffer) {
+        handle.buffer = acquireBuffer();
+    }
+    return handle.buffer;
+}
+
+// clear() 之前的事件在导出时跳过，避免与写入线程争用 head
+std::atomic<qint64> clearedBeforeNs{-1};
+
+} // namespace
+
+std::atomic<bool> TraceRecorder::s_enabled{false};
+
+void TraceRecorder::setEnabled(bool enabled)
+{
+    traceClock();
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+qint64 TraceRecorder::nowNs()
+{
+    return traceClock().nsecsElapsed();
+}
+
+void TraceRecorder::record(const char *name, const char *category, qint64 startNs, qint64 durationNs)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    quint64 head = buffer->head.load(std::memory_order_relaxed);
+    TraceSlot &slot = buffer->events[head % BUFFER_CAPACITY];
+    slot.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.category.store(category, std::memory_order_relaxed);
+    slot.startNs.store(startNs, std::memory_order_relaxed);
+    slot.durationNs.store(durationNs, std::memory_order_relaxed);
+    slot.seq.store(head + 1, std::memory_order_release);
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+int TraceRecorder::dump(const QString &filePath)
+{
+    QJsonArray events;
+    qint64 clearedBefore = clearedBeforeNs.load(std::memory_order_relaxed);
+    {
+        QMutexLocker locker(&registryMutex());
+        for (ThreadBuffer *buffer : std::as_const(registry())) {
+            QJsonObject meta;
+            meta["name"] = "thread_name";
+            meta["ph"] = "M";
+            meta["pid"] = 1;
+            meta["tid"] = buffer->tid;
+            meta["args"] = QJsonObject{{"name", buffer->threadName}};
+            events.append(meta);
+
+            // 写入线程可能正在覆盖最旧的槽位：读前读后序号一致才采用
+            quint64 head = buffer->head.load(std::memory_order_acquire);
+            quint64 first = qMax(buffer->firstEvent, head - qMin<quint64>(head, BUFFER_CAPACITY));
+            for (quint64 i = first; i < head; ++i) {
+                const TraceSlot &slot = buffer->events[i % BUFFER_CAPACITY];
+                if (slot.seq.load(std::memory_order_acquire) != i + 1) continue;
+                const char *name = slot.name.load(std::memory_order_relaxed);
+                const char *category = slot.category.load(std::memory_order_relaxed);
+                qint64 startNs = slot.startNs.load(std::memory_order_relaxed);
+                qint64 durationNs = slot.durationNs.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq.load(std::memory_order_relaxed) != i + 1) continue;
+
+                if (startNs < clearedBefore) continue;
+                QJsonObject obj;
+                obj["name"] = QString::fromUtf8(name);
+                obj["cat"] = QString::fromUtf8(category);
+                obj["ph"] = "X";
+                obj["pid"] = 1;
+                obj["tid"] = buffer->tid;
+                obj["ts"] = startNs / 1000.0;     // 微秒
+                obj["dur"] = durationNs / 1000.0;
+                events.append(obj);
+            }
+        }
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "无法写入跟踪文件:" << filePath;
+        return -1;
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = events;
+    root["displayTimeUnit"] = "ms";
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    return events.size();
+}
+
+void TraceRecorder::clear()
+{
+    clearedBeforeNs.store(nowNs(), std::memory_order_relaxed);
+}
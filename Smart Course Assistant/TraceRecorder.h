@@ -0,0 +1,62 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+// 轻量级跟踪记录：每个线程一个环形缓冲区，写入时不加锁，可在记录的同时导出
+// 线程结束后缓冲区留在池中供后来的线程复用，缓冲区总数不超过同时记录的线程数
+// 导出为 Chrome trace JSON，可直接在 Perfetto 或 chrome://tracing 中打开
+// 关闭时 TRACE_SCOPE 只有一次原子读取的开销
+class TraceRecorder
+{
+public:
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    // 记录一个已完成的区间；name 和 category 必须是静态字符串
+    static void record(const char *name, const char *category, qint64 startNs, qint64 durationNs);
+    static qint64 nowNs();
+
+    // 导出当前所有线程缓冲区中的事件，返回写入的事件数，失败返回 -1
+    static int dump(const QString &filePath);
+    static void clear();
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+// 作用域跟踪：构造时记下开始时间，析构时记录整个区间
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name, const char *category = "app")
+        : m_name(name),
+        m_category(category),
+        m_start(TraceRecorder::isEnabled() ? TraceRecorder::nowNs() : -1)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (m_start >= 0) {
+            TraceRecorder::record(m_name, m_category, m_start, TraceRecorder::nowNs() - m_start);
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    qint64 m_start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_SCOPE_CAT(name, category) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name, category)
+
+#endif // TRACERECORDER_H
@@ -0,0 +1,182 @@
+#include "UndoCommands.h"
+
+AddCourseCommand::AddCourseCommand(ScheduleManager *manager, const Course &course, QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_manager(manager),
+    m_record(std::make_shared<const CourseRecord>(CourseRecord::fromCourse(course))),
+    m_index(manager->getAllCourses().size())
+{
+    setText(QString("添加课程“%1”").arg(course.name()));
+}
+
+void AddCourseCommand::redo()
+{
+    m_manager->insertCourse(m_index, m_record);
+}
+
+void AddCourseCommand::undo()
+{
+    m_manager->removeCourse(m_index);
+}
+
+EditCourseCommand::EditCourseCommand(ScheduleManager *manager, int index, const Course &newCourse,
+                                     QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_manager(manager),
+    m_index(index),
+    m_before(manager->snapshots().at(index)),
+    m_after(std::make_shared<const CourseRecord>(CourseRecord::fromCourse(newCourse)))
+{
+    setText(QString("编辑课程“%1”").arg(newCourse.name()));
+}
+
+void EditCourseCommand::redo()
+{
+    apply(m_after);
+}
+
+void EditCourseCommand::undo()
+{
+    apply(m_before);
+}
+
+void EditCourseCommand::apply(const std::shared_ptr<const CourseRecord> &record)
+{
+    if (!record) return;
+    Course course;
+    record->applyTo(course);
+    m_manager->editCourse(m_index, course);
+}
+
+RemoveCourseCommand::RemoveCourseCommand(ScheduleManager *manager, int index, QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_manager(manager),
+    m_index(index),
+    m_record(manager->snapshots().at(index))
+{
+    setText(QString("删除课程“%1”").arg(m_record ? m_record->name : QString()));
+}
+
+void RemoveCourseCommand::redo()
+{
+    m_manager->removeCourse(m_index);
+}
+
+void RemoveCourseCommand::undo()
+{
+    m_manager->insertCourse(m_index, m_record);
+}
+
+AddTaskCommand::AddTaskCommand(TaskManager *manager, Task *task, QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_manager(manager),
+    m_pending(task),
+    m_record(std::make_shared<const TaskRecord>(TaskRecord::fromTask(*task))),
+    m_index(manager->getAllTasks().size())
+{
+    setText(QString("添加任务“%1”").arg(task->title()));
+}
+
+AddTaskCommand::~AddTaskCommand()
+{
+    delete m_pending;
+}
+
+void AddTaskCommand::redo()
+{
+    Task *task = m_pending ? m_pending : m_record->createTask(m_manager);
+    m_pending = nullptr;
+    m_manager->insertTask(m_index, task);
+}
+
+void AddTaskCommand::undo()
+{
+    m_manager->removeTasks(m_index, 1);
+}
+
+RemoveTaskCommand::RemoveTaskCommand(TaskManager *manager, int index, QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_manager(manager),
+    m_index(index),
+    m_record(manager->snapshots().at(index))
+{
+    setText(QString("删除任务“%1”").arg(m_record ? m_record->title : QString()));
+}
+
+void RemoveTaskCommand::redo()
+{
+    m_manager->removeTasks(m_index, 1);
+}
+
+void RemoveTaskCommand::undo()
+{
+    if (m_record) {
+        m_manager->insertTask(m_index, m_record->createTask(m_manager));
+    }
+}
+
+CompleteTaskCommand::CompleteTaskCommand(TaskManager *manager, int index, bool completed,
+                                         QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_manager(manager),
+    m_index(index),
+    m_completed(completed)
+{
+    setText(completed ? "标记任务完成" : "取消任务完成");
+}
+
+void CompleteTaskCommand::redo()
+{
+    m_manager->setTaskCompleted(m_manager->getAllTasks().value(m_index), m_completed);
+}
+
+void CompleteTaskCommand::undo()
+{
+    m_manager->setTaskCompleted(m_manager->getAllTasks().value(m_index), !m_completed);
+}
+
+ImportCommand::ImportCommand(ScheduleManager *scheduleManager, TaskManager *taskManager,
+                             const ScheduleSnapshot &courses, const TaskSnapshot &tasks,
+                             QUndoCommand *parent)
+    : QUndoCommand(parent),
+    m_scheduleManager(scheduleManager),
+    m_taskManager(taskManager),
+    m_courses(courses.items.toVector()),
+    m_tasks(tasks.items.toVector()),
+    m_firstCourse(scheduleManager->getAllCourses().size()),
+    m_firstTask(taskManager->getAllTasks().size())
+{
+    setText(QString("导入 %1 门课程、%2 项任务").arg(m_courses.size()).arg(m_tasks.size()));
+}
+
+void ImportCommand::redo()
+{
+    m_addedCourses = 0;
+    m_addedTasks = 0;
+    m_firstCourse = m_scheduleManager->getAllCourses().size();
+    m_firstTask = m_taskManager->getAllTasks().size();
+    if (!m_scheduleManager->addCourses(m_courses)) {
+        return;
+    }
+    m_addedCourses = m_scheduleManager->getAllCourses().size() - m_firstCourse;
+
+    QList<Task*> tasks;
+    tasks.reserve(m_tasks.size());
+    for (const auto &record : std::as_const(m_tasks)) {
+        tasks.append(record->createTask(m_taskManager));
+    }
+    m_taskManager->addTasks(tasks);
+    m_addedTasks = m_taskManager->getAllTasks().size() - m_firstTask;
+}
+
+void ImportCommand::undo()
+{
+    if (m_addedTasks > 0) {
+        m_taskManager->removeTasks(m_firstTask, m_addedTasks);
+    }
+    if (m_addedCourses > 0) {
+        m_scheduleManager->removeCourses(m_firstCourse, m_addedCourses);
+    }
+    m_addedCourses = 0;
+    m_addedTasks = 0;
+}
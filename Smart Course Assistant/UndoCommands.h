@@ -0,0 +1,118 @@
+#ifndef UNDOCOMMANDS_H
+#define UNDOCOMMANDS_H
+
+#include <QUndoCommand>
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+
+// 撤销命令只保存发生变化的记录，记录与快照共用数据，
+// 因此撤销历史的内存开销与修改次数成正比，而不是与数据总量成正比
+
+class AddCourseCommand : public QUndoCommand
+{
+public:
+    AddCourseCommand(ScheduleManager *manager, const Course &course, QUndoCommand *parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    ScheduleManager *m_manager;
+    std::shared_ptr<const CourseRecord> m_record;
+    int m_index;
+};
+
+class EditCourseCommand : public QUndoCommand
+{
+public:
+    EditCourseCommand(ScheduleManager *manager, int index, const Course &newCourse,
+                      QUndoCommand *parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    void apply(const std::shared_ptr<const CourseRecord> &record);
+
+    ScheduleManager *m_manager;
+    int m_index;
+    std::shared_ptr<const CourseRecord> m_before;
+    std::shared_ptr<const CourseRecord> m_after;
+};
+
+class RemoveCourseCommand : public QUndoCommand
+{
+public:
+    RemoveCourseCommand(ScheduleManager *manager, int index, QUndoCommand *parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    ScheduleManager *m_manager;
+    int m_index;
+    std::shared_ptr<const CourseRecord> m_record;
+};
+
+class AddTaskCommand : public QUndoCommand
+{
+public:
+    // 首次执行时接管 task，之后的重做根据记录重新创建
+    AddTaskCommand(TaskManager *manager, Task *task, QUndoCommand *parent = nullptr);
+    ~AddTaskCommand() override;
+    void redo() override;
+    void undo() override;
+
+private:
+    TaskManager *m_manager;
+    Task *m_pending;
+    std::shared_ptr<const TaskRecord> m_record;
+    int m_index;
+};
+
+class RemoveTaskCommand : public QUndoCommand
+{
+public:
+    RemoveTaskCommand(TaskManager *manager, int index, QUndoCommand *parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    TaskManager *m_manager;
+    int m_index;
+    std::shared_ptr<const TaskRecord> m_record;
+};
+
+class CompleteTaskCommand : public QUndoCommand
+{
+public:
+    CompleteTaskCommand(TaskManager *manager, int index, bool completed, QUndoCommand *parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    TaskManager *m_manager;
+    int m_index;
+    bool m_completed;
+};
+
+// 批量导入：撤销和重做都是一次批量操作
+// 调用方应先用 ScheduleManager::canAddCourses 确认课程不冲突
+class ImportCommand : public QUndoCommand
+{
+public:
+    ImportCommand(ScheduleManager *scheduleManager, TaskManager *taskManager,
+                  const ScheduleSnapshot &courses, const TaskSnapshot &tasks,
+                  QUndoCommand *parent = nullptr);
+    void redo() override;
+    void undo() override;
+
+private:
+    ScheduleManager *m_scheduleManager;
+    TaskManager *m_taskManager;
+    QVector<std::shared_ptr<const CourseRecord>> m_courses;
+    QVector<std::shared_ptr<const TaskRecord>> m_tasks;
+    int m_firstCourse;
+    int m_firstTask;
+    int m_addedCourses = 0;    // 上次 redo 实际加入的行数，undo 只撤回这些
+    int m_addedTasks = 0;
+};
+
+#endif // UNDOCOMMANDS_H
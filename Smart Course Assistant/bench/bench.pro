@@ -0,0 +1,40 @@
+# 性能基准：课程/任务核心路径、数据文件读写、表格模型刷新、图标查找与主题切换
+# 运行：./SmartScheduleAssistant-bench            全部基准
+#       ./SmartScheduleAssistant-bench loadTasks  单个基准
+#       cliColdStart 需要先在 ../cli 中构建命令行工具，找不到时该项跳过，门禁判为无结果
+#       ./SmartScheduleAssistant-bench --gate baselines.json --record  在参考机器上记录基线；基线为 null 时门禁失败
+#       qmake CONFIG+=perf_gate 后 make check     性能门禁：与 baselines.json 比较，超出容差时失败；记录基线后再开启
+TARGET = SmartScheduleAssistant-bench
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT += core gui widgets testlib
+
+include(../SmartScheduleCore.pri)
+include(../SmartScheduleServer.pri)
+
+SOURCES += \
+    bench_core.cpp \
+    perf_gate.cpp \
+    ../CourseTableModel.cpp \
+    ../TaskTableModel.cpp \
+    ../IconCache.cpp \
+    ../ThemeManager.cpp
+
+HEADERS += \
+    perf_gate.h \
+    ../CourseTableModel.h \
+    ../TaskTableModel.h \
+    ../IconCache.h \
+    ../ThemeManager.h
+
+RESOURCES += ../resources.qrc
+
+# 性能门禁挂在 make check 上，与单元测试的运行方式一致；基线未记录前默认不挂
+perf_gate {
+    check.commands = $$shell_quote($$shell_path($$OUT_PWD/$$TARGET)) --gate $$shell_quote($$shell_path($$PWD/baselines.json))
+    check.depends = first
+    QMAKE_EXTRA_TARGETS += check
+}
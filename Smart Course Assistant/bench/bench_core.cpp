@@ -0,0 +1,535 @@
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+#include "CourseTableModel.h"
+#include "TaskTableModel.h"
+#include "IconCache.h"
+#include "ThemeManager.h"
+#include "ScheduleApiHandler.h"
+#include "perf_gate.h"
+#include <QApplication>
+#include <QComboBox>
+#include <QDir>
+#include <QGridLayout>
+#include <QLabel>
+#include <QLineEdit>
+#include <QProcess>
+#include <QPushButton>
+#include <QRandomGenerator>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+// 基准测试：每项按数据规模参数化，便于观察随规模增长的曲线
+// 数据由固定种子生成，多次运行之间可直接比较
+class BenchCore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void addCourseConflictCheck_data();
+    void addCourseConflictCheck();
+    void getCoursesByDay_data();
+    void getCoursesByDay();
+    void currentAndNextCourse_data();
+    void currentAndNextCourse();
+
+    void saveCourses_data();
+    void saveCourses();
+    void loadCourses_data();
+    void loadCourses();
+    void saveTasks_data();
+    void saveTasks();
+    void loadTasks_data();
+    void loadTasks();
+
+    void courseTableRefresh_data();
+    void courseTableRefresh();
+    void taskTableRefresh_data();
+    void taskTableRefresh();
+    void iconLookup_data();
+    void iconLookup();
+    void themeSwitch_data();
+    void themeSwitch();
+
+    void snapshotPublish_data();
+    void snapshotPublish();
+
+    void apiQuery_data();
+    void apiQuery();
+    void apiNotModified_data();
+    void apiNotModified();
+
+    void cliColdStart_data();
+    void cliColdStart();
+
+private:
+    void courseSizes();
+    void taskSizes();
+    QString writeCourseFile(int count);
+    QString writeTaskFile(int count);
+    static QString cliProgram();
+
+    QTemporaryDir m_dir;
+};
+
+namespace {
+const quint32 SEED = 20250301;
+
+// 冲突检测基准的探测位置：生成的课程从不占用这一节，检测必须比较完全部课程
+const int FREE_DAY = 7;
+const int FREE_SECTION = Course::MAX_SECTION;
+
+// 随机课程：节次可能互相重叠，用于放大冲突检测和排版的开销；周日最后一节始终空出
+QVector<std::shared_ptr<const CourseRecord>> makeCourses(int count)
+{
+    QRandomGenerator rng(SEED);
+    QVector<std::shared_ptr<const CourseRecord>> courses;
+    courses.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        CourseRecord record;
+        record.name = QString("课程%1").arg(i);
+        record.dayOfWeek = rng.bounded(1, 8);
+        const int lastSection = record.dayOfWeek == FREE_DAY ? FREE_SECTION - 1 : Course::MAX_SECTION;
+        record.startSection = rng.bounded(1, lastSection);
+        record.endSection = qMin(lastSection, record.startSection + rng.bounded(0, 3));
+        record.classroom = QString("教%1-%2").arg(rng.bounded(1, 10)).arg(rng.bounded(100, 500));
+        record.teacher = QString("教师%1").arg(rng.bounded(200));
+        record.color = QColor::fromHsv(rng.bounded(360), 150, 230);
+        courses.append(std::make_shared<const CourseRecord>(record));
+    }
+    return courses;
+}
+
+QVector<std::shared_ptr<const TaskRecord>> makeTasks(int count)
+{
+    QRandomGenerator rng(SEED + 1);
+    // 固定日期而不是当天，保证每次生成的数据完全相同
+    const QDate today(2025, 3, 3);
+    QVector<std::shared_ptr<const TaskRecord>> tasks;
+    tasks.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        TaskRecord record;
+        record.title = QString("任务%1").arg(i);
+        record.courseName = QString("课程%1").arg(rng.bounded(50));
+        record.dueDate = today.addDays(rng.bounded(-60, 120));
+        record.dueTime = QTime(rng.bounded(8, 23), 0);
+        record.description = "benchmark";
+        record.completed = rng.bounded(100) < 60;
+        record.exam = rng.bounded(100) < 10;
+        tasks.append(std::make_shared<const TaskRecord>(record));
+    }
+    return tasks;
+}
+}
+
+void BenchCore::initTestCase()
+{
+    // 避免读写用户的真实数据
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_dir.isValid());
+}
+
+void BenchCore::courseSizes()
+{
+    QTest::addColumn<int>("count");
+    for (int count : {10, 100, 1000, 10000}) {
+        QTest::newRow(QByteArray::number(count).constData()) << count;
+    }
+}
+
+void BenchCore::taskSizes()
+{
+    QTest::addColumn<int>("count");
+    for (int count : {100, 1000, 10000, 100000}) {
+        QTest::newRow(QByteArray::number(count).constData()) << count;
+    }
+}
+
+QString BenchCore::writeCourseFile(int count)
+{
+    QString path = m_dir.filePath(QString("schedule-%1.dat").arg(count));
+    if (!QFile::exists(path)) {
+        ScheduleSnapshot snapshot;
+        snapshot.items = makeCourses(count);
+        ScheduleManager::writeCourses(path, snapshot);
+    }
+    return path;
+}
+
+QString BenchCore::writeTaskFile(int count)
+{
+    QString path = m_dir.filePath(QString("tasks-%1.dat").arg(count));
+    if (!QFile::exists(path)) {
+        TaskSnapshot snapshot;
+        snapshot.items = makeTasks(count);
+        TaskManager::writeTasks(path, snapshot);
+    }
+    return path;
+}
+
+void BenchCore::addCourseConflictCheck_data() { courseSizes(); }
+
+// addCourse 的主要开销是与全部现有课程逐一比较
+void BenchCore::addCourseConflictCheck()
+{
+    QFETCH(int, count);
+    ScheduleManager manager(ScheduleManager::DeferLoad);
+    manager.setAutoSave(false);
+    QVERIFY(manager.loadCourses(writeCourseFile(count)));
+
+    // 放在生成数据空出的一节，不会提前命中冲突，确保遍历完整个列表
+    Course course("新课程", FREE_DAY, FREE_SECTION, FREE_SECTION, "");
+    bool conflict = false;
+    QBENCHMARK {
+        conflict = manager.hasConflict(course);
+    }
+    QVERIFY(!conflict);
+}
+
+void BenchCore::getCoursesByDay_data() { courseSizes(); }
+
+void BenchCore::getCoursesByDay()
+{
+    QFETCH(int, count);
+    ScheduleManager manager(ScheduleManager::DeferLoad);
+    manager.setAutoSave(false);
+    QVERIFY(manager.loadCourses(writeCourseFile(count)));
+
+    int total = 0;
+    QBENCHMARK {
+        for (int day = 1; day <= 7; ++day) {
+            total += manager.getCoursesByDay(day).size();
+        }
+    }
+    QVERIFY(total > 0);
+}
+
+void BenchCore::currentAndNextCourse_data() { courseSizes(); }
+
+void BenchCore::currentAndNextCourse()
+{
+    QFETCH(int, count);
+    ScheduleManager manager(ScheduleManager::DeferLoad);
+    manager.setAutoSave(false);
+    QVERIFY(manager.loadCourses(writeCourseFile(count)));
+
+    // 固定时刻，结果与运行时间无关
+    QDateTime now(QDate(2025, 3, 5), QTime(9, 30));
+    QBENCHMARK {
+        ScheduleManager::currentCourseAt(manager.getAllCourses(), now);
+        ScheduleManager::nextCourseAt(manager.getAllCourses(), now);
+    }
+}
+
+void BenchCore::saveCourses_data() { courseSizes(); }
+
+void BenchCore::saveCourses()
+{
+    QFETCH(int, count);
+    ScheduleManager manager(ScheduleManager::DeferLoad);
+    manager.setAutoSave(false);
+    QVERIFY(manager.loadCourses(writeCourseFile(count)));
+
+    QString path = m_dir.filePath("schedule-save.dat");
+    QBENCHMARK {
+        manager.saveCourses(path);
+    }
+}
+
+void BenchCore::loadCourses_data() { courseSizes(); }
+
+void BenchCore::loadCourses()
+{
+    QFETCH(int, count);
+    QString path = writeCourseFile(count);
+    ScheduleManager manager(ScheduleManager::DeferLoad);
+    manager.setAutoSave(false);
+
+    QBENCHMARK {
+        manager.loadCourses(path);
+    }
+    QCOMPARE(manager.getAllCourses().size(), count);
+}
+
+void BenchCore::saveTasks_data() { taskSizes(); }
+
+void BenchCore::saveTasks()
+{
+    QFETCH(int, count);
+    TaskManager manager;
+    QVERIFY(manager.loadTasks(writeTaskFile(count)));
+
+    QString path = m_dir.filePath("tasks-save.dat");
+    QBENCHMARK {
+        manager.saveTasks(path);
+    }
+}
+
+void BenchCore::loadTasks_data() { taskSizes(); }
+
+void BenchCore::loadTasks()
+{
+    QFETCH(int, count);
+    QString path = writeTaskFile(count);
+    TaskManager manager;
+
+    QBENCHMARK {
+        manager.loadTasks(path);
+    }
+    QCOMPARE(manager.getAllTasks().size(), count);
+}
+
+void BenchCore::courseTableRefresh_data() { courseSizes(); }
+
+// 对应原来的 updateCourseTable：重建单元格索引并取出全部单元格的显示数据
+void BenchCore::courseTableRefresh()
+{
+    QFETCH(int, count);
+    ScheduleManager manager(ScheduleManager::DeferLoad);
+    manager.setAutoSave(false);
+    QVERIFY(manager.loadCourses(writeCourseFile(count)));
+    CourseTableModel model(&manager);
+
+    QBENCHMARK {
+        model.reload();
+        for (int row = 0; row < model.rowCount(); ++row) {
+            for (int column = 0; column < model.columnCount(); ++column) {
+                model.data(model.index(row, column), Qt::DisplayRole);
+            }
+        }
+    }
+}
+
+void BenchCore::taskTableRefresh_data() { taskSizes(); }
+
+// 对应原来的 updateTaskList：模型重置后视图只取可见的前 50 行
+void BenchCore::taskTableRefresh()
+{
+    QFETCH(int, count);
+    TaskManager manager;
+    QVERIFY(manager.loadTasks(writeTaskFile(count)));
+    TaskTableModel model(&manager);
+
+    const int visibleRows = qMin(50, count);
+    QBENCHMARK {
+        emit manager.tasksReset();
+        for (int row = 0; row < visibleRows; ++row) {
+            for (int column = 0; column < model.columnCount(); ++column) {
+                model.data(model.index(row, column), Qt::DisplayRole);
+                model.data(model.index(row, column), Qt::DecorationRole);
+            }
+        }
+    }
+}
+
+void BenchCore::iconLookup_data()
+{
+    QTest::addColumn<int>("rows");
+    for (int rows : {50, 500}) {
+        QTest::newRow(QByteArray::number(rows).constData()) << rows;
+    }
+}
+
+// 任务列表一次刷新中的图标开销：每个可见行取一次图标并按表格尺寸取位图
+// 图标只在首次使用时解码，之后的刷新只查表，解码次数必须为 0
+void BenchCore::iconLookup()
+{
+    QFETCH(int, rows);
+    const QString names[] = {"checked", "exam", "homework"};
+    const QSize size(16, 16);
+    for (const QString &name : names) {
+        IconCache::icon(name).pixmap(size);
+    }
+
+    IconCache::resetStats();
+    QBENCHMARK {
+        for (int row = 0; row < rows; ++row) {
+            QPixmap pixmap = IconCache::icon(names[row % 3]).pixmap(size);
+            Q_UNUSED(pixmap);
+        }
+    }
+    QCOMPARE(IconCache::stats().pixmapDecodes, 0);
+}
+
+void BenchCore::themeSwitch_data()
+{
+    QTest::addColumn<int>("widgets");
+    for (int widgets : {100, 1000}) {
+        QTest::newRow(QByteArray::number(widgets).constData()) << widgets;
+    }
+}
+
+// 在一个由常见控件组成的可见窗口上交替切换明暗主题，每次都重新 polish 整个窗口
+// 结果为 ThemeManager 自己记录的平均切换耗时
+void BenchCore::themeSwitch()
+{
+    QFETCH(int, widgets);
+    QWidget window;
+    auto *layout = new QGridLayout(&window);
+    for (int i = 0; i < widgets; ++i) {
+        QWidget *widget = nullptr;
+        switch (i % 4) {
+        case 0:
+            widget = new QPushButton(QString("按钮%1").arg(i));
+            break;
+        case 1:
+            widget = new QLineEdit;
+            break;
+        case 2:
+            widget = new QComboBox;
+            break;
+        default:
+            widget = new QLabel(QString("标签%1").arg(i));
+            break;
+        }
+        layout->addWidget(widget, i / 10, i % 10);
+    }
+    window.show();
+
+    ThemeManager themes;
+    themes.apply("light");
+    const int rounds = 20;
+    double totalMs = 0.0;
+    for (int i = 0; i < rounds; ++i) {
+        themes.apply(i % 2 == 0 ? "dark" : "light");
+        totalMs += themes.lastSwitchMs();
+    }
+    QTest::setBenchmarkResult(totalMs / rounds, QTest::WalltimeMilliseconds);
+}
+
+void BenchCore::snapshotPublish_data() { taskSizes(); }
+
+// 每次修改额外发布一个快照：只复制块索引和被修改的一块指针，记录本身共用
+// 直接调用 SnapshotPublisher::replace，不经过 TaskManager 按指针查找下标；
+// 修改位置分散到各块，结果为发布器自己统计的平均每次发布耗时
+void BenchCore::snapshotPublish()
+{
+    QFETCH(int, count);
+    SnapshotPublisher<TaskRecord> publisher;
+    publisher.appendAll(makeTasks(count));
+
+    const int rounds = 1000;
+    TaskRecord record = *publisher.at(0);
+    const quint64 publishedBefore = publisher.publishCount();
+    const qint64 nsBefore = publisher.totalPublishNs();
+    for (int i = 0; i < rounds; ++i) {
+        record.completed = !record.completed;
+        publisher.replace(int(qint64(i) * 7919 % count), record);
+    }
+    QCOMPARE(publisher.publishCount() - publishedBefore, quint64(rounds));
+    QTest::setBenchmarkResult(double(publisher.totalPublishNs() - nsBefore) / rounds / 1e6,
+                              QTest::WalltimeMilliseconds);
+}
+
+void BenchCore::apiQuery_data() { taskSizes(); }
+
+// 查询接口处理一次 /api/due?days=7 并生成正文（ETag 未命中时的开销），索引已建好
+void BenchCore::apiQuery()
+{
+    QFETCH(int, count);
+    ScheduleManager courses(ScheduleManager::DeferLoad);
+    courses.setAutoSave(false);
+    QVERIFY(courses.loadCourses(writeCourseFile(1000)));
+    TaskManager tasks;
+    QVERIFY(tasks.loadTasks(writeTaskFile(count)));
+
+    ScheduleApiHandler handler(&courses.snapshots(), &tasks.snapshots());
+    QUrlQuery query("days=7");
+    handler.resolve("/due", query);
+    QBENCHMARK {
+        ApiResource resource = handler.resolve("/due", query);
+        QByteArray body = resource.render().toJson(QJsonDocument::Compact);
+        Q_UNUSED(body);
+    }
+}
+
+void BenchCore::apiNotModified_data() { taskSizes(); }
+
+// ETag 命中时只检查快照版本并计算 ETag，不生成正文
+void BenchCore::apiNotModified()
+{
+    QFETCH(int, count);
+    ScheduleManager courses(ScheduleManager::DeferLoad);
+    courses.setAutoSave(false);
+    QVERIFY(courses.loadCourses(writeCourseFile(1000)));
+    TaskManager tasks;
+    QVERIFY(tasks.loadTasks(writeTaskFile(count)));
+
+    ScheduleApiHandler handler(&courses.snapshots(), &tasks.snapshots());
+    QUrlQuery query("days=7");
+    QByteArray etag = handler.resolve("/due", query).etag;
+    QBENCHMARK {
+        QCOMPARE(handler.resolve("/due", query).etag, etag);
+    }
+}
+
+// 与基准程序在同一目录（CMake）或同级的 cli 子目录（qmake）
+QString BenchCore::cliProgram()
+{
+    QDir dir(QCoreApplication::applicationDirPath());
+    return QStandardPaths::findExecutable("SmartScheduleAssistant-cli", {dir.path(), dir.filePath("../cli")});
+}
+
+void BenchCore::cliColdStart_data()
+{
+    QTest::addColumn<QString>("command");
+    QTest::newRow("next") << QString("next");
+    QTest::newRow("due") << QString("due");
+}
+
+// 命令行工具从启动进程到输出结果的总耗时（目标 20 ms 以内），数据为一个典型学生：100 门课程、1000 个任务
+void BenchCore::cliColdStart()
+{
+    QFETCH(QString, command);
+    const QString program = cliProgram();
+    if (program.isEmpty()) {
+        QSKIP("没有找到 SmartScheduleAssistant-cli，需要同时构建命令行工具");
+    }
+
+    QDir dir(m_dir.filePath("cli"));
+    if (!dir.exists()) {
+        QVERIFY(dir.mkpath("."));
+        QVERIFY(QFile::copy(writeCourseFile(100), dir.filePath("schedule.dat")));
+        QVERIFY(QFile::copy(writeTaskFile(1000), dir.filePath("tasks.dat")));
+    }
+
+    const QStringList args = {"--json", "--data-dir", dir.path(), command};
+    QBENCHMARK {
+        QProcess process;
+        process.start(program, args);
+        QVERIFY(process.waitForFinished(5000));
+        QCOMPARE(process.exitCode(), 0);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // 表格模型用到图标，主题切换需要控件，因此使用 QApplication；默认不连接显示服务器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    app.setOrganizationName("YourCompany");
+    app.setApplicationName("SmartScheduleAssistant");
+
+    BenchCore bench;
+
+    // --gate 基线文件 [--record]：性能门禁，其余参数照常交给 QTest
+    // --record 把本次结果写入基线文件（旧名 --update-baselines 仍可用）
+    QStringList args = app.arguments();
+    int gateIndex = args.indexOf("--gate");
+    if (gateIndex >= 0) {
+        if (gateIndex + 1 >= args.size()) {
+            qWarning("--gate 需要指定基线文件");
+            return 2;
+        }
+        QString baselinePath = args.at(gateIndex + 1);
+        bool update = args.contains("--record") || args.contains("--update-baselines");
+        return runPerfGate(&bench, args.first(), baselinePath, update);
+    }
+    return QTest::qExec(&bench, argc, argv);
+}
+
+#include "bench_core.moc"
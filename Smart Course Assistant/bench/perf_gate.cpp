@@ -0,0 +1,179 @@
+#include "perf_gate.h"
+#include "MemoryStats.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QXmlStreamReader>
+#include <QtTest>
+
+namespace {
+
+const double DEFAULT_TOLERANCE = 0.30;
+const char PEAK_RSS_KEY[] = "peakRss";
+
+// 读取 QTest 的 XML 输出：函数:数据行 -> 每次迭代的耗时（毫秒）
+QMap<QString, double> readBenchmarkResults(const QString &xmlPath)
+{
+    QMap<QString, double> results;
+    QFile file(xmlPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return results;
+    }
+
+    QXmlStreamReader xml(&file);
+    QString function;
+    while (!xml.atEnd()) {
+        if (!xml.readNextStartElement()) {
+            continue;
+        }
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = xml.attributes().value("name").toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            QXmlStreamAttributes attrs = xml.attributes();
+            double value = attrs.value("value").toDouble();
+            int iterations = qMax(1, attrs.value("iterations").toInt());
+            results.insert(function + ":" + attrs.value("tag").toString(), value / iterations);
+        }
+    }
+    return results;
+}
+
+QString formatValue(double value, const QString &unit)
+{
+    if (unit == "KB") {
+        return QString("%1 MB").arg(value / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 %2").arg(value, 0, 'f', value < 1.0 ? 4 : 2).arg(unit);
+}
+
+} // namespace
+
+int runPerfGate(QObject *bench, const QString &program, const QString &baselinePath,
+                bool updateBaselines)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QFile baselineFile(baselinePath);
+    if (!baselineFile.open(QIODevice::ReadOnly)) {
+        err << "无法读取基线文件: " << baselinePath << Qt::endl;
+        return 2;
+    }
+    QJsonObject root = QJsonDocument::fromJson(baselineFile.readAll()).object();
+    baselineFile.close();
+    QJsonObject metrics = root.value("metrics").toObject();
+    if (metrics.isEmpty()) {
+        err << "基线文件中没有指标: " << baselinePath << Qt::endl;
+        return 2;
+    }
+    const double defaultTolerance = root.value("tolerance").toDouble(DEFAULT_TOLERANCE);
+    const int median = root.value("median").toInt(5);
+
+    // 只运行列出的基准；每项取多次运行的中位数以降低抖动
+    QTemporaryDir dir;
+    QString xmlPath = dir.filePath("bench.xml");
+    QStringList args = { program, "-median", QString::number(median), "-o", xmlPath + ",xml" };
+    for (auto it = metrics.constBegin(); it != metrics.constEnd(); ++it) {
+        if (it.key() != PEAK_RSS_KEY) {
+            args << it.key();
+        }
+    }
+    int testResult = QTest::qExec(bench, args);
+    if (testResult != 0) {
+        err << "基准运行失败（" << testResult << " 项未通过），不进行比较" << Qt::endl;
+        return 2;
+    }
+
+    QMap<QString, double> results = readBenchmarkResults(xmlPath);
+    results.insert(PEAK_RSS_KEY, double(MemoryStats::peakRssKb()));
+
+    out << QString("性能门禁：%1，默认容差 +%2%").arg(baselinePath).arg(defaultTolerance * 100, 0, 'f', 0)
+        << Qt::endl;
+    out << QString("%1 %2 %3 %4  %5")
+               .arg("指标", -34).arg("基线", 12).arg("本次", 12).arg("变化", 9).arg("结果")
+        << Qt::endl;
+
+    QStringList regressions;
+    for (auto it = metrics.begin(); it != metrics.end(); ++it) {
+        QJsonObject metric = it.value().toObject();
+        const QString key = it.key();
+        const QString unit = metric.value("unit").toString("ms");
+        const QString label = QString("%1 (%2)").arg(metric.value("label").toString(key), key);
+        const double tolerance = metric.value("tolerance").toDouble(defaultTolerance);
+
+        if (!results.contains(key) || results.value(key) < 0) {
+            out << QString("%1 %2").arg(label, -34).arg("无结果（基准名称或数据行不存在）") << Qt::endl;
+            regressions << QString("%1：没有得到测量结果").arg(label);
+            continue;
+        }
+        const double current = results.value(key);
+
+        // 绝对上限：例如命令行冷启动的 20 ms 目标
+        const double limit = metric.value("limit").toDouble(-1.0);
+        const bool overLimit = limit > 0 && current > limit;
+        if (overLimit) {
+            regressions << QString("%1：%2 超过上限 %3")
+                               .arg(label, formatValue(current, unit), formatValue(limit, unit));
+        }
+
+        QJsonValue baselineValue = metric.value("baseline");
+        if (!baselineValue.isDouble()) {
+            out << QString("%1 %2 %3 %4  %5")
+                       .arg(label, -34).arg("-", 12).arg(formatValue(current, unit), 12)
+                       .arg("-", 9).arg(overLimit ? "超出上限" : "未记录基线")
+                << Qt::endl;
+            // 没有基线就无从判断回归，不能当作通过
+            if (!updateBaselines) {
+                regressions << QString("%1：未记录基线，请在参考机器上运行 --gate %2 --record")
+                                   .arg(label, baselinePath);
+            }
+        } else {
+            const double baseline = baselineValue.toDouble();
+            const double change = baseline > 0 ? (current - baseline) / baseline : 0.0;
+            const bool regressed = change > tolerance;
+            out << QString("%1 %2 %3 %4  %5")
+                       .arg(label, -34)
+                       .arg(formatValue(baseline, unit), 12)
+                       .arg(formatValue(current, unit), 12)
+                       .arg(QString("%1%2%").arg(change >= 0 ? "+" : "").arg(change * 100, 0, 'f', 1), 9)
+                       .arg(regressed ? "回归" : overLimit ? "超出上限" : "通过")
+                << Qt::endl;
+            if (regressed) {
+                regressions << QString("%1：%2 → %3，增加 %4%（允许 +%5%）")
+                                   .arg(label, formatValue(baseline, unit), formatValue(current, unit))
+                                   .arg(change * 100, 0, 'f', 1)
+                                   .arg(tolerance * 100, 0, 'f', 0);
+            }
+        }
+
+        if (updateBaselines) {
+            metric["baseline"] = current;
+            it.value() = metric;
+        }
+    }
+
+    if (updateBaselines) {
+        root["metrics"] = metrics;
+        if (!baselineFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "无法写入基线文件: " << baselinePath << Qt::endl;
+            return 2;
+        }
+        baselineFile.write(QJsonDocument(root).toJson());
+        out << "已用本次结果更新基线" << Qt::endl;
+        return 0;
+    }
+
+    if (!regressions.isEmpty()) {
+        out << Qt::endl << QString("%1 项性能回归：").arg(regressions.size()) << Qt::endl;
+        for (const QString &line : regressions) {
+            out << "  - " << line << Qt::endl;
+        }
+        return 1;
+    }
+    out << Qt::endl << "未发现性能回归" << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef PERF_GATE_H
+#define PERF_GATE_H
+
+#include <QString>
+
+class QObject;
+
+// 性能门禁：只运行基线文件中列出的基准（函数:数据行），与基线比较
+// 超出容差时输出回归明细并返回非零；updateBaselines 为 true（--record）时把本次结果写回基线文件
+// 基线中 baseline 为 null 的指标视为尚未记录，门禁失败，需先在参考机器上用 --record 记录；
+// 因此 CTest（SMARTSCHEDULE_PERF_GATE）和 make check（CONFIG+=perf_gate）默认不注册门禁
+// 指标可另设 limit 作为绝对上限（与基线无关），超出即判为失败
+int runPerfGate(QObject *bench, const QString &program, const QString &baselinePath,
+                bool updateBaselines);
+
+#endif // PERF_GATE_H
@@ -0,0 +1,14 @@
+# 命令行查询工具：不创建 QApplication、窗口和托盘图标
+TARGET = SmartScheduleAssistant-cli
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+# QColor 位于 gui 模块，但这里不需要 widgets
+QT += core gui
+
+include(../SmartScheduleCore.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,218 @@
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+#include "MemoryStats.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QDir>
+#include <QLoggingCategory>
+#include <QSettings>
+#include <QStandardPaths>
+#include <cstdio>
+
+// 命令行查询工具：直接读取 schedule.dat / tasks.dat 回答查询
+// 用法：SmartScheduleAssistant-cli [--json] [--data-dir 目录] [--semester-start 日期] now|next|today|due|tasks|memory
+
+namespace {
+
+QJsonObject courseToJson(const Course *course)
+{
+    QJsonObject obj;
+    obj["name"] = course->name();
+    obj["dayOfWeek"] = course->dayOfWeek();
+    obj["startSection"] = course->startSection();
+    obj["endSection"] = course->endSection();
+    obj["startTime"] = ScheduleManager::getSectionStartTime(course->startSection()).toString("HH:mm");
+    obj["endTime"] = ScheduleManager::getSectionEndTime(course->endSection()).toString("HH:mm");
+    obj["classroom"] = course->classroom();
+    obj["teacher"] = course->teacher();
+    obj["weeks"] = Course::weekParityText(course->weekParity());
+    return obj;
+}
+
+QJsonObject taskToJson(const Task *task)
+{
+    QJsonObject obj;
+    obj["title"] = task->title();
+    obj["course"] = task->courseName();
+    obj["dueDate"] = task->dueDate().toString(Qt::ISODate);
+    if (task->dueTime().isValid()) {
+        obj["dueTime"] = task->dueTime().toString("HH:mm");
+    }
+    obj["exam"] = task->isExam();
+    obj["completed"] = task->isCompleted();
+    obj["daysRemaining"] = task->daysRemaining();
+    obj["status"] = task->statusText();
+    return obj;
+}
+
+QString courseLine(const Course *course)
+{
+    return QString("%1-%2 %3 %4 %5")
+        .arg(ScheduleManager::getSectionStartTime(course->startSection()).toString("HH:mm"))
+        .arg(ScheduleManager::getSectionEndTime(course->endSection()).toString("HH:mm"))
+        .arg(course->name())
+        .arg(course->classroom())
+        .arg(course->teacher())
+        .trimmed();
+}
+
+QString taskLine(const Task *task)
+{
+    return QString("%1 [%2] %3%4 (%5)")
+        .arg(task->dueDate().toString("yyyy-MM-dd"))
+        .arg(task->courseName())
+        .arg(task->isExam() ? "考试: " : "")
+        .arg(task->title())
+        .arg(task->statusText());
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    // 与主程序一致，才能定位到相同的数据目录
+    app.setOrganizationName("YourCompany");
+    app.setApplicationName("SmartScheduleAssistant");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("智能课程助手命令行查询工具");
+    parser.addHelpOption();
+    QCommandLineOption jsonOption("json", "以 JSON 格式输出");
+    QCommandLineOption dataDirOption("data-dir", "数据文件所在目录", "dir");
+    QCommandLineOption daysOption("days", "due 命令：查询今后 N 天内截止的任务（默认 0，即今天）", "n", "0");
+    parser.addOption(jsonOption);
+    parser.addOption(dataDirOption);
+    QCommandLineOption verboseOption("verbose", "输出读取数据时的警告信息");
+    parser.addOption(daysOption);
+    parser.addOption(verboseOption);
+    QCommandLineOption semesterOption("semester-start",
+                                      "学期第一周的日期 yyyy-MM-dd，用于区分单双周（默认读取主程序的学期设置）", "date");
+    parser.addOption(semesterOption);
+    parser.addPositionalArgument("command", "now | next | today | due | tasks | memory");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList args = parser.positionalArguments();
+    const QString command = args.isEmpty() ? QString("next") : args.first();
+    const bool json = parser.isSet(jsonOption);
+
+    QString scheduleFile = ScheduleManager::dataFilePath();
+    QString taskFile = TaskManager::dataFilePath();
+    if (parser.isSet(dataDirOption)) {
+        QDir dir(parser.value(dataDirOption));
+        scheduleFile = dir.filePath("schedule.dat");
+        taskFile = dir.filePath("tasks.dat");
+    }
+
+    // 脚本调用时缺少数据文件按空数据处理，不输出警告
+    if (!parser.isSet(verboseOption)) {
+        QLoggingCategory::setFilterRules("default.warning=false\ndefault.debug=false");
+    }
+
+    // 只加载命令需要的文件
+    QDateTime now = QDateTime::currentDateTime();
+    QJsonValue result;
+    QStringList lines;
+
+    if (command == "now" || command == "next" || command == "today") {
+        // 只读取一个文件：构造时不加载默认数据文件
+        ScheduleManager schedule(ScheduleManager::DeferLoad);
+        schedule.setAutoSave(false);
+        schedule.loadCourses(scheduleFile);
+
+        // 与主程序共用设置文件中的学期开始日期（见 Settings）
+        QDate semesterStart;
+        if (parser.isSet(semesterOption)) {
+            semesterStart = QDate::fromString(parser.value(semesterOption), Qt::ISODate);
+            if (!semesterStart.isValid()) {
+                err << "无效的学期开始日期: " << parser.value(semesterOption) << Qt::endl;
+                return 2;
+            }
+        } else {
+            QSettings settings(QStandardPaths::writableLocation(QStandardPaths::AppConfigLocation) +
+                                   "/config.ini", QSettings::IniFormat);
+            semesterStart = settings.value("Semester/StartDate").toDate();
+        }
+
+        if (command == "today") {
+            const int week = ScheduleManager::semesterWeek(semesterStart, now.date());
+            QJsonArray array;
+            for (Course *course : schedule.getCoursesByDay(now.date().dayOfWeek())) {
+                if (!course->occursInWeek(week)) continue;
+                array.append(courseToJson(course));
+                lines << courseLine(course);
+            }
+            result = array;
+        } else {
+            Course *course = command == "now"
+                                 ? ScheduleManager::currentCourseAt(schedule.getAllCourses(), now, semesterStart)
+                                 : ScheduleManager::nextCourseAt(schedule.getAllCourses(), now, semesterStart);
+            if (course) {
+                result = courseToJson(course);
+                lines << courseLine(course);
+            } else {
+                result = QJsonValue::Null;
+                lines << (command == "now" ? "当前没有课程" : "近两周没有后续课程");
+            }
+        }
+    } else if (command == "due" || command == "tasks") {
+        TaskManager tasks;
+        tasks.loadTasks(taskFile);
+
+        bool ok = false;
+        int days = parser.value(daysOption).toInt(&ok);
+        if (!ok || days < 0) {
+            err << "无效的天数: " << parser.value(daysOption) << Qt::endl;
+            return 2;
+        }
+        QDate last = now.date().addDays(days);
+
+        QJsonArray array;
+        for (Task *task : tasks.getAllTasks()) {
+            if (command == "due" && (task->isCompleted() || task->dueDate() > last)) {
+                continue;
+            }
+            array.append(taskToJson(task));
+            lines << taskLine(task);
+        }
+        result = array;
+    } else if (command == "memory") {
+        // 加载全部数据后输出各子系统的内存估算
+        ScheduleManager schedule(ScheduleManager::DeferLoad);
+        schedule.setAutoSave(false);
+        schedule.loadCourses(scheduleFile);
+        TaskManager tasks;
+        tasks.loadTasks(taskFile);
+
+        MemoryReport report;
+        schedule.reportMemory(report);
+        tasks.reportMemory(report);
+        if (json) {
+            out << QJsonDocument(report.toJson()).toJson(QJsonDocument::Compact) << Qt::endl;
+        } else {
+            out << report.toText();
+        }
+        return 0;
+    } else {
+        err << "未知命令: " << command << Qt::endl;
+        parser.showHelp(2);
+    }
+
+    if (json) {
+        QJsonDocument doc = result.isArray() ? QJsonDocument(result.toArray())
+                                             : QJsonDocument(QJsonObject{{"course", result}});
+        out << doc.toJson(QJsonDocument::Compact) << Qt::endl;
+    } else {
+        for (const QString &line : lines) {
+            out << line << Qt::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+# 由 pgo-train 调用：把 Clang 插桩产生的 *.profraw 合并为 default.profdata
+file(GLOB raw_profiles "${PGO_DIR}/*.profraw")
+if(NOT raw_profiles)
+    message(FATAL_ERROR "在 ${PGO_DIR} 中没有找到 .profraw，基准是否以插桩构建运行？")
+endif()
+execute_process(
+    COMMAND ${LLVM_PROFDATA} merge -output=${PGO_DIR}/default.profdata ${raw_profiles}
+    RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "llvm-profdata merge 失败：${result}")
+endif()
@@ -0,0 +1,97 @@
+# 可选的链接时优化（LTO）与配置文件引导优化（PGO）
+#
+# LTO：  cmake -DSMARTSCHEDULE_ENABLE_LTO=ON ...
+# PGO：  1. cmake -DSMARTSCHEDULE_PGO=GENERATE -DCMAKE_BUILD_TYPE=Release ..  && cmake --build .
+#        2. cmake --build . --target pgo-train      在性能基准的工作负载上收集训练数据
+#        3. cmake -DSMARTSCHEDULE_PGO=USE .          && cmake --build .   （同一构建目录）
+# 目前支持 GCC 与 Clang；Clang 的原始数据由 pgo-train 用 llvm-profdata 合并为 default.profdata
+
+set(SMARTSCHEDULE_CMAKE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+if(SMARTSCHEDULE_ENABLE_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT SMARTSCHEDULE_IPO_SUPPORTED OUTPUT SMARTSCHEDULE_IPO_OUTPUT)
+    if(SMARTSCHEDULE_IPO_SUPPORTED)
+        set(CMAKE_INTERPROCEDURAL_OPTIMIZATION ON)
+        message(STATUS "SmartSchedule: 已启用 LTO")
+    else()
+        message(WARNING "SmartSchedule: 当前编译器不支持 LTO：${SMARTSCHEDULE_IPO_OUTPUT}")
+    endif()
+endif()
+
+# 训练使用的基准行：覆盖加载、保存、表格刷新、冲突检测与快照发布
+set(SMARTSCHEDULE_PGO_TRAINING_BENCHMARKS
+    loadCourses:1000 saveCourses:1000
+    loadTasks:10000 saveTasks:10000
+    courseTableRefresh:1000 taskTableRefresh:10000
+    addCourseConflictCheck:1000 snapshotPublish:10000
+    CACHE STRING "PGO 训练时运行的基准（函数:数据行）")
+
+set(SMARTSCHEDULE_PGO_IS_CLANG FALSE)
+if(CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    set(SMARTSCHEDULE_PGO_IS_CLANG TRUE)
+endif()
+
+if(SMARTSCHEDULE_PGO STREQUAL "GENERATE")
+    if(NOT (CMAKE_CXX_COMPILER_ID STREQUAL "GNU" OR SMARTSCHEDULE_PGO_IS_CLANG))
+        message(FATAL_ERROR "SmartSchedule: PGO 仅支持 GCC 与 Clang")
+    endif()
+    file(MAKE_DIRECTORY "${SMARTSCHEDULE_PGO_DIR}")
+    add_compile_options(-fprofile-generate=${SMARTSCHEDULE_PGO_DIR})
+    add_link_options(-fprofile-generate=${SMARTSCHEDULE_PGO_DIR})
+    message(STATUS "SmartSchedule: PGO 插桩构建，训练数据写入 ${SMARTSCHEDULE_PGO_DIR}")
+elseif(SMARTSCHEDULE_PGO STREQUAL "USE")
+    if(SMARTSCHEDULE_PGO_IS_CLANG)
+        set(SMARTSCHEDULE_PGO_PROFILE "${SMARTSCHEDULE_PGO_DIR}/default.profdata")
+        if(NOT EXISTS "${SMARTSCHEDULE_PGO_PROFILE}")
+            message(FATAL_ERROR "SmartSchedule: 找不到 ${SMARTSCHEDULE_PGO_PROFILE}，请先以 GENERATE 构建并运行 pgo-train")
+        endif()
+        add_compile_options(-fprofile-use=${SMARTSCHEDULE_PGO_PROFILE} -Wno-profile-instr-out-of-date)
+        add_link_options(-fprofile-use=${SMARTSCHEDULE_PGO_PROFILE})
+    elseif(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+        if(NOT EXISTS "${SMARTSCHEDULE_PGO_DIR}")
+            message(FATAL_ERROR "SmartSchedule: 找不到 ${SMARTSCHEDULE_PGO_DIR}，请先以 GENERATE 构建并运行 pgo-train")
+        endif()
+        # 未被训练覆盖的函数按普通优化处理，而不是当作冷代码
+        add_compile_options(-fprofile-use=${SMARTSCHEDULE_PGO_DIR} -fprofile-partial-training
+                            -fprofile-correction -Wno-missing-profile)
+        add_link_options(-fprofile-use=${SMARTSCHEDULE_PGO_DIR})
+    else()
+        message(FATAL_ERROR "SmartSchedule: PGO 仅支持 GCC 与 Clang")
+    endif()
+    message(STATUS "SmartSchedule: 使用 ${SMARTSCHEDULE_PGO_DIR} 中的训练数据进行 PGO 构建")
+elseif(NOT SMARTSCHEDULE_PGO STREQUAL "OFF")
+    message(FATAL_ERROR "SmartSchedule: SMARTSCHEDULE_PGO 只能是 OFF、GENERATE 或 USE")
+endif()
+
+# 在所有目标定义之后调用：添加 pgo-train 目标
+function(smartschedule_setup_pgo_training)
+    if(NOT SMARTSCHEDULE_PGO STREQUAL "GENERATE")
+        return()
+    endif()
+    if(NOT TARGET SmartScheduleAssistant-bench)
+        message(WARNING "SmartSchedule: PGO 训练需要 SMARTSCHEDULE_BUILD_BENCHMARKS=ON")
+        return()
+    endif()
+
+    set(commands
+        COMMAND ${CMAKE_COMMAND} -E env QT_QPA_PLATFORM=offscreen
+                $<TARGET_FILE:SmartScheduleAssistant-bench> ${SMARTSCHEDULE_PGO_TRAINING_BENCHMARKS})
+    if(SMARTSCHEDULE_PGO_IS_CLANG)
+        get_filename_component(compiler_dir "${CMAKE_CXX_COMPILER}" DIRECTORY)
+        find_program(LLVM_PROFDATA NAMES llvm-profdata HINTS "${compiler_dir}")
+        if(NOT LLVM_PROFDATA)
+            message(FATAL_ERROR "SmartSchedule: Clang 的 PGO 训练需要 llvm-profdata")
+        endif()
+        list(APPEND commands
+            COMMAND ${CMAKE_COMMAND} -DLLVM_PROFDATA=${LLVM_PROFDATA} -DPGO_DIR=${SMARTSCHEDULE_PGO_DIR}
+                    -P ${SMARTSCHEDULE_CMAKE_DIR}/MergeProfiles.cmake)
+    endif()
+
+    add_custom_target(pgo-train
+        ${commands}
+        DEPENDS SmartScheduleAssistant-bench
+        WORKING_DIRECTORY ${CMAKE_BINARY_DIR}
+        COMMENT "在性能基准上收集 PGO 训练数据"
+        VERBATIM)
+endfunction()
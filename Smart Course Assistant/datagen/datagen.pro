@@ -0,0 +1,13 @@
+# 测试数据生成工具：按给定规模和分布生成 schedule.dat / tasks.dat
+TARGET = SmartScheduleAssistant-datagen
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT += core gui
+
+include(../SmartScheduleCore.pri)
+
+SOURCES += \
+    main.cpp
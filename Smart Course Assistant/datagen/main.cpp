@@ -0,0 +1,283 @@
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include <QtMath>
+
+// 测试数据生成工具
+// 用法：SmartScheduleAssistant-datagen --seed 42 --courses 120 --tasks 100000 --out 目录
+// 相同的种子和参数总是生成逐字节相同的文件（日期以 --today 为基准）
+
+namespace {
+
+struct Options {
+    quint32 seed = 1;
+    int courses = 40;
+    int tasks = 10000;
+    double oddEvenRatio = 0.3;      // 单双周课程占比
+    double examRatio = 0.08;
+    double completionRate = 0.85;   // 已过期任务的完成率
+    double earlyCompletionRate = 0.2; // 未到期任务的完成率
+    int pastDays = 120;
+    int futureDays = 60;
+    bool allowConflicts = false;
+    QDate today;
+};
+
+const char *const COURSE_NAMES[] = {
+    "高等数学", "线性代数", "概率论", "大学物理", "程序设计", "数据结构", "离散数学",
+    "计算机组成", "操作系统", "计算机网络", "数据库", "编译原理", "大学英语", "体育",
+    "思想政治", "电路分析", "信号与系统", "人工智能", "机器学习", "软件工程"
+};
+const int COURSE_NAME_COUNT = sizeof(COURSE_NAMES) / sizeof(COURSE_NAMES[0]);
+
+const char *const TASK_KINDS[] = { "作业", "实验报告", "阅读", "小测", "项目", "习题" };
+const int TASK_KIND_COUNT = sizeof(TASK_KINDS) / sizeof(TASK_KINDS[0]);
+
+// 常见的课程长度：两节连上最多，其次一节和三节
+int drawLength(QRandomGenerator &rng)
+{
+    int p = rng.bounded(100);
+    if (p < 60) return 2;
+    if (p < 85) return 1;
+    if (p < 97) return 3;
+    return 4;
+}
+
+// 截止日期集中在周五和周日，且越靠近 [today - pastDays, today + futureDays] 的中点越密集
+QDate drawDueDate(QRandomGenerator &rng, const Options &options)
+{
+    int span = options.pastDays + options.futureDays;
+    // 三角分布，峰值在 today + (futureDays - pastDays) / 2，两者相等时才落在今天
+    double u = (rng.generateDouble() + rng.generateDouble()) / 2.0;
+    int offset = qRound(u * span) - options.pastDays;
+    QDate date = options.today.addDays(offset);
+
+    int p = rng.bounded(100);
+    int target = p < 35 ? 5 : (p < 60 ? 7 : date.dayOfWeek());
+    return date.addDays(target - date.dayOfWeek());
+}
+
+bool generateCourses(const QString &path, const Options &options, QRandomGenerator &rng,
+                     QStringList &names, QTextStream &err)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        err << "无法写入: " << path << Qt::endl;
+        return false;
+    }
+
+    // 占用表：[星期][节次][单周/双周]；每周上课的课程占用两半，与 Course::hasTimeConflictWith 一致
+    bool used[7][Course::MAX_SECTION][2] = {};
+    auto occupies = [](int weekParity, int half) {
+        return weekParity == Course::EveryWeek || weekParity == half + 1;
+    };
+    auto isFree = [&](int day, int start, int end, int weekParity) {
+        for (int section = start; section <= end; ++section) {
+            for (int half = 0; half < 2; ++half) {
+                if (occupies(weekParity, half) && used[day - 1][section - 1][half]) return false;
+            }
+        }
+        return true;
+    };
+
+    // 只排了单周或只排了双周课程的时段，优先留给另一半，生成交替上课的单双周课程对
+    struct HalfSlot {
+        int day;
+        int start;
+        int end;
+        int weekParity;     // 已占用的一半
+    };
+    QVector<HalfSlot> halfSlots;
+
+    QVector<CourseRecord> records;
+    records.reserve(options.courses);
+
+    for (int i = 0; i < options.courses; ++i) {
+        CourseRecord record;
+        record.name = QString("%1%2").arg(COURSE_NAMES[i % COURSE_NAME_COUNT])
+                          .arg(i < COURSE_NAME_COUNT ? QString() : QString("(%1)").arg(i / COURSE_NAME_COUNT + 1));
+        record.classroom = QString("%1-%2").arg(QChar('A' + rng.bounded(6))).arg(rng.bounded(101, 520));
+        record.teacher = QString("教师%1").arg(rng.bounded(1, 300));
+        record.color = QColor::fromHsv(rng.bounded(360), 120 + rng.bounded(60), 220);
+        record.weekParity = rng.generateDouble() < options.oddEvenRatio
+                                ? (rng.bounded(2) ? Course::OddWeeks : Course::EvenWeeks)
+                                : Course::EveryWeek;
+
+        // 单双周课程先找另一半空着的时段；否则在不冲突的位置放置，尝试多次仍失败则说明课表已满
+        bool placed = false;
+        if (record.weekParity != Course::EveryWeek) {
+            for (int k = 0; k < halfSlots.size() && !placed; ++k) {
+                const HalfSlot slot = halfSlots.at(k);
+                if (slot.weekParity == record.weekParity) continue;
+                halfSlots.remove(k--);
+                if (!options.allowConflicts && !isFree(slot.day, slot.start, slot.end, record.weekParity)) {
+                    continue;
+                }
+                record.dayOfWeek = slot.day;
+                record.startSection = slot.start;
+                record.endSection = slot.end;
+                placed = true;
+            }
+        }
+        for (int attempt = 0; attempt < 200 && !placed; ++attempt) {
+            int length = drawLength(rng);
+            int day = rng.bounded(100) < 90 ? rng.bounded(1, 6) : rng.bounded(6, 8);
+            int start = rng.bounded(1, Course::MAX_SECTION - length + 2);
+            int end = start + length - 1;
+
+            if (!options.allowConflicts && !isFree(day, start, end, record.weekParity)) continue;
+
+            record.dayOfWeek = day;
+            record.startSection = start;
+            record.endSection = end;
+            placed = true;
+            if (record.weekParity != Course::EveryWeek) {
+                halfSlots.append({day, start, end, record.weekParity});
+            }
+        }
+
+        if (!placed) {
+            err << QString("课表已满，只生成了 %1 门课程（可用 --allow-conflicts 生成重叠课程）")
+                       .arg(records.size())
+                << Qt::endl;
+            break;
+        }
+        for (int section = record.startSection; section <= record.endSection; ++section) {
+            for (int half = 0; half < 2; ++half) {
+                if (occupies(record.weekParity, half)) {
+                    used[record.dayOfWeek - 1][section - 1][half] = true;
+                }
+            }
+        }
+        records.append(record);
+        names << record.name;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    ScheduleManager::writeCoursesHeader(out, static_cast<quint32>(records.size()));
+    for (const CourseRecord &record : std::as_const(records)) {
+        ScheduleManager::writeCourseRecord(out, record);
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+// 任务逐条生成并直接写入，百万级任务也不需要全部放在内存中
+bool generateTasks(const QString &path, const Options &options, QRandomGenerator &rng,
+                   const QStringList &courseNames, QTextStream &err)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        err << "无法写入: " << path << Qt::endl;
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+    out << static_cast<quint32>(options.tasks);
+
+    for (int i = 0; i < options.tasks; ++i) {
+        TaskRecord record;
+        record.courseName = courseNames.isEmpty()
+                                ? QString()
+                                : courseNames.at(rng.bounded(courseNames.size()));
+        record.exam = rng.generateDouble() < options.examRatio;
+        record.title = record.exam
+                           ? QString("%1 考试").arg(record.courseName)
+                           : QString("%1 %2").arg(TASK_KINDS[rng.bounded(TASK_KIND_COUNT)]).arg(i + 1);
+        record.dueDate = drawDueDate(rng, options);
+        // 大多数作业在晚上截止，一部分没有具体时间
+        if (rng.bounded(100) < 80) {
+            record.dueTime = QTime(rng.bounded(100) < 70 ? 23 : rng.bounded(8, 22), rng.bounded(100) < 70 ? 59 : 0);
+        }
+        double completion = record.dueDate < options.today ? options.completionRate
+                                                            : options.earlyCompletionRate;
+        record.completed = rng.generateDouble() < completion;
+        if (rng.bounded(100) < 30) {
+            record.description = QString("第%1章").arg(rng.bounded(1, 16));
+        }
+        TaskManager::writeTaskRecord(out, record);
+    }
+    return out.status() == QDataStream::Ok;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("生成课程与任务测试数据（原生 QDataStream 格式）");
+    parser.addHelpOption();
+    QCommandLineOption seedOption("seed", "随机种子（默认 1）", "n", "1");
+    QCommandLineOption coursesOption("courses", "课程数量（默认 40）", "n", "40");
+    QCommandLineOption tasksOption("tasks", "任务数量（默认 10000）", "n", "10000");
+    QCommandLineOption oddEvenOption("odd-even-ratio", "单双周课程占比（默认 0.3）", "ratio", "0.3");
+    QCommandLineOption examOption("exam-ratio", "考试占比（默认 0.08）", "ratio", "0.08");
+    QCommandLineOption completionOption("completion-rate", "已过期任务完成率（默认 0.85）", "ratio", "0.85");
+    QCommandLineOption earlyOption("early-completion-rate", "未到期任务完成率（默认 0.2）", "ratio", "0.2");
+    QCommandLineOption pastOption("past-days", "截止日期最早在今天之前多少天（默认 120）", "n", "120");
+    QCommandLineOption futureOption("future-days", "截止日期最晚在今天之后多少天（默认 60）", "n", "60");
+    QCommandLineOption todayOption("today", "基准日期 yyyy-MM-dd（默认当天，固定后结果可复现）", "date");
+    QCommandLineOption conflictsOption("allow-conflicts", "允许课程时间重叠，用于超出课表容量的规模");
+    QCommandLineOption outOption("out", "输出目录（默认当前目录）", "dir", ".");
+    parser.addOptions({seedOption, coursesOption, tasksOption, oddEvenOption, examOption,
+                       completionOption, earlyOption, pastOption, futureOption, todayOption,
+                       conflictsOption, outOption});
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Options options;
+    options.seed = parser.value(seedOption).toUInt();
+    options.courses = qMax(0, parser.value(coursesOption).toInt());
+    options.tasks = qMax(0, parser.value(tasksOption).toInt());
+    options.oddEvenRatio = qBound(0.0, parser.value(oddEvenOption).toDouble(), 1.0);
+    options.examRatio = qBound(0.0, parser.value(examOption).toDouble(), 1.0);
+    options.completionRate = qBound(0.0, parser.value(completionOption).toDouble(), 1.0);
+    options.earlyCompletionRate = qBound(0.0, parser.value(earlyOption).toDouble(), 1.0);
+    options.pastDays = qMax(0, parser.value(pastOption).toInt());
+    options.futureDays = qMax(0, parser.value(futureOption).toInt());
+    options.allowConflicts = parser.isSet(conflictsOption);
+    options.today = parser.isSet(todayOption)
+                        ? QDate::fromString(parser.value(todayOption), "yyyy-MM-dd")
+                        : QDate::currentDate();
+    if (!options.today.isValid()) {
+        err << "无效的日期: " << parser.value(todayOption) << Qt::endl;
+        return 2;
+    }
+
+    QDir dir(parser.value(outOption));
+    if (!dir.exists() && !dir.mkpath(".")) {
+        err << "无法创建输出目录: " << dir.path() << Qt::endl;
+        return 1;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // 课程和任务使用各自的随机序列，改变一方的数量不影响另一方
+    QRandomGenerator courseRng(options.seed);
+    QRandomGenerator taskRng(options.seed ^ 0x9e3779b9u);
+    QStringList names;
+    if (!generateCourses(dir.filePath("schedule.dat"), options, courseRng, names, err) ||
+        !generateTasks(dir.filePath("tasks.dat"), options, taskRng, names, err)) {
+        return 1;
+    }
+
+    out << QString("已生成 %1 门课程、%2 项任务到 %3，用时 %4 ms")
+               .arg(names.size())
+               .arg(options.tasks)
+               .arg(dir.absolutePath())
+               .arg(timer.elapsed())
+        << Qt::endl;
+    return 0;
+}
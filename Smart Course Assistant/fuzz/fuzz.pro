@@ -0,0 +1,15 @@
+# 数据文件读取的模糊测试：对合法文件做随机变异，检查读取总能结束且内存不随输入增长
+# 运行：./SmartScheduleAssistant-fuzz --iterations 20000 --seed 1
+#       ./SmartScheduleAssistant-fuzz --replay fuzz-failure-1.dat   复现保存下来的输入
+TARGET = SmartScheduleAssistant-fuzz
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT += core gui
+
+include(../SmartScheduleCore.pri)
+
+SOURCES += \
+    main.cpp
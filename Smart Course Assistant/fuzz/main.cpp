@@ -0,0 +1,261 @@
+#include "ScheduleManager.h"
+#include "TaskManager.h"
+#include "DataFileReader.h"
+#include "MemoryStats.h"
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QLoggingCategory>
+#include <QRandomGenerator>
+#include <QTextStream>
+
+// 数据文件读取的模糊测试
+// 以合法的课程/任务文件为种子做变异（翻转位、改写长度字段、截断、拼接），逐个交给读取函数
+// 检查项：读出的记录数不超过文件长度能容纳的上限；单次读取耗时有界；
+// 预热后的峰值常驻内存增长不超过 --max-rss-growth（默认 32 MB），即内存与输入内容无关
+
+namespace {
+
+enum FileKind { CourseFile = 0, TaskFile = 1 };
+
+// 与读取端的最小记录长度一致，用于检查读出的记录数
+const qint64 MIN_COURSE_BYTES = 4 * DataFileReader::STRING_HEADER_BYTES + 3 * 4 + DataFileReader::COLOR_BYTES;
+const qint64 MIN_TASK_BYTES = 3 * DataFileReader::STRING_HEADER_BYTES + DataFileReader::DATE_BYTES
+                              + DataFileReader::TIME_BYTES + 2;
+
+// 会让旧读取代码按虚假长度分配的值
+const quint32 HOSTILE_VALUES[] = {
+    0xFFFFFFFF, 0xFFFFFFFE, 0x7FFFFFFF, 0x7FFFFFFE, 0x80000000, 0x10000000, 0x00FFFFFF, 0, 1
+};
+
+QByteArray makeCourseSeed(QRandomGenerator &rng)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream out(&buffer);
+    out.setVersion(QDataStream::Qt_5_15);
+
+    const int count = 40;
+    ScheduleManager::writeCoursesHeader(out, count);
+    for (int i = 0; i < count; ++i) {
+        CourseRecord record;
+        record.name = QString("课程%1").arg(i);
+        record.dayOfWeek = rng.bounded(1, 8);
+        record.startSection = rng.bounded(1, Course::MAX_SECTION);
+        record.endSection = record.startSection + 1;
+        record.classroom = QString("教%1").arg(rng.bounded(100, 500));
+        record.teacher = "教师";
+        record.note = i % 3 == 0 ? QString("备注") : QString();
+        record.color = QColor::fromHsv(rng.bounded(360), 150, 230);
+        record.weekParity = rng.bounded(3);
+        ScheduleManager::writeCourseRecord(out, record);
+    }
+    return data;
+}
+
+QByteArray makeTaskSeed(QRandomGenerator &rng)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    QDataStream out(&buffer);
+    out.setVersion(QDataStream::Qt_5_15);
+
+    const int count = 200;
+    out << quint32(count);
+    for (int i = 0; i < count; ++i) {
+        TaskRecord record;
+        record.title = QString("任务%1").arg(i);
+        record.courseName = "高等数学";
+        record.dueDate = QDate(2025, 3, 3).addDays(rng.bounded(-60, 60));
+        record.dueTime = QTime(rng.bounded(8, 23), 0);
+        record.description = i % 4 == 0 ? QString("说明") : QString();
+        record.completed = rng.bounded(2);
+        record.exam = rng.bounded(10) == 0;
+        TaskManager::writeTaskRecord(out, record);
+    }
+    return data;
+}
+
+void writeQuint32(QByteArray &data, int offset, quint32 value)
+{
+    for (int i = 0; i < 4 && offset + i < data.size(); ++i) {
+        data[offset + i] = char((value >> (24 - 8 * i)) & 0xFF);
+    }
+}
+
+// 每次叠加 1~4 种变异
+QByteArray mutate(const QByteArray &seed, QRandomGenerator &rng)
+{
+    QByteArray data = seed;
+    int rounds = rng.bounded(1, 5);
+    for (int r = 0; r < rounds && !data.isEmpty(); ++r) {
+        switch (rng.bounded(6)) {
+        case 0: // 翻转若干位
+            for (int i = rng.bounded(1, 9); i > 0; --i) {
+                int pos = rng.bounded(int(data.size()));
+                data[pos] = char(data.at(pos) ^ (1 << rng.bounded(8)));
+            }
+            break;
+        case 1: // 任意位置写入恶意的长度值
+            writeQuint32(data, rng.bounded(int(data.size())), HOSTILE_VALUES[rng.bounded(int(sizeof(HOSTILE_VALUES) / 4))]);
+            break;
+        case 2: // 改写记录数（课程文件在版本号之后）
+            writeQuint32(data, rng.bounded(2) ? 4 : 0, HOSTILE_VALUES[rng.bounded(int(sizeof(HOSTILE_VALUES) / 4))]);
+            break;
+        case 3: // 截断
+            data.truncate(rng.bounded(int(data.size())));
+            break;
+        case 4: // 复制一段插到别处
+        {
+            int from = rng.bounded(int(data.size()));
+            int length = rng.bounded(1, qMin<int>(64, int(data.size()) - from) + 1);
+            data.insert(rng.bounded(int(data.size())), data.mid(from, length));
+            break;
+        }
+        default: // 随机字节
+            for (int i = rng.bounded(1, 17); i > 0; --i) {
+                data[rng.bounded(int(data.size()))] = char(rng.bounded(256));
+            }
+            break;
+        }
+    }
+    return data;
+}
+
+struct Outcome {
+    bool headerOk = false;
+    bool damaged = false;
+    int records = 0;
+};
+
+Outcome readInput(FileKind kind, const QByteArray &data)
+{
+    QBuffer buffer;
+    buffer.setData(data);
+    buffer.open(QIODevice::ReadOnly);
+
+    Outcome outcome;
+    QString error;
+    if (kind == CourseFile) {
+        QList<Course*> courses;
+        outcome.headerOk = ScheduleManager::readCourses(&buffer, courses, nullptr, &error);
+        outcome.records = courses.size();
+        qDeleteAll(courses);
+    } else {
+        QList<Task*> tasks;
+        outcome.headerOk = TaskManager::readTasks(&buffer, tasks, nullptr, &error);
+        outcome.records = tasks.size();
+        qDeleteAll(tasks);
+    }
+    outcome.damaged = !error.isEmpty();
+    return outcome;
+}
+
+void saveFailure(const QByteArray &data, FileKind kind, int index, QTextStream &out)
+{
+    QString path = QString("fuzz-failure-%1-%2.dat").arg(kind == CourseFile ? "schedule" : "tasks").arg(index);
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(data);
+        out << "  输入已保存到 " << path << Qt::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("SmartScheduleAssistant-fuzz");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("数据文件读取的模糊测试");
+    parser.addHelpOption();
+    QCommandLineOption iterationsOption("iterations", "变异输入的数量", "n", "20000");
+    QCommandLineOption seedOption("seed", "随机种子", "n", "1");
+    QCommandLineOption rssOption("max-rss-growth", "预热后允许的峰值内存增长（MB）", "mb", "32");
+    QCommandLineOption timeOption("max-ms", "单次读取允许的最长耗时（毫秒）", "ms", "200");
+    QCommandLineOption replayOption("replay", "只读取给定文件（文件名含 tasks 时按任务文件读取）", "file");
+    parser.addOption(iterationsOption);
+    parser.addOption(seedOption);
+    parser.addOption(rssOption);
+    parser.addOption(timeOption);
+    parser.addOption(replayOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    // 损坏输入的警告数量巨大，只看汇总
+    QLoggingCategory::setFilterRules("default.warning=false");
+
+    if (parser.isSet(replayOption)) {
+        QFile file(parser.value(replayOption));
+        if (!file.open(QIODevice::ReadOnly)) {
+            out << "无法打开 " << file.fileName() << Qt::endl;
+            return 2;
+        }
+        FileKind kind = file.fileName().contains("tasks") ? TaskFile : CourseFile;
+        QLoggingCategory::setFilterRules("default.warning=true");
+        Outcome outcome = readInput(kind, file.readAll());
+        out << "文件头" << (outcome.headerOk ? "有效" : "无效") << "，读出 " << outcome.records
+            << " 条记录" << (outcome.damaged ? "（文件已损坏）" : "") << Qt::endl;
+        return 0;
+    }
+
+    const int iterations = parser.value(iterationsOption).toInt();
+    const qint64 maxRssGrowthKb = parser.value(rssOption).toLongLong() * 1024;
+    const qint64 maxNs = parser.value(timeOption).toLongLong() * 1000000;
+    QRandomGenerator rng(parser.value(seedOption).toUInt());
+
+    const QByteArray seeds[2] = { makeCourseSeed(rng), makeTaskSeed(rng) };
+    const qint64 minRecordBytes[2] = { MIN_COURSE_BYTES, MIN_TASK_BYTES };
+
+    // 预热：让分配器和 Qt 内部缓存先达到稳定状态，之后的增长才有意义
+    for (int i = 0; i < 200; ++i) {
+        FileKind kind = FileKind(i % 2);
+        readInput(kind, mutate(seeds[kind], rng));
+    }
+    const qint64 baselineRss = MemoryStats::peakRssKb();
+
+    int failures = 0;
+    int headerRejected = 0;
+    int salvaged = 0;
+    qint64 slowestNs = 0;
+    QElapsedTimer timer;
+
+    for (int i = 0; i < iterations; ++i) {
+        FileKind kind = FileKind(i % 2);
+        QByteArray data = mutate(seeds[kind], rng);
+
+        timer.start();
+        Outcome outcome = readInput(kind, data);
+        qint64 elapsed = timer.nsecsElapsed();
+        slowestNs = qMax(slowestNs, elapsed);
+
+        headerRejected += outcome.headerOk ? 0 : 1;
+        salvaged += outcome.headerOk && outcome.damaged ? 1 : 0;
+
+        // 每条记录至少占 minRecordBytes，读出的数量不可能超过这个上限
+        qint64 maxRecords = data.size() / minRecordBytes[kind];
+        if (outcome.records > maxRecords || elapsed > maxNs) {
+            ++failures;
+            out << "第 " << i << " 个输入异常：读出 " << outcome.records << " 条（上限 " << maxRecords
+                << "），耗时 " << elapsed / 1000000.0 << " ms" << Qt::endl;
+            saveFailure(data, kind, i, out);
+        }
+    }
+
+    const qint64 rssGrowth = MemoryStats::peakRssKb() - baselineRss;
+    out << "输入 " << iterations << " 个：文件头无效 " << headerRejected << "，保留有效前缀 " << salvaged
+        << "，最慢 " << slowestNs / 1000000.0 << " ms" << Qt::endl;
+    out << "预热后峰值内存增长 " << rssGrowth << " KB（允许 " << maxRssGrowthKb << " KB）" << Qt::endl;
+
+    if (baselineRss >= 0 && rssGrowth > maxRssGrowthKb) {
+        out << "峰值内存随输入增长，读取可能按文件中的长度字段分配了内存" << Qt::endl;
+        ++failures;
+    }
+    return failures == 0 ? 0 : 1;
+}
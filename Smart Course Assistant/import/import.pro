@@ -0,0 +1,13 @@
+# 批量导入工具：把教务导出的 CSV 并行转换为每个学生的 schedule.dat / tasks.dat
+TARGET = SmartScheduleAssistant-import
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT += core gui concurrent
+
+include(../SmartScheduleCore.pri)
+
+SOURCES += \
+    main.cpp
@@ -0,0 +1,114 @@
+#include "ProfileImporter.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+// 批量导入工具
+// 用法：SmartScheduleAssistant-import [--jobs N] [--out 目录] 导出目录
+// 导出目录中的每个 *.csv 是一个学生档案，输出到 <out>/<档案名>/
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("YourCompany");
+    app.setApplicationName("SmartScheduleAssistant");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("并行导入教务导出的学生课程与任务");
+    parser.addHelpOption();
+    QCommandLineOption outOption("out", "输出目录（默认当前目录）", "dir", ".");
+    QCommandLineOption jobsOption("jobs", "并行导入的线程数（默认等于 CPU 核数）", "n");
+    QCommandLineOption quietOption("quiet", "不输出逐个档案的进度");
+    parser.addOption(outOption);
+    parser.addOption(jobsOption);
+    parser.addOption(quietOption);
+    parser.addPositionalArgument("exports", "包含 CSV 导出文件的目录");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+
+    QDir exportDir(parser.positionalArguments().first());
+    if (!exportDir.exists()) {
+        err << "导出目录不存在: " << exportDir.path() << Qt::endl;
+        return 2;
+    }
+
+    QString outDir = QDir(parser.value(outOption)).absolutePath();
+    if (!QDir().mkpath(outDir)) {
+        err << "无法创建输出目录: " << outDir << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(jobsOption)) {
+        int jobs = parser.value(jobsOption).toInt();
+        if (jobs > 0) {
+            QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+        }
+    }
+
+    QStringList files;
+    for (const QFileInfo &info : exportDir.entryInfoList(QStringList() << "*.csv", QDir::Files, QDir::Name)) {
+        files << info.absoluteFilePath();
+    }
+    if (files.isEmpty()) {
+        out << "没有找到 CSV 文件" << Qt::endl;
+        return 0;
+    }
+
+    // 每个档案独立解析、校验、写出，互不共享状态
+    QElapsedTimer timer;
+    timer.start();
+    QFuture<ProfileImporter::Result> future = QtConcurrent::mapped(files, [outDir](const QString &file) {
+        return ProfileImporter::importProfile(file, outDir);
+    });
+
+    const bool quiet = parser.isSet(quietOption);
+    const int total = files.size();
+    int done = 0;
+    int failed = 0;
+
+    // 结果按完成顺序逐个报告
+    QFutureWatcher<ProfileImporter::Result> watcher;
+    QObject::connect(&watcher, &QFutureWatcher<ProfileImporter::Result>::resultReadyAt, [&](int index) {
+        ProfileImporter::Result result = watcher.resultAt(index);
+        ++done;
+        if (!result.ok()) {
+            ++failed;
+            err << QString("[%1/%2] %3 导入失败").arg(done).arg(total).arg(result.profile) << Qt::endl;
+            for (const QString &error : std::as_const(result.errors)) {
+                err << "    " << error << Qt::endl;
+            }
+        } else if (!quiet) {
+            out << QString("[%1/%2] %3：%4 门课程，%5 项任务")
+                       .arg(done).arg(total).arg(result.profile)
+                       .arg(result.courseCount).arg(result.taskCount)
+                << Qt::endl;
+        }
+    });
+    QObject::connect(&watcher, &QFutureWatcher<ProfileImporter::Result>::finished, &app, &QCoreApplication::quit);
+    // 即使任务已全部完成，结果通知也会在事件循环中补发
+    watcher.setFuture(future);
+    app.exec();
+
+    qint64 elapsed = qMax<qint64>(1, timer.elapsed());
+    out << QString("共 %1 个档案，成功 %2 个，失败 %3 个，用时 %4 ms（%5 个/秒，线程数 %6）")
+               .arg(total)
+               .arg(total - failed)
+               .arg(failed)
+               .arg(elapsed)
+               .arg(total * 1000.0 / elapsed, 0, 'f', 1)
+               .arg(QThreadPool::globalInstance()->maxThreadCount())
+        << Qt::endl;
+
+    return failed == 0 ? 0 : 1;
+}
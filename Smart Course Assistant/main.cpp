@@ -1,8 +1,12 @@
-#include "mainwindow.h"
+#include "MainWindow.h"
+#include "IconCache.h"
+#include "TraceRecorder.h"
+#include "SingleInstance.h"
 #include <QApplication>
 #include <QLocale>
 #include <QTranslator>
 #include <QMessageBox>
+#include <optional>
 
 int main(int argc, char *argv[])
 {
@@ -12,7 +16,14 @@ int main(int argc, char *argv[])
     // 关键设置：确保程序在窗口关闭后不退出
     a.setQuitOnLastWindowClosed(false);
 
-    QIcon appIcon(":/icons/app_icon");
+    // 单实例：已有实例在运行时把命令行转交给它，不再加载数据、创建托盘和定时器
+    SingleInstance instance(QCoreApplication::applicationName());
+    const QStringList arguments = a.arguments().mid(1);
+    if (!instance.listen()) {
+        return instance.sendArguments(arguments) ? 0 : 1;
+    }
+
+    QIcon appIcon = IconCache::icon("app_icon");
     if (!appIcon.isNull()) {
         a.setWindowIcon(appIcon);
     }
@@ -28,13 +39,27 @@ int main(int argc, char *argv[])
         }
     }
 
-    // 设置应用程序图标
-    a.setWindowIcon(QIcon(":/icons/app_icon"));
+    // 设置 SMARTSCHEDULE_TRACE=<文件路径> 时从启动开始记录，退出时写出跟踪文件
+    const QString tracePath = qEnvironmentVariable("SMARTSCHEDULE_TRACE");
+    if (!tracePath.isEmpty()) {
+        TraceRecorder::setEnabled(true);
+        QObject::connect(&a, &QCoreApplication::aboutToQuit, [tracePath]() {
+            TraceRecorder::dump(tracePath);
+        });
+    }
 
     // 创建并显示主窗口
     try {
+        // 启动区间覆盖主窗口构造和首次显示，进入事件循环前结束
+        std::optional<TraceScope> startupScope(std::in_place, "startup");
         MainWindow w;
         w.show();
+        startupScope.reset();
+        QObject::connect(&instance, &SingleInstance::argumentsReceived,
+                         &w, &MainWindow::handleCommandLine);
+        if (!arguments.isEmpty()) {
+            w.handleCommandLine(arguments);
+        }
         return a.exec();
     } catch (const std::exception& e) {
         QMessageBox::critical(nullptr, "致命错误",
@@ -0,0 +1,157 @@
+#include "ScheduleManager.h"
+#include "TimetableRenderer.h"
+#include <QGuiApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+// 课程表批量导出工具
+// 用法：SmartScheduleAssistant-render [--format png|pdf|both] [--out 目录] [--jobs N] 档案...
+// 每个档案可以是包含 schedule.dat 的目录，也可以直接是课程数据文件
+
+namespace {
+
+struct RenderJob {
+    QString name;        // 输出文件名（不含扩展名），同时作为标题
+    QString scheduleFile;
+};
+
+struct RenderResult {
+    QString name;
+    bool ok = false;
+    QString error;
+};
+
+RenderJob makeJob(const QString &profile)
+{
+    QFileInfo info(profile);
+    RenderJob job;
+    if (info.isDir()) {
+        job.name = QDir(info.absoluteFilePath()).dirName();
+        job.scheduleFile = QDir(info.absoluteFilePath()).filePath("schedule.dat");
+    } else {
+        job.name = info.completeBaseName();
+        job.scheduleFile = info.absoluteFilePath();
+    }
+    return job;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    // 默认使用 offscreen 平台，无需显示服务器
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+    app.setOrganizationName("YourCompany");
+    app.setApplicationName("SmartScheduleAssistant");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("批量导出课程表为 PNG/PDF");
+    parser.addHelpOption();
+    QCommandLineOption formatOption("format", "输出格式：png、pdf 或 both（默认 both）", "format", "both");
+    QCommandLineOption outOption("out", "输出目录（默认当前目录）", "dir", ".");
+    QCommandLineOption jobsOption("jobs", "并行渲染的线程数（默认等于 CPU 核数）", "n");
+    QCommandLineOption sizeOption("size", "图片尺寸，如 1600x1130", "WxH", "1600x1130");
+    parser.addOption(formatOption);
+    parser.addOption(outOption);
+    parser.addOption(jobsOption);
+    parser.addOption(sizeOption);
+    parser.addPositionalArgument("profiles", "档案目录或 schedule.dat 文件", "档案...");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QString format = parser.value(formatOption);
+    const bool png = format == "png" || format == "both";
+    const bool pdf = format == "pdf" || format == "both";
+    if (!png && !pdf) {
+        err << "未知的输出格式: " << format << Qt::endl;
+        return 2;
+    }
+
+    QStringList sizeParts = parser.value(sizeOption).split('x');
+    QSize size(sizeParts.value(0).toInt(), sizeParts.value(1).toInt());
+    if (size.width() < 200 || size.height() < 200) {
+        err << "无效的图片尺寸: " << parser.value(sizeOption) << Qt::endl;
+        return 2;
+    }
+
+    if (parser.positionalArguments().isEmpty()) {
+        parser.showHelp(2);
+    }
+
+    QDir outDir(parser.value(outOption));
+    if (!outDir.exists() && !outDir.mkpath(".")) {
+        err << "无法创建输出目录: " << outDir.path() << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(jobsOption)) {
+        int jobs = parser.value(jobsOption).toInt();
+        if (jobs > 0) {
+            QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+        }
+    }
+
+    QVector<RenderJob> jobs;
+    for (const QString &profile : parser.positionalArguments()) {
+        jobs.append(makeJob(profile));
+    }
+
+    // 布局和字体度量只计算一次，所有任务共享同一个只读渲染器
+    const TimetableRenderer renderer(size);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QList<RenderResult> results = QtConcurrent::blockingMapped<QList<RenderResult>>(
+        jobs, [&renderer, &outDir, png, pdf](const RenderJob &job) {
+            RenderResult result;
+            result.name = job.name;
+
+            // 课程对象没有父对象，由本任务负责释放
+            QList<Course*> courses;
+            if (!ScheduleManager::readCourses(job.scheduleFile, courses)) {
+                result.error = "无法读取 " + job.scheduleFile;
+                return result;
+            }
+
+            result.ok = true;
+            if (png && !renderer.renderPng(outDir.filePath(job.name + ".png"), courses, job.name)) {
+                result.ok = false;
+                result.error = "PNG 写入失败";
+            }
+            if (pdf && !renderer.renderPdf(outDir.filePath(job.name + ".pdf"), courses, job.name)) {
+                result.ok = false;
+                result.error = "PDF 写入失败";
+            }
+            qDeleteAll(courses);
+            return result;
+        });
+
+    int failed = 0;
+    for (const RenderResult &result : results) {
+        if (result.ok) {
+            out << "已导出: " << result.name << Qt::endl;
+        } else {
+            ++failed;
+            err << "导出失败: " << result.name << " (" << result.error << ")" << Qt::endl;
+        }
+    }
+    out << QString("共 %1 个课程表，失败 %2 个，用时 %3 ms，线程数 %4")
+               .arg(results.size())
+               .arg(failed)
+               .arg(timer.elapsed())
+               .arg(QThreadPool::globalInstance()->maxThreadCount())
+        << Qt::endl;
+
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+# 课程表批量导出工具：在 offscreen 平台上把多个课程表并行渲染为 PNG/PDF
+TARGET = SmartScheduleAssistant-render
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT += core gui concurrent
+
+include(../SmartScheduleCore.pri)
+
+SOURCES += \
+    main.cpp \
+    ../TimetableRenderer.cpp
+
+HEADERS += \
+    ../TimetableRenderer.h
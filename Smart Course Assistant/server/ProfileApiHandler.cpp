@@ -0,0 +1,64 @@
+#include "ProfileApiHandler.h"
+#include "ScheduleApiHandler.h"
+#include "MemoryStats.h"
+#include <QJsonObject>
+
+ProfileApiHandler::ProfileApiHandler(const QString &rootDir, qint64 budgetBytes, const QDate &semesterStart)
+    : m_store(rootDir, budgetBytes),
+    m_semesterStart(semesterStart)
+{
+}
+
+ApiResource ProfileApiHandler::resolve(const QString &path, const QUrlQuery &query)
+{
+    if (path == "/stats") {
+        ProfileStore::Stats stats = m_store.stats();
+        MemoryReport report;
+        m_store.reportMemory(report);
+        ApiResource resource;
+        resource.render = [stats, report]() {
+            QJsonObject obj;
+            obj["profiles"] = stats.profiles;
+            obj["bytes"] = stats.bytes;
+            obj["sharedBytes"] = stats.sharedBytes;
+            obj["budgetBytes"] = stats.budgetBytes;
+            obj["loading"] = stats.loading;
+            obj["hits"] = QString::number(stats.hits);
+            obj["loads"] = QString::number(stats.loads);
+            obj["evictions"] = QString::number(stats.evictions);
+            obj["catalogSections"] = stats.catalogSections;
+            obj["catalogVersion"] = QString::number(stats.catalogVersion);
+            obj["internedStrings"] = stats.internedStrings;
+            obj["memory"] = report.toJson();
+            return QJsonDocument(obj);
+        };
+        return resource;
+    }
+
+    const QString prefix = "/students/";
+    if (!path.startsWith(prefix)) {
+        return error(404, "未知的路径: " + path);
+    }
+    const QString rest = path.mid(prefix.size());
+    const int slash = rest.indexOf('/');
+    if (slash <= 0) {
+        return error(404, "缺少查询，例如 /api/students/<ID>/next");
+    }
+
+    const QString studentId = rest.left(slash);
+    QString message;
+    bool loading = false;
+    std::shared_ptr<const ScheduleIndex> index = m_store.index(studentId, &message, &loading);
+    if (loading) {
+        // 数据在后台读取，服务线程继续回答其他用户
+        ApiResource resource = error(503, message);
+        resource.retryAfter = 1;
+        return resource;
+    }
+    if (!index) {
+        return error(ProfileStore::isValidId(studentId) ? 404 : 400, message);
+    }
+    // ETag 带上学生 ID，不同学生的数据版本号可能相同
+    return ScheduleApiHandler::query(index, rest.mid(slash), query, 's' + studentId.toUtf8() + '-',
+                                     m_semesterStart);
+}
@@ -0,0 +1,24 @@
+#ifndef PROFILEAPIHANDLER_H
+#define PROFILEAPIHANDLER_H
+
+#include "ApiServer.h"
+#include "ProfileStore.h"
+
+// 多用户查询接口：/api/students/<学生ID>/<查询> 交给该学生的索引回答，查询与单用户接口相同
+//   GET /api/students/<ID>/next、/now、/today、/due、/tasks、/conflicts、/version
+//   GET /api/stats            已加载用户数、内存预算、命中与卸载次数、课程目录规模
+// 用户数据首次加载较慢时返回 503 和 Retry-After，客户端稍后重试
+class ProfileApiHandler : public ApiHandler
+{
+public:
+    // semesterStart 为全院统一的学期第一周，无效时 now/next/today 不区分单双周
+    ProfileApiHandler(const QString &rootDir, qint64 budgetBytes, const QDate &semesterStart = QDate());
+
+    ApiResource resolve(const QString &path, const QUrlQuery &query) override;
+
+private:
+    ProfileStore m_store;
+    QDate m_semesterStart;
+};
+
+#endif // PROFILEAPIHANDLER_H
@@ -0,0 +1,75 @@
+#include "ApiServer.h"
+#include "ProfileApiHandler.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QTextStream>
+
+// 多用户查询服务：一个进程为整个院系的学生提供查询，不创建界面
+// 用法：SmartScheduleAssistant-server [--port N] [--memory-budget MB] [--semester-start 日期] 数据根目录
+// 数据根目录下每个子目录是一个学生（与 SmartScheduleAssistant-import 的输出相同）
+// 根目录下的 catalog.json 是教务维护的课程目录，修改后无需重启，所有引用该课程的学生随之更新
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setOrganizationName("YourCompany");
+    app.setApplicationName("SmartScheduleAssistant");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("智能课程助手多用户查询服务");
+    parser.addHelpOption();
+    QCommandLineOption portOption("port", "监听 127.0.0.1 的端口（默认 8766）", "n", "8766");
+    QCommandLineOption budgetOption("memory-budget", "已加载用户数据的内存预算，单位 MB（默认 256）", "mb", "256");
+    QCommandLineOption semesterOption("semester-start", "学期第一周的日期 yyyy-MM-dd，用于区分单双周", "date");
+    parser.addOption(portOption);
+    parser.addOption(budgetOption);
+    parser.addOption(semesterOption);
+    parser.addPositionalArgument("root", "数据根目录，每个子目录包含一个学生的 timetable.json（或 schedule.dat）/ tasks.dat");
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    if (parser.positionalArguments().size() != 1) {
+        parser.showHelp(2);
+    }
+    QDir root(parser.positionalArguments().first());
+    if (!root.exists()) {
+        err << "数据根目录不存在: " << root.path() << Qt::endl;
+        return 2;
+    }
+
+    bool portOk = false;
+    bool budgetOk = false;
+    int port = parser.value(portOption).toInt(&portOk);
+    qint64 budgetMb = parser.value(budgetOption).toLongLong(&budgetOk);
+    if (!portOk || port < 0 || port > 65535) {
+        err << "无效的端口: " << parser.value(portOption) << Qt::endl;
+        return 2;
+    }
+    if (!budgetOk || budgetMb <= 0) {
+        err << "无效的内存预算: " << parser.value(budgetOption) << Qt::endl;
+        return 2;
+    }
+    QDate semesterStart;
+    if (parser.isSet(semesterOption)) {
+        semesterStart = QDate::fromString(parser.value(semesterOption), Qt::ISODate);
+        if (!semesterStart.isValid()) {
+            err << "无效的学期开始日期: " << parser.value(semesterOption) << Qt::endl;
+            return 2;
+        }
+    }
+
+    ApiServer server(std::make_unique<ProfileApiHandler>(root.absolutePath(), budgetMb * 1024 * 1024,
+                                                         semesterStart));
+    QString error;
+    if (!server.start(quint16(port), &error)) {
+        err << "无法监听端口 " << port << ": " << error << Qt::endl;
+        return 1;
+    }
+    out << QString("正在提供 %1 下的用户数据：http://127.0.0.1:%2/api/students/<ID>/next")
+               .arg(root.absolutePath()).arg(server.port())
+        << Qt::endl;
+    return app.exec();
+}
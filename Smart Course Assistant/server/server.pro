@@ -0,0 +1,19 @@
+# 多用户查询服务：按需加载多个学生的数据，通过本地查询接口回答，超出内存预算时按 LRU 卸载
+# 运行：./SmartScheduleAssistant-server --memory-budget 256 数据根目录
+TARGET = SmartScheduleAssistant-server
+
+TEMPLATE = app
+CONFIG += console c++17
+CONFIG -= app_bundle
+
+QT += core gui network
+
+include(../SmartScheduleCore.pri)
+include(../SmartScheduleServer.pri)
+
+SOURCES += \
+    main.cpp \
+    ProfileApiHandler.cpp
+
+HEADERS += \
+    ProfileApiHandler.h